@@ -5,7 +5,7 @@
 
 /**
  * Material class
- * Saves a material name and its Young's Modulus in a class
+ * Saves a material name, its Young's Modulus and optionally its allowable stress in a class
  */
 class Material{
 
@@ -21,14 +21,20 @@ private:
      */
     double _E;
 
+    /**
+     * Allowable stress of the Material class instance, 0 if not given
+     */
+    double _allowableStress;
+
 public:
 
     /**
      * Constructor for Material class
      * @param mat String for naming the material, anything can be the name
      * @param E Young's Modulus
+     * @param allowableStress Allowable stress used for the utilization, 0 if not given
      */
-    Material(std::string mat, double E) : _matName(mat), _E(E) {};
+    Material(std::string mat, double E, double allowableStress = 0.0) : _matName(mat), _E(E), _allowableStress(allowableStress) {};
 
     /**
      * Member function to return Young's Modulus
@@ -36,6 +42,12 @@ public:
      */
     double getE() const{return _E;};
 
+    /**
+     * Member function to return the allowable stress
+     * @return Allowable stress, 0 if not given
+     */
+    double getAllowableStress() const{return _allowableStress;};
+
     /**
      * Returns the given material name
      * Mainly used for checking if one has entered same material for more than once
@@ -1,11 +1,41 @@
 #ifndef NODE_H
 #define NODE_H
 
+#include <array>
+#include <cstddef>
 #include <vector>
 
+/**
+ * Structure-of-arrays storage of node coordinates
+ * Owned by a TrussStructure, the coordinates of node ID are stored at index ID - 1
+ */
+struct NodeArrays{
+
+    /**
+     * x-coordinates of all nodes
+     */
+    std::vector<double> x;
+
+    /**
+     * y-coordinates of all nodes
+     */
+    std::vector<double> y;
+
+    /**
+     * z-coordinates of all nodes
+     */
+    std::vector<double> z;
+
+    /**
+     * Counter incremented whenever a node moves, lets the owner detect stale lookup structures
+     */
+    size_t revision = 0;
+};
+
 /**
  * Node class
  * Points in 3D. Elements carry the references of/pointers to node class variables
+ * Nodes of a TrussStructure are views into its NodeArrays, standalone nodes store their own coordinates
  */
 class Node{
 
@@ -31,6 +61,21 @@ private:
      */
     double _z;
 
+    /**
+     * Coordinate storage of the owning structure, nullptr for a standalone node
+     */
+    NodeArrays* _arrays = nullptr;
+
+    /**
+     * Private member functions returning the coordinates from the owning storage
+     */
+    double& x() { return _arrays ? _arrays->x[_id-1] : _x;};
+    double& y() { return _arrays ? _arrays->y[_id-1] : _y;};
+    double& z() { return _arrays ? _arrays->z[_id-1] : _z;};
+    double x() const { return _arrays ? _arrays->x[_id-1] : _x;};
+    double y() const { return _arrays ? _arrays->y[_id-1] : _y;};
+    double z() const { return _arrays ? _arrays->z[_id-1] : _z;};
+
 public:
 
     /**
@@ -42,22 +87,44 @@ public:
      */
     Node(int id, double x, double y, double z): _id(id), _x(x), _y(y), _z(z) {};
 
+    /**
+     * Contructor for a Node class view into structure-of-arrays storage
+     * The coordinates must already be stored at index id - 1
+     * @param id ID of the node, starting from 1
+     * @param arrays Coordinate storage, must outlive the node
+     */
+    Node(int id, NodeArrays& arrays): _id(id), _x(0.0), _y(0.0), _z(0.0), _arrays(&arrays) {};
+
     /**
      * Member function for finding ID of a class Node instance
      * @return int ID of a class Node instance
      */
     int getID() const{ return _id;};
 
+    /**
+     * Member function that changes the ID of a class Node instance
+     * Used when the nodes of a structure are renumbered, the coordinate storage must be permuted accordingly
+     * @param id The new ID, starting from 1
+     */
+    void setID(int id){ _id = id;};
+
     /**
      * Member function for finding node coordinates
+     * Allocates, kernels should use getCoordinates() instead
      * @return {x,y,z} coordinates of a node
      */
     std::vector<double> getPosition() const {
 
-        std::vector<double> pos = {_x,_y,_z};
+        std::vector<double> pos = {x(),y(),z()};
         return pos;
     };
 
+    /**
+     * Member function for finding node coordinates without a heap allocation
+     * @return {x,y,z} coordinates of a node
+     */
+    std::array<double,3> getCoordinates() const { return {x(),y(),z()};};
+
     /**
      * Member function that updates the position of a node
      * Used for shape update, new position must be entered
@@ -67,9 +134,10 @@ public:
      */
     void updatePosition(double newX, double newY, double newZ) {
 
-        _x = newX;
-        _y = newY;
-        _z = newZ;
+        x() = newX;
+        y() = newY;
+        z() = newZ;
+        if (_arrays) ++_arrays->revision;
     };
 
     /**
@@ -81,9 +149,10 @@ public:
      */
     void moveNode(double deltaX, double deltaY, double deltaZ){
 
-        _x += deltaX;
-        _y += deltaY;
-        _z += deltaZ;
+        x() += deltaX;
+        y() += deltaY;
+        z() += deltaZ;
+        if (_arrays) ++_arrays->revision;
     };
 };
 #endif
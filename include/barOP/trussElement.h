@@ -2,10 +2,39 @@
 #define TRUSSELEMENT_H
 
 #include "../math/Matrix.h"
+#include "../math/FixedMatrix.h"
 #include "node.h"
 #include "element.h"
+#include <array>
 #include <vector>
 
+/**
+ * Structure-of-arrays storage of truss element data
+ * Owned by a TrussStructure, the data of element ID is stored at index ID - 1
+ */
+struct ElementArrays{
+
+    /**
+     * 0-based index (ID - 1) of the first node of each element
+     */
+    std::vector<size_t> node1;
+
+    /**
+     * 0-based index (ID - 1) of the second node of each element
+     */
+    std::vector<size_t> node2;
+
+    /**
+     * Cross section area of each element
+     */
+    std::vector<double> area;
+
+    /**
+     * Index of the material of each element in TrussStructure::getMaterials()
+     */
+    std::vector<size_t> material;
+};
+
 /**
  * Derived TrussElement class from base class Element
  * Holds the references to two nodes a truss element has
@@ -27,10 +56,15 @@ private:
      Node& _node2;
 
      /**
-      * Cross section area of a truss element
+      * Cross section area of a standalone truss element
       */
      double _A;
 
+     /**
+      * Element storage of the owning structure, nullptr for a standalone element
+      */
+     ElementArrays* _arrays = nullptr;
+
 public:
 
     /**
@@ -44,6 +78,17 @@ public:
      */
     TrussElement(int id, Node& node1, Node& node2, Material& Mat, double A);
 
+    /**
+     * Constructor for a TrussElement view into structure-of-arrays storage
+     * The element data must already be stored at index id - 1
+     * @param id The ID of the truss element, starting from 1
+     * @param node1 A reference to the first node that a truss element has
+     * @param node2 A reference to the second node that a truss element has
+     * @param Mat Material of the element passes as an instance of Material class
+     * @param arrays Element storage, must outlive the element
+     */
+    TrussElement(int id, Node& node1, Node& node2, Material& Mat, ElementArrays& arrays);
+
     /**
      * Member function to return the reference to the first node
      * @return Node class instance reference
@@ -56,12 +101,31 @@ public:
     */
     Node& getNode2() const;
 
+    /**
+     * Member function to return the cross section area
+     * @return Cross section area of the truss element
+     */
+    double getArea() const;
+
+    /**
+     * Member function to update the cross section area
+     * Used for sizing optimization
+     * @param A New cross section area, must be positive
+     */
+    void setArea(double A);
+
     /**
      * Member function that computes a truss elements length
      * @return Length of a truss element
      */
     double computeLength() const;
 
+    /**
+     * Member function that computes the direction cosines of a truss element
+     * @return Unit vector from the first to the second node
+     */
+    std::array<double,3> computeDirectionCosines() const;
+
     /**
      * Member function that computes the 3D transformation matrix of a truss element
      * Used for transforming element matrices from local coord. to global coord.
@@ -82,6 +146,23 @@ public:
      */
     Matrix<double> computeGlobalStiffnessMtx() const override;
 
+    /**
+     * Member function that computes the truss element stiffness matrix without heap allocation
+     * Closed form EA/L*[cc^T, -cc^T; -cc^T, cc^T] with the direction cosines c, used by the assembly
+     * @return truss element stiffness matrix in global coordinates
+     * @see FixedMatrix
+     */
+    FixedMatrix<double,6,6> computeGlobalStiffnessFixedMtx() const;
+
+    /**
+     * Static member function for the closed form truss element stiffness matrix
+     * Shared by the element and the structure-of-arrays kernels of TrussStructure
+     * @param c Direction cosines of the element
+     * @param axialStiffness EA/L of the element
+     * @return truss element stiffness matrix in global coordinates
+     */
+    static FixedMatrix<double,6,6> computeGlobalStiffnessFixedMtx(const std::array<double,3>& c, double axialStiffness);
+
     /**
      * Member function for computing engineering strains
      * @return Engineering straing of a deformed truss element
@@ -0,0 +1,205 @@
+#ifndef TRUSSSOLVER_H
+#define TRUSSSOLVER_H
+
+#include "trussStructure.h"
+#include <vector>
+
+/**
+ * Reusable sparse Cholesky solver of a truss system
+ * The expensive setup (free dof numbering, sparsity pattern, fill-reducing ordering and
+ * symbolic factorization) is done once in the constructor
+ * Changes in cross section areas, materials or node positions are detected on each solve,
+ * a few changed axial stiffnesses are applied as rank-1 updates/downdates of the factor,
+ * otherwise, or once the factor has received too many of them, the stiffness matrix is refilled
+ * and numerically refactorized
+ * Changes in topology, numbering or boundary conditions require a new solver
+ * @see TrussStructure::createSolver()
+ */
+class TrussSolver{
+
+private:
+
+    /**
+     * Private member variable
+     * Truss system that is solved, must outlive the solver
+     */
+    const TrussStructure& _structure;
+
+    /**
+     * Private member variable
+     * Reduced index of each dof, -1 if fixed
+     */
+    std::vector<long> _freeMap;
+
+    /**
+     * Private member variable
+     * Number of free degrees of freedom
+     */
+    size_t _numFree;
+
+    /**
+     * Private member variable
+     * Global dof of each element (6 per element), used to detect renumbering
+     */
+    std::vector<int> _elementDOFs;
+
+    /**
+     * Private member variable
+     * Position of each element stiffness entry (36 per element) in the values of _K, -1 if fixed
+     */
+    std::vector<long> _scatter;
+
+    /**
+     * Private member variable
+     * Element coloring of the structure, elements of one color are scattered into _K in parallel
+     * @see TrussStructure::createElementColoring()
+     */
+    std::vector<std::vector<size_t>> _colors;
+
+    /**
+     * Private member variable
+     * Direction cosines of each element (3 per element) at the last factorization
+     */
+    std::vector<double> _cosines;
+
+    /**
+     * Private member variable
+     * Axial stiffness EA/L of each element at the last factorization
+     */
+    std::vector<double> _stiffness;
+
+    /**
+     * Private member variable
+     * Reduced master stiffness matrix
+     */
+    SparseMatrix<double> _K;
+
+    /**
+     * Private member variable
+     * Cholesky factorization of _K, its symbolic analysis is kept between refactorizations
+     */
+    SparseCholesky<double> _chol;
+
+    /**
+     * Private member variable
+     * Number of numeric factorizations done so far
+     */
+    size_t _numFactorizations = 0;
+
+    /**
+     * Private member variable
+     * Number of rank-1 factor updates/downdates done so far
+     */
+    size_t _numLowRankUpdates = 0;
+
+    /**
+     * Private member variable
+     * Number of rank-1 factor updates/downdates since the last numeric factorization
+     */
+    size_t _numUpdatesSinceFactorization = 0;
+
+    /**
+     * Private member variable
+     * Largest number of rank-1 updates/downdates applied to a factor before it is recomputed,
+     * bounds the rounding error accumulated by a chain of modifications
+     */
+    size_t _maxLowRankUpdates = 16;
+
+    /**
+     * Private member function
+     * Computes the rank-1 vector of an element in the reduced system, k_e = b*b^T / (EA/L)
+     * @param e Element index
+     * @param scale Factor the vector is multiplied with
+     * @return Reduced vector b*scale, nonzero only at the free dof of the element
+     */
+    std::vector<double> elementVector(size_t e, double scale) const;
+
+    /**
+     * Private member function
+     * Computes the direction cosines and axial stiffnesses of all elements
+     * @param cosines Receives 3 direction cosines per element
+     * @param stiffness Receives EA/L of each element
+     */
+    void computeElementData(std::vector<double>& cosines, std::vector<double>& stiffness) const;
+
+    /**
+     * Private member function
+     * Refills the reduced stiffness matrix from _cosines and _stiffness and refactorizes it
+     */
+    void refactorize();
+
+public:
+
+    /**
+     * Constructor for TrussSolver class
+     * Does the symbolic analysis and the first numeric factorization
+     * @param ts Truss system with boundary conditions
+     * @see TrussStructure
+     */
+    explicit TrussSolver(const TrussStructure& ts);
+
+    /**
+     * Member function that brings the factorization up to date with the truss system
+     * Throws std::runtime_error if the topology, numbering or boundary conditions changed
+     * @return True if a numeric refactorization was needed
+     */
+    bool update();
+
+    /**
+     * Member function that solves the LSE for the forces of the truss system
+     * @return Complete displacement vector
+     */
+    std::vector<double> solve();
+
+    /**
+     * Member function that solves the LSE for a given force vector
+     * @param forceVec Master force vector, entries of fixed dof are ignored
+     * @return Complete displacement vector
+     */
+    std::vector<double> solve(const std::vector<double>& forceVec);
+
+    /**
+     * Member function that solves the LSE as if one element was removed, e.g. member failure
+     * The factor is copied and downdated by the element stiffness, the solver itself is unchanged
+     * Throws std::runtime_error if the structure becomes a mechanism without the element
+     * @param e Element index, starting from 0
+     * @return Complete displacement vector of the damaged structure
+     */
+    std::vector<double> solveWithoutElement(size_t e);
+
+    /**
+     * Member function that solves the LSE for a given force vector as if one element was removed
+     * @param e Element index, starting from 0
+     * @param forceVec Master force vector, entries of fixed dof are ignored
+     * @return Complete displacement vector of the damaged structure
+     */
+    std::vector<double> solveWithoutElement(size_t e, const std::vector<double>& forceVec);
+
+    /**
+     * Member function that sets when low-rank updates are used
+     * Elements that changed only their axial stiffness (area, material or length) are applied as one
+     * rank-1 update/downdate each, as long as the factor has received at most maxUpdates of them since
+     * its last numeric factorization, otherwise the stiffness matrix is refactorized
+     * @param maxUpdates Largest number of rank-1 modifications between factorizations, 0 always refactorizes
+     */
+    void setMaxLowRankUpdates(size_t maxUpdates) {_maxLowRankUpdates = maxUpdates;};
+
+    /**
+     * Member function that returns the number of rank-1 factor updates/downdates
+     * @return Number of low-rank modifications done so far
+     */
+    size_t getNumLowRankUpdates() const {return _numLowRankUpdates;};
+
+    /**
+     * Member function that returns the number of free degrees of freedom
+     * @return Size of the reduced system
+     */
+    size_t getNumFreeDOF() const {return _numFree;};
+
+    /**
+     * Member function that returns the number of numeric factorizations
+     * @return Number of factorizations, including the first one
+     */
+    size_t getNumFactorizations() const {return _numFactorizations;};
+};
+#endif
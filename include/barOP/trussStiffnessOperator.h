@@ -0,0 +1,72 @@
+#ifndef TRUSSSTIFFNESSOPERATOR_H
+#define TRUSSSTIFFNESSOPERATOR_H
+
+#include "trussStructure.h"
+#include <vector>
+
+/**
+ * Matrix-free stiffness operator of a truss system
+ * Computes y = K*x element by element, y = sum_e A_e^T k_e A_e x, without assembling K
+ * Works on the reduced system, i.e. only the free degrees of freedom
+ * Each truss element contributes the rank-1 block (EA/L) * [c; -c] [c; -c]^T
+ * The element data is a snapshot, a new operator must be created after the structure changes
+ */
+class TrussStiffnessOperator{
+
+private:
+
+    /**
+     * Private member variable
+     * Number of free degrees of freedom
+     */
+    size_t _size;
+
+    /**
+     * Private member variable
+     * Reduced dof indices of each element (6 per element), -1 for fixed dof
+     */
+    std::vector<long> _dofs;
+
+    /**
+     * Private member variable
+     * Direction cosines of each element (3 per element)
+     */
+    std::vector<double> _cosines;
+
+    /**
+     * Private member variable
+     * Axial stiffness EA/L of each element
+     */
+    std::vector<double> _stiffness;
+
+public:
+
+    /**
+     * Constructor for TrussStiffnessOperator class
+     * Extracts the direction cosines, axial stiffnesses and free dof of all elements
+     * @param ts Truss system with boundary conditions
+     * @see TrussStructure
+     */
+    explicit TrussStiffnessOperator(const TrussStructure& ts);
+
+    /**
+     * Member function for finding the size of the reduced system
+     * @return A vector containing the sizes in order: {rows, columns}
+     */
+    std::vector<size_t> getSize() const;
+
+    /**
+     * Member function for computing the stiffness matrix vector product
+     * @param x Reduced displacement vector
+     * @return Reduced force vector K*x
+     */
+    std::vector<double> mVm(const std::vector<double>& x) const;
+
+    /**
+     * Member function for computing the diagonal of the reduced stiffness matrix
+     * Used for Jacobi preconditioning without assembly
+     * @return Diagonal entries of K
+     */
+    std::vector<double> getDiagonal() const;
+};
+#endif
@@ -3,11 +3,131 @@
 
 #include "material.h"
 #include "trussElement.h"
+#include "../math/SparseMatrix.h"
+#include "../math/SparseCholesky.h"
+#include "../math/SkylineMatrix.h"
+#include "../math/PackedMatrix.h"
+#include "../math/ConjugateGradient.h"
+#include "../math/IterativeRefinement.h"
 #include "node.h"
+#include <array>
+#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+/**
+ * Linear solvers available for TrussStructure::solveTrussSystem()
+ */
+enum class SolverType{
+
+    /**
+     * Dense reduced stiffness matrix in packed lower storage, tiled Cholesky factorization in place
+     */
+    Dense,
+
+    /**
+     * Sparse master stiffness matrix, sparse Cholesky factorization with a fill-reducing node ordering
+     */
+    Sparse,
+
+    /**
+     * Skyline (profile) master stiffness matrix and Cholesky factorization,
+     * efficient after renumberNodes() for structures with a small bandwidth
+     */
+    Skyline,
+
+    /**
+     * Sparse master stiffness matrix, preconditioned conjugate gradient iterations
+     * Settings are given with TrussStructure::setPCGSettings()
+     */
+    PCG,
+
+    /**
+     * No stiffness matrix at all, conjugate gradient iterations on the element-by-element operator
+     * Uses the PCG settings, SSOR and incomplete Cholesky fall back to Jacobi preconditioning
+     * @see TrussStiffnessOperator
+     */
+    MatrixFree,
+
+    /**
+     * Dense reduced stiffness matrix factorized in single precision, double precision accuracy is
+     * recovered by iterative refinement against the sparse stiffness matrix
+     * Halves the memory and bandwidth of the factorization, intended for well-conditioned structures
+     * Settings are given with TrussStructure::setRefinementSettings()
+     */
+    MixedPrecision
+};
+
+class TrussSolver;
+class TrussStiffnessOperator;
+
+/**
+ * A named set of nodal forces, solved together with the other load cases
+ * @see TrussStructure::addLoadCase()
+ */
+struct LoadCase{
+
+    /**
+     * Name of the load case, e.g. "wind x"
+     */
+    std::string name;
+
+    /**
+     * A map that connects degrees of freedom to forces applied
+     */
+    std::map<int, double> forces;
+};
+
+/**
+ * Element results recovered from a displacement vector
+ * @see TrussStructure::computeElementResults()
+ */
+struct ElementResults{
+
+    /**
+     * Engineering strain of each element
+     */
+    std::vector<double> strains;
+
+    /**
+     * Stress of each element
+     */
+    std::vector<double> stresses;
+
+    /**
+     * Axial force of each element, positive in tension
+     */
+    std::vector<double> axialForces;
+
+    /**
+     * Absolute stress over the allowable stress of the material of each element,
+     * 0 for materials without an allowable stress
+     */
+    std::vector<double> utilizations;
+};
+
+/**
+ * Results of one load case
+ * @see TrussStructure::solveLoadCases()
+ */
+struct LoadCaseResult : ElementResults{
+
+    /**
+     * Name of the load case
+     */
+    std::string name;
+
+    /**
+     * Complete displacement vector
+     */
+    std::vector<double> displacements;
+};
+
 /**
  * Class that handles a truss system
  * Holds unique pointers to truss elements and nodes
@@ -31,9 +151,80 @@ private:
 
     /**
      * Private member variable
-     * A vector that contains materials
+     * Structure-of-arrays node coordinates, the nodes are views into it
+     * Held by pointer, the nodes keep its address
      */
-    std::vector<Material> _materials;
+    std::unique_ptr<NodeArrays> _nodeArrays = std::make_unique<NodeArrays>();
+
+    /**
+     * Private member variable
+     * Structure-of-arrays element connectivity, areas and material indices, the elements are views into it
+     */
+    std::unique_ptr<ElementArrays> _elementArrays = std::make_unique<ElementArrays>();
+
+    /**
+     * Private member variable
+     * Element coloring, kept up to date by addTrussElement() so that assembly does not recompute it
+     * @see createElementColoring()
+     */
+    std::vector<std::vector<size_t>> _elementColors;
+
+    /**
+     * Private member variable
+     * Colors of the elements at each node (0-based), used to color new elements
+     */
+    std::vector<std::vector<size_t>> _nodeColors;
+
+    /**
+     * Private type
+     * Integer coordinates of a cell of the uniform grid used for duplicate node detection
+     */
+    struct NodeCell{
+        long long i, j, k;
+        bool operator==(const NodeCell& other) const {return i == other.i && j == other.j && k == other.k;};
+    };
+
+    /**
+     * Private type
+     * Hash of a NodeCell
+     */
+    struct NodeCellHash{
+        size_t operator()(const NodeCell& c) const {
+            return static_cast<size_t>(static_cast<unsigned long long>(c.i)*73856093ULL ^
+                                       static_cast<unsigned long long>(c.j)*19349663ULL ^
+                                       static_cast<unsigned long long>(c.k)*83492791ULL);
+        };
+    };
+
+    /**
+     * Private member variable
+     * Two nodes closer than this in every coordinate direction are considered duplicates
+     */
+    double _nodeTolerance = 1E-1;
+
+    /**
+     * Private member variable
+     * Spatial hash of the nodes, maps a grid cell of size _nodeTolerance to the first node index in it
+     */
+    std::unordered_map<NodeCell, size_t, NodeCellHash> _nodeGridHead;
+
+    /**
+     * Private member variable
+     * Next node index in the same grid cell, chained from _nodeGridHead
+     */
+    std::vector<size_t> _nodeGridNext;
+
+    /**
+     * Private member variable
+     * NodeArrays::revision the spatial hash was built for, moved nodes trigger a rebuild
+     */
+    size_t _nodeGridRevision = 0;
+
+    /**
+     * Private member variable
+     * A deque that contains materials, adding materials keeps references held by elements valid
+     */
+    std::deque<Material> _materials;
 
     /**
      * Private member variable
@@ -47,6 +238,145 @@ private:
      */
     std::map<int, double> _forces;
 
+    /**
+     * Private member variable
+     * Additional load cases, solved with one factorization by solveLoadCases()
+     */
+    std::vector<LoadCase> _loadCases;
+
+    /**
+     * Private member variable
+     * Linear solver used by solveTrussSystem()
+     */
+    SolverType _solverType = SolverType::Sparse;
+
+    /**
+     * Private member variable
+     * Preconditioner used by the PCG solver
+     */
+    PreconditionerType _pcgPreconditioner = PreconditionerType::IncompleteCholesky;
+
+    /**
+     * Private member variable
+     * Relative residual tolerance of the PCG solver
+     */
+    double _pcgTolerance = 1E-10;
+
+    /**
+     * Private member variable
+     * Iteration cap of the PCG solver
+     */
+    size_t _pcgMaxIterations = 10000;
+
+    /**
+     * Private member variable
+     * Relaxation factor of the SSOR preconditioner
+     */
+    double _ssorOmega = 1.2;
+
+    /**
+     * Private member variable
+     * Normwise backward error tolerance of the mixed precision solver, a few double eps
+     */
+    double _refinementTolerance = 1E-15;
+
+    /**
+     * Private member variable
+     * Cap on the refinement steps of the mixed precision solver
+     */
+    size_t _refinementMaxIterations = 10;
+
+    /**
+     * Private member function that runs f(e) for every element index e
+     * Elements of one color of createElementColoring() run in parallel, they never share a node,
+     * so scattering into the rows of their nodes needs no locks
+     * @param f Element function
+     */
+    void forEachElementColored(const std::function<void(size_t)>& f) const;
+
+    /**
+     * Private member function that computes the global stiffness matrix of an element from the structure-of-arrays storage
+     * @param e Element index, starting from 0
+     * @return Element stiffness matrix in global coordinates
+     */
+    FixedMatrix<double,6,6> computeElementStiffness(size_t e) const;
+
+    /**
+     * Private member function that fills the reduced system in packed lower storage
+     * Element matrices are computed in double and rounded to T when they are added
+     * @param globStffMtx Packed matrix of size free dof, must be zero
+     * @param freeMap Free dof numbering from createFreeDOFMap()
+     */
+    template<typename T>
+    void fillReducedPackedStffMtx(PackedMatrix<T>& globStffMtx, const std::vector<long>& freeMap) const;
+
+    /**
+     * Private member function that prepares the mixed precision solver
+     * The O(n^3) factorization runs in float, the refinement residual uses the exact double stiffness matrix
+     * @return Float Cholesky factor of the reduced system and the reduced sparse master stiffness matrix
+     */
+    std::pair<PackedMatrix<float>, SparseMatrix<double>> factorizeMixedPrecision() const;
+
+    /**
+     * Private member function that builds the preconditioner selected by setPCGSettings() and calls f(M) with it
+     * Solving several right hand sides inside f reuses the preconditioner
+     * @param K Reduced sparse master stiffness matrix
+     * @param f Function taking the preconditioner
+     */
+    template<typename F>
+    void withPCGPreconditioner(const SparseMatrix<double>& K, F&& f) const;
+
+    /**
+     * Private member function that builds the preconditioner of the matrix-free solver and calls f(M) with it
+     * Identity for PreconditionerType::None, Jacobi on the operator diagonal otherwise
+     * @param K Matrix-free stiffness operator
+     * @param f Function taking the preconditioner
+     */
+    template<typename F>
+    void withPCGPreconditioner(const TrussStiffnessOperator& K, F&& f) const;
+
+    /**
+     * Private member function that recovers the element results of several displacement vectors in one sweep
+     * Blocks of elements run in parallel, the geometry and material data of a block are computed once
+     * and reused for every displacement vector
+     * @param u Complete displacement vectors
+     * @param results Results of each displacement vector, members sized to the number of elements are
+     *                written, empty members are skipped
+     */
+    void recoverElementResults(const std::vector<const std::vector<double>*>& u, const std::vector<ElementResults*>& results) const;
+
+    /**
+     * Private member function that returns the grid cell of a point
+     * @param x x-coordinate
+     * @param y y-coordinate
+     * @param z z-coordinate
+     * @return Cell of size _nodeTolerance containing the point
+     */
+    NodeCell nodeCellOf(double x, double y, double z) const;
+
+    /**
+     * Private member function that rebuilds the spatial hash if nodes moved or were renumbered
+     */
+    void updateNodeGrid();
+
+    /**
+     * Private member function that searches the spatial hash for a node within the tolerance of a point
+     * Only the 27 cells around the point are visited
+     * @param x x-coordinate
+     * @param y y-coordinate
+     * @param z z-coordinate
+     * @return Smallest index of a duplicate node, or the number of nodes if there is none
+     */
+    size_t findNodeIndex(double x, double y, double z) const;
+
+    /**
+     * Private member function that stores a node in the arrays and the spatial hash without the duplicate check
+     * @param x x-coordinate
+     * @param y y-coordinate
+     * @param z z-coordinate
+     * @return Reference to the new node
+     */
+    Node& appendNode(double x, double y, double z);
 
 public:
 
@@ -63,6 +393,8 @@ public:
     /**
      * Member function that adds a node to a TrussStructure instance
      * Node ids are generated inside the function, no manual ids are passed
+     * Duplicates are found with a spatial hash in amortized constant time,
+     * std::invalid_argument is thrown if a node lies within the node tolerance
      * @param x x-coordinate of the added node
      * @param y y-coordinate of the added node
      * @param z z-coordinate of the added node
@@ -71,19 +403,43 @@ public:
      */
     Node& addNode(double x, double y, double z);
 
+    /**
+     * Member function that adds many nodes at once, e.g. from a mesh generator
+     * Points within the node tolerance of an existing node or of an earlier point are merged instead of throwing,
+     * the result is the same as adding the points one by one in the given order and skipping duplicates
+     * The neighbour searches run in parallel
+     * @param coordinates {x,y,z} coordinates of the points
+     * @return ID of the node at each point, either new or existing
+     */
+    std::vector<int> addNodes(const std::vector<std::array<double,3>>& coordinates);
+
+    /**
+     * Member function that sets the tolerance of the duplicate node check
+     * @param tolerance Nodes closer than this in every coordinate direction are duplicates, must be positive
+     */
+    void setNodeTolerance(double tolerance);
+
+    /**
+     * Member function that returns the tolerance of the duplicate node check
+     * @return Node tolerance
+     */
+    double getNodeTolerance() const {return _nodeTolerance;};
+
     /**
      * Member function that creates a new material
      * Passes the name of the material and its Young's modulus
      * @param matName The name of the material, can be anything
      * @param E Young's modulus of the material
+     * @param allowableStress Allowable stress used for the utilization, 0 if not given
      * @return Reference to a Material instance
      * @see Material
      */
-    Material& addMaterial(std::string matName, double E);
+    Material& addMaterial(std::string matName, double E, double allowableStress = 0.0);
 
     /**
      * Member function that adds an element to an existing TrussStructure instance
      * Automatically gives ids to the elements, no manual argument passing
+     * Nodes and material must belong to this structure, std::invalid_argument is thrown otherwise
      * @param n1 Reference to the first node a truss has
      * @param n2 Reference to the second node a truss has
      * @param mat Material class instance that the truss is made out of
@@ -109,6 +465,21 @@ public:
      */
     void addForces(std::vector<int> dof, std::vector<double> forces);
 
+    /**
+     * Member function that adds a load case
+     * Independent of the forces given with addForces(), see solveLoadCases()
+     * @param name Name of the load case
+     * @param dof Vector that contains degree of freedom - must be same size with forces
+     * @param forces Vector that constains forces applied to those degree of freedom - must be same size with dof
+     * @return Index of the load case
+     */
+    size_t addLoadCase(std::string name, std::vector<int> dof, std::vector<double> forces);
+
+    /**
+     * Member function that removes all load cases
+     */
+    void clearLoadCases();
+
     /**
      * Member function that returns nodes of a truss system
      * @return A vector of pointers to the nodes of a truss system
@@ -125,10 +496,50 @@ public:
 
     /**
      * Member function that returns materials of a truss system
-     * @return A vector of the materials of a truss system
+     * @return A deque of the materials of a truss system
      * @see Material
      */
-    const std::vector<Material>& getMaterials() const;
+    const std::deque<Material>& getMaterials() const;
+
+    /**
+     * Member function that returns the structure-of-arrays node coordinates
+     * Coordinates of node ID are stored at index ID - 1
+     * @return Node coordinate arrays
+     * @see NodeArrays
+     */
+    const NodeArrays& getNodeArrays() const {return *_nodeArrays;};
+
+    /**
+     * Member function that returns the structure-of-arrays element data
+     * Data of element ID are stored at index ID - 1
+     * @return Element connectivity, area and material index arrays
+     * @see ElementArrays
+     */
+    const ElementArrays& getElementArrays() const {return *_elementArrays;};
+
+    /**
+     * Member function that computes the length and direction cosines of an element
+     * Reads the structure-of-arrays storage directly
+     * @param e Element index, starting from 0
+     * @param c Receives the unit vector from the first to the second node
+     * @return Length of the element
+     */
+    double computeElementDirection(size_t e, std::array<double,3>& c) const;
+
+    /**
+     * Member function that computes the axial stiffness of an element
+     * @param e Element index, starting from 0
+     * @param L Length of the element
+     * @return EA/L of the element
+     */
+    double computeAxialStiffness(size_t e, double L) const;
+
+    /**
+     * Member function that returns the degrees of freedom of an element from the structure-of-arrays storage
+     * @param e Element index, starting from 0
+     * @return Degrees of freedom (u1,v1,w1,u2,v2,w2), starting from 1
+     */
+    std::array<int,6> getElementDOFs(size_t e) const;
 
     /**
      * Member function that returns boundary condition map of a truss system
@@ -142,6 +553,63 @@ public:
      */
     const std::map<int, double>& getForces() const;
 
+    /**
+     * Member function that returns the load cases of a truss system
+     * @return A vector of the load cases
+     * @see LoadCase
+     */
+    const std::vector<LoadCase>& getLoadCases() const;
+
+    /**
+     * Member function that selects the linear solver used by solveTrussSystem()
+     * @param type Solver type
+     */
+    void setSolverType(SolverType type);
+
+    /**
+     * Member function that returns the linear solver used by solveTrussSystem()
+     * @return Solver type
+     */
+    SolverType getSolverType() const;
+
+    /**
+     * Member function that sets the options of the PCG solver
+     * @param preconditioner Preconditioner type
+     * @param tolerance Relative residual at which the iterations stop
+     * @param maxIterations Iteration cap
+     * @param ssorOmega Relaxation factor of the SSOR preconditioner, 0 < ssorOmega < 2
+     */
+    void setPCGSettings(PreconditionerType preconditioner, double tolerance, size_t maxIterations, double ssorOmega = 1.2);
+
+    /**
+     * Member function that sets the options of the mixed precision solver
+     * @param tolerance Normwise backward error ||r|| / (||K||*||u|| + ||F||) at which the refinement stops
+     * @param maxIterations Cap on the refinement steps
+     */
+    void setRefinementSettings(double tolerance, size_t maxIterations);
+
+    /**
+     * Member function that renumbers the nodes with the reverse Cuthill-McKee algorithm
+     * Reduces the bandwidth of the master stiffness matrix, node references stay valid
+     * Node IDs, boundary conditions and forces are updated to the new numbering
+     * @return New ID of each node, indexed by old ID - 1
+     */
+    std::vector<int> renumberNodes();
+
+    /**
+     * Member function that returns the node connectivity graph of a truss system
+     * @return For each node (0-based), the 0-based indices of the nodes it shares an element with
+     */
+    std::vector<std::vector<size_t>> createNodeGraph() const;
+
+    /**
+     * Member function that groups the elements into colors
+     * No two elements of the same color share a node (greedy first fit in element order)
+     * The coloring is maintained as elements are added, this returns a copy of it
+     * @return Element indices (0-based) of each color, ascending within a color
+     */
+    std::vector<std::vector<size_t>> createElementColoring() const;
+
     /**
      * Member function that assembles the stiffness matrices
      * The individual element matrices are computed inside, thus no input arguments
@@ -150,9 +618,68 @@ public:
      */
     Matrix<double> assembleStffMtx() const;
 
+    /**
+     * Member function that computes the sparsity pattern of the master stiffness matrix
+     * Symbolic phase only, the pattern follows from the element degrees of freedom
+     * @return Master stiffness matrix in CSR format with all values zero
+     * @see SparseMatrix
+     */
+    SparseMatrix<double> createSparsityPattern() const;
+
+    /**
+     * Member function that fills a sparse master stiffness matrix
+     * Numeric phase only, the pattern must come from createSparsityPattern()
+     * @param globStffMtx Sparse master stiffness matrix, overwritten
+     * @see SparseMatrix
+     */
+    void fillSparseStffMtx(SparseMatrix<double>& globStffMtx) const;
+
+    /**
+     * Member function that assembles the stiffness matrices in sparse format
+     * Memory scales with the number of elements instead of the number of dof squared
+     * @return Master stiffness matrix in CSR format
+     * @see SparseMatrix
+     */
+    SparseMatrix<double> assembleSparseStffMtx() const;
+
+    /**
+     * Member function that assembles the stiffness matrices in sparse format and keeps only the free rows and columns
+     * @return Reduced master stiffness matrix in CSR format
+     * @see SparseMatrix
+     */
+    SparseMatrix<double> assembleReducedSparseStffMtx() const;
+
+    /**
+     * Member function that numbers the free degrees of freedom
+     * @return For each dof (0-based), its index in the reduced system, -1 if fixed
+     */
+    std::vector<long> createFreeDOFMap() const;
+
+    /**
+     * Member function that assembles the stiffness matrices directly into the reduced system
+     * Entries of fixed degrees of freedom are skipped, no full size matrix is created
+     * @return Reduced master stiffness matrix
+     * @see Matrix
+     */
+    Matrix<double> assembleReducedStffMtx() const;
+
+    /**
+     * Member function that assembles the reduced system into packed lower storage
+     * Same matrix as assembleReducedStffMtx() with about half the memory, used by the dense solver
+     * @return Reduced master stiffness matrix, lower triangle
+     * @see PackedMatrix
+     */
+    PackedMatrix<double> assembleReducedPackedStffMtx() const;
+
+    /**
+     * Member function for computing the reduced force vector
+     * @return Master force vector without the fixed degrees of freedom
+     */
+    std::vector<double> createReducedForceVector() const;
+
     /**
      * Member function that handles homogeneous boundary conditions
-     * Deletes the rows and columns of master stiffness matrix
+     * Deletes the rows and columns of master stiffness matrix in a single pass
      * Deletes the rows of master force vector
      * @param globStffMtx Master stiffness matrix
      * @param forceVec Master force vector
@@ -160,20 +687,92 @@ public:
      */
     void applyHomBCs(Matrix<double>& globStffMtx, std::vector<double>& forceVec) const;
 
+    /**
+     * Member function that handles homogeneous boundary conditions in sparse format
+     * Extracts the free rows and columns of master stiffness matrix in a single pass
+     * Deletes the rows of master force vector
+     * @param globStffMtx Sparse master stiffness matrix
+     * @param forceVec Master force vector
+     * @see SparseMatrix
+     */
+    void applyHomBCs(SparseMatrix<double>& globStffMtx, std::vector<double>& forceVec) const;
+
+    /**
+     * Member function that computes a fill-reducing ordering of the reduced system
+     * Fill-reducing ordering of the node graph, expanded to the free degrees of freedom.
+     * Nested dissection, approximate minimum degree and reverse Cuthill-McKee orderings are
+     * compared by the predicted nonzeros of the node level factor and the sparsest one is kept
+     * @return Permutation of the reduced dof, perm[k] is the reduced dof eliminated k-th
+     */
+    std::vector<size_t> computeFillReducingOrdering() const;
+
     /**
      * Member function for computing master force vector
      * @return Master force vector
      */
     std::vector<double> createForceVector() const;
 
+    /**
+     * Member function for computing the reduced force matrix of all load cases
+     * @return Matrix of size free dof x number of load cases, one load case per column
+     */
+    Matrix<double> createReducedForceMatrix() const;
+
     /**
      * Member function that solves the LSE
-     * Uses complete Cholesky algoritm to solve the system
+     * Uses complete Cholesky algoritm and forward/backward substitution to solve the system
+     * Dense or sparse depending on the selected SolverType
      * @return Reduced complete displacement vector
      * @see Matrix
      */
     std::vector<double> solveTrussSystem() const;
 
+    /**
+     * Member function that creates a reusable sparse Cholesky solver
+     * The symbolic analysis is cached, later changes in areas or node positions only refactorize
+     * Include trussSolver.h to use the returned object
+     * @return Solver handle, valid as long as the truss system exists
+     * @see TrussSolver
+     */
+    TrussSolver createSolver() const;
+
+    /**
+     * Member function that solves the LSE iteratively
+     * Uses preconditioned conjugate gradients on the sparse reduced system, see setPCGSettings()
+     * @param report Receives iteration count, convergence flag and residual history
+     * @return Complete displacement vector
+     * @see CGReport
+     */
+    std::vector<double> solveTrussSystemPCG(CGReport<double>& report) const;
+
+    /**
+     * Member function that solves the LSE without assembling the stiffness matrix
+     * Conjugate gradients on the matrix-free TrussStiffnessOperator, see setPCGSettings()
+     * @param report Receives iteration count, convergence flag and residual history
+     * @return Complete displacement vector
+     * @see TrussStiffnessOperator
+     */
+    std::vector<double> solveTrussSystemMatrixFree(CGReport<double>& report) const;
+
+    /**
+     * Member function that solves the LSE with a single precision factorization
+     * Cholesky factorization in float, iterative refinement of the residual in double, see setRefinementSettings()
+     * @param report Receives refinement steps, convergence flag and the achieved backward errors
+     * @return Complete displacement vector
+     * @see RefinementReport
+     */
+    std::vector<double> solveTrussSystemMixedPrecision(RefinementReport<double>& report) const;
+
+    /**
+     * Member function that solves all load cases
+     * Direct solvers assemble and factorize once and solve all right hand sides together,
+     * MixedPrecision factorizes once and refines each load case separately,
+     * PCG and MatrixFree solve each load case separately
+     * @return Displacements and element results of each load case, in the order they were added
+     * @see LoadCaseResult
+     */
+    std::vector<LoadCaseResult> solveLoadCases() const;
+
     /**
      * Member function that computes complete displacement vector
      * Adds zeros to the places where dof are fixed
@@ -185,6 +784,7 @@ public:
     /**
      * Member function that computes the engineering strains
      * Uses complete displacement vector to compute engineering strains of each truss element
+     * Use computeElementResults() when more than one element quantity is needed
      * @param u Complete displacement solution
      * @return Engineering strains
      */
@@ -193,9 +793,19 @@ public:
     /**
      * Member function that computes the element stresses
      * Uses complete displacement vector
+     * Use computeElementResults() when more than one element quantity is needed
      * @param u Complete displacement vector solution
      * @return Stresses in each truss element
      */
     std::vector<double> computeStresses(std::vector<double>& u) const;
+
+    /**
+     * Member function that computes strain, stress, axial force and utilization of each element
+     * Single parallel pass over the elements
+     * @param u Complete displacement vector solution
+     * @return Element results
+     * @see ElementResults
+     */
+    ElementResults computeElementResults(const std::vector<double>& u) const;
 };
 #endif
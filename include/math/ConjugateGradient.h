@@ -0,0 +1,490 @@
+#ifndef CONJUGATEGRADIENT_H
+#define CONJUGATEGRADIENT_H
+
+#include "SparseMatrix.h"
+#include "VectorKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Preconditioners available for the conjugate gradient solver
+ */
+enum class PreconditionerType{
+
+    /**
+     * No preconditioning, plain conjugate gradient
+     */
+    None,
+
+    /**
+     * Diagonal scaling
+     */
+    Jacobi,
+
+    /**
+     * Symmetric successive over-relaxation
+     */
+    SSOR,
+
+    /**
+     * Incomplete Cholesky factorization without fill-in, IC(0)
+     */
+    IncompleteCholesky
+};
+
+/**
+ * Convergence report of a conjugate gradient solve.
+ */
+template<typename T>
+struct CGReport{
+
+    /**
+     * Number of iterations performed
+     */
+    size_t iterations = 0;
+
+    /**
+     * True if the relative residual dropped below the tolerance
+     */
+    bool converged = false;
+
+    /**
+     * Relative residual norm ||b - A*x|| / ||b|| before the first and after each iteration
+     */
+    std::vector<T> residualHistory;
+};
+
+/**
+ * Templated class IdentityPreconditioner.
+ * Returns the residual unchanged.
+ */
+template<typename T>
+class IdentityPreconditioner{
+
+    public:
+
+        /**
+        * Member function applying the preconditioner.
+        * @param r Residual vector
+        * @return r
+        */
+        std::vector<T> apply(const std::vector<T>& r) const {return r;};
+};
+
+/**
+ * Templated class JacobiPreconditioner.
+ * Diagonal preconditioner M = diag(A).
+ */
+template<typename T>
+class JacobiPreconditioner{
+
+    private:
+
+        /**
+         * Private member variable.
+         * Inverse of the diagonal of A
+         */
+        std::vector<T> _invDiag;
+
+    public:
+
+        /**
+        * JacobiPreconditioner class constructor.
+        * @param A Symmetric positive definite matrix
+        */
+        explicit JacobiPreconditioner(const SparseMatrix<T>& A);
+
+        /**
+        * JacobiPreconditioner class constructor.
+        * Used with matrix-free operators that only provide their diagonal.
+        * @param diagonal Diagonal entries of A, all positive
+        */
+        explicit JacobiPreconditioner(const std::vector<T>& diagonal);
+
+        /**
+        * Member function applying the preconditioner.
+        * @param r Residual vector
+        * @return M^-1 * r
+        */
+        std::vector<T> apply(const std::vector<T>& r) const;
+};
+
+/**
+ * Templated class SSORPreconditioner.
+ * Symmetric successive over-relaxation preconditioner
+ * M = w/(2-w) * (D/w + L) * (D/w)^-1 * (D/w + L^T), with A = L + D + L^T.
+ */
+template<typename T>
+class SSORPreconditioner{
+
+    private:
+
+        /**
+         * Private member variable.
+         * Matrix the preconditioner is built from
+         */
+        const SparseMatrix<T>& _A;
+
+        /**
+         * Private member variable.
+         * Diagonal of A
+         */
+        std::vector<T> _diag;
+
+        /**
+         * Private member variable.
+         * Relaxation factor, 0 < omega < 2
+         */
+        T _omega;
+
+    public:
+
+        /**
+        * SSORPreconditioner class constructor.
+        * The matrix is referenced, not copied, and must outlive the preconditioner.
+        * @param A Symmetric positive definite matrix
+        * @param omega Relaxation factor, 0 < omega < 2
+        */
+        SSORPreconditioner(const SparseMatrix<T>& A, T omega);
+
+        /**
+        * Member function applying the preconditioner.
+        * @param r Residual vector
+        * @return M^-1 * r
+        */
+        std::vector<T> apply(const std::vector<T>& r) const;
+};
+
+/**
+ * Templated class IncompleteCholeskyPreconditioner.
+ * IC(0) preconditioner M = L*L^T, where L has the pattern of the lower triangle of A.
+ * If the factorization breaks down, the diagonal of A is shifted until it succeeds.
+ */
+template<typename T>
+class IncompleteCholeskyPreconditioner{
+
+    private:
+
+        /**
+         * Private member variable.
+         * Row pointers of L
+         */
+        std::vector<size_t> _rowPtr;
+
+        /**
+         * Private member variable.
+         * Column indices of L, sorted, the diagonal is the last entry of each row
+         */
+        std::vector<size_t> _colIdx;
+
+        /**
+         * Private member variable.
+         * Values of L
+         */
+        std::vector<T> _values;
+
+        /**
+         * Private member variable.
+         * Relative diagonal shift that was needed, zero if none
+         */
+        T _shift;
+
+        /**
+         * Private member function.
+         * Attempts the IC(0) factorization with a relative diagonal shift.
+         * @param A Matrix to be factorized
+         * @param shift Diagonal entries are multiplied with (1 + shift)
+         * @return False on breakdown (non-positive pivot)
+         */
+        bool factorize(const SparseMatrix<T>& A, T shift);
+
+    public:
+
+        /**
+        * IncompleteCholeskyPreconditioner class constructor.
+        * @param A Symmetric positive definite matrix, both triangles stored
+        */
+        explicit IncompleteCholeskyPreconditioner(const SparseMatrix<T>& A);
+
+        /**
+        * Member function for finding the diagonal shift used.
+        * @return Relative diagonal shift, zero if the plain factorization succeeded
+        */
+        T getShift() const {return _shift;};
+
+        /**
+        * Member function applying the preconditioner.
+        * @param r Residual vector
+        * @return (L*L^T)^-1 * r
+        */
+        std::vector<T> apply(const std::vector<T>& r) const;
+};
+
+/**
+ * Function for solving A*x = b with the preconditioned conjugate gradient method.
+ * A can be any symmetric positive definite operator providing mVm(), e.g. Matrix or SparseMatrix,
+ * M any preconditioner providing apply().
+ * @param A Operator of the linear system
+ * @param b Right hand side vector
+ * @param M Preconditioner
+ * @param tolerance Relative residual ||b - A*x|| / ||b|| at which the iteration stops
+ * @param maxIterations Iteration cap
+ * @param report Receives iteration count, convergence flag and residual history
+ * @return Approximate solution x
+ */
+template<typename T, typename Operator, typename Preconditioner>
+std::vector<T> conjugateGradient(const Operator& A, const std::vector<T>& b, const Preconditioner& M,
+                                 T tolerance, size_t maxIterations, CGReport<T>& report);
+
+// TEMPLATE DEFINITIONS, ONLY-HEADER FILE IMPLEMENTATION!
+
+template<typename T>
+JacobiPreconditioner<T>::JacobiPreconditioner(const SparseMatrix<T>& A) : _invDiag(A.getSize()[0]){
+
+    const SparseMatrix<T>& C = A;
+    for (size_t i = 0; i < _invDiag.size(); ++i){
+        T d = C(i,i);
+        if (!(d > T{0})){
+            throw std::invalid_argument("Non-positive diagonal entry! (JacobiPreconditioner)");
+        };
+        _invDiag[i] = T{1}/d;
+    };
+};
+
+template<typename T>
+JacobiPreconditioner<T>::JacobiPreconditioner(const std::vector<T>& diagonal) : _invDiag(diagonal.size()){
+
+    for (size_t i = 0; i < _invDiag.size(); ++i){
+        if (!(diagonal[i] > T{0})){
+            throw std::invalid_argument("Non-positive diagonal entry! (JacobiPreconditioner)");
+        };
+        _invDiag[i] = T{1}/diagonal[i];
+    };
+};
+
+template<typename T>
+std::vector<T> JacobiPreconditioner<T>::apply(const std::vector<T>& r) const{
+
+    std::vector<T> z(r.size());
+    for (size_t i = 0; i < r.size(); ++i){
+        z[i] = _invDiag[i]*r[i];
+    };
+    return z;
+};
+
+template<typename T>
+SSORPreconditioner<T>::SSORPreconditioner(const SparseMatrix<T>& A, T omega)
+    : _A(A), _diag(A.getSize()[0]), _omega(omega)
+{
+    if (!(omega > T{0} && omega < T{2})){
+        throw std::invalid_argument("Relaxation factor must be in (0,2)! (SSORPreconditioner)");
+    };
+
+    for (size_t i = 0; i < _diag.size(); ++i){
+        _diag[i] = A(i,i);
+        if (!(_diag[i] > T{0})){
+            throw std::invalid_argument("Non-positive diagonal entry! (SSORPreconditioner)");
+        };
+    };
+};
+
+template<typename T>
+std::vector<T> SSORPreconditioner<T>::apply(const std::vector<T>& r) const{
+
+    const std::vector<size_t>& rowPtr = _A.getRowPtr();
+    const std::vector<size_t>& colIdx = _A.getColIdx();
+    const std::vector<T>& values = _A.getValues();
+    size_t n = _diag.size();
+
+    // (D/w + L) * y = r
+    std::vector<T> z(n);
+    for (size_t i = 0; i < n; ++i){
+        T sum = r[i];
+        for (size_t p = rowPtr[i]; p < rowPtr[i+1] && colIdx[p] < i; ++p){
+            sum -= values[p]*z[colIdx[p]];
+        };
+        z[i] = sum*_omega/_diag[i];
+    };
+
+    // (D/w + L^T) * z = (2-w)/w * D * y
+    for (size_t i = 0; i < n; ++i){
+        z[i] *= (T{2} - _omega)/_omega*_diag[i];
+    };
+    for (size_t i = n; i-- > 0;){
+        T sum = z[i];
+        for (size_t p = rowPtr[i+1]; p-- > rowPtr[i] && colIdx[p] > i;){
+            sum -= values[p]*z[colIdx[p]];
+        };
+        z[i] = sum*_omega/_diag[i];
+    };
+
+    return z;
+};
+
+template<typename T>
+IncompleteCholeskyPreconditioner<T>::IncompleteCholeskyPreconditioner(const SparseMatrix<T>& A) : _shift(0){
+
+    if (A.getSize()[0] != A.getSize()[1]){
+        throw std::invalid_argument("Given matrix is not square! (IncompleteCholeskyPreconditioner)");
+    };
+
+    T shift{0};
+    while (!factorize(A, shift)){
+        shift = (shift == T{0}) ? T(1e-3) : T{2}*shift;
+        if (shift > T{1}){
+            throw std::runtime_error("Incomplete Cholesky factorization failed! (IncompleteCholeskyPreconditioner)");
+        };
+    };
+    _shift = shift;
+};
+
+template<typename T>
+bool IncompleteCholeskyPreconditioner<T>::factorize(const SparseMatrix<T>& A, T shift){
+
+    const std::vector<size_t>& rowPtr = A.getRowPtr();
+    const std::vector<size_t>& colIdx = A.getColIdx();
+    const std::vector<T>& values = A.getValues();
+    size_t n = A.getSize()[0];
+
+    // copy the lower triangle including the diagonal
+    _rowPtr.assign(n+1, 0);
+    _colIdx.clear();
+    _values.clear();
+    for (size_t i = 0; i < n; ++i){
+        bool hasDiag = false;
+        for (size_t p = rowPtr[i]; p < rowPtr[i+1] && colIdx[p] <= i; ++p){
+            _colIdx.push_back(colIdx[p]);
+            _values.push_back(colIdx[p] == i ? values[p]*(T{1} + shift) : values[p]);
+            hasDiag = hasDiag || colIdx[p] == i;
+        };
+        if (!hasDiag) return false;
+        _rowPtr[i+1] = _colIdx.size();
+    };
+
+    for (size_t i = 0; i < n; ++i){
+        size_t diag = _rowPtr[i+1]-1;
+
+        for (size_t p = _rowPtr[i]; p <= diag; ++p){
+            size_t k = _colIdx[p];
+
+            // sparse dot product of rows i and k of L over columns < k
+            T sum{0};
+            size_t pi = _rowPtr[i];
+            size_t pk = _rowPtr[k];
+            while (pi < p && pk < _rowPtr[k+1]-1){
+                if (_colIdx[pi] == _colIdx[pk]){
+                    sum += _values[pi]*_values[pk];
+                    ++pi; ++pk;
+                }
+                else if (_colIdx[pi] < _colIdx[pk]) ++pi;
+                else ++pk;
+            };
+
+            if (p == diag){
+                T d = _values[p] - sum;
+                if (!(d > T{0})) return false;
+                _values[p] = std::sqrt(d);
+            }
+            else {
+                _values[p] = (_values[p] - sum)/_values[_rowPtr[k+1]-1];
+            };
+        };
+    };
+
+    return true;
+};
+
+template<typename T>
+std::vector<T> IncompleteCholeskyPreconditioner<T>::apply(const std::vector<T>& r) const{
+
+    size_t n = _rowPtr.size()-1;
+    std::vector<T> z(r);
+
+    // L*y = r
+    for (size_t i = 0; i < n; ++i){
+        size_t diag = _rowPtr[i+1]-1;
+        T sum = z[i];
+        for (size_t p = _rowPtr[i]; p < diag; ++p){
+            sum -= _values[p]*z[_colIdx[p]];
+        };
+        z[i] = sum/_values[diag];
+    };
+
+    // L^T*z = y, row i of L is column i of L^T
+    for (size_t i = n; i-- > 0;){
+        size_t diag = _rowPtr[i+1]-1;
+        z[i] /= _values[diag];
+        for (size_t p = _rowPtr[i]; p < diag; ++p){
+            z[_colIdx[p]] -= _values[p]*z[i];
+        };
+    };
+
+    return z;
+};
+
+template<typename T, typename Operator, typename Preconditioner>
+std::vector<T> conjugateGradient(const Operator& A, const std::vector<T>& b, const Preconditioner& M,
+                                 T tolerance, size_t maxIterations, CGReport<T>& report){
+
+    size_t n = b.size();
+
+    report.iterations = 0;
+    report.converged = false;
+    report.residualHistory.clear();
+
+    auto dot = [n](const std::vector<T>& x, const std::vector<T>& y){
+        return dotProduct(x.data(), y.data(), n);
+    };
+
+    std::vector<T> x(n, T{0});
+    std::vector<T> r(b);
+
+    T bNorm = std::sqrt(dot(b, b));
+    if (bNorm == T{0}){
+        report.converged = true;
+        report.residualHistory.push_back(T{0});
+        return x;
+    };
+
+    report.residualHistory.push_back(T{1});
+
+    std::vector<T> z = M.apply(r);
+    std::vector<T> p(z);
+    T rz = dot(r, z);
+
+    while (report.iterations < maxIterations){
+
+        std::vector<T> Ap = A.mVm(p);
+        T pAp = dot(p, Ap);
+        if (!(pAp > T{0})){
+            throw std::runtime_error("Operator is not positive definite! (conjugateGradient)");
+        };
+
+        T alpha = rz/pAp;
+        axpy(alpha, p.data(), x.data(), n);
+        axpy(-alpha, Ap.data(), r.data(), n);
+        report.iterations++;
+
+        T relRes = std::sqrt(dot(r, r))/bNorm;
+        report.residualHistory.push_back(relRes);
+        if (relRes < tolerance){
+            report.converged = true;
+            break;
+        };
+
+        z = M.apply(r);
+        T rzNew = dot(r, z);
+        T beta = rzNew/rz;
+        rz = rzNew;
+        for (size_t i = 0; i < n; ++i){
+            p[i] = z[i] + beta*p[i];
+        };
+    };
+
+    return x;
+};
+
+#endif
@@ -0,0 +1,277 @@
+#ifndef FIXEDMATRIX_H
+#define FIXEDMATRIX_H
+
+#include "Matrix.h"
+#include "VectorView.h"
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Templated class FixedMatrix.
+ * Matrix with compile-time size stored row-major in a std::array, i.e. on the stack.
+ * Used for element level kernels, e.g. the 6x6 truss element stiffness matrix,
+ * where a heap allocated Matrix would dominate the cost.
+ * @see Matrix
+ */
+template<typename T, size_t R, size_t C>
+class FixedMatrix {
+
+    private:
+
+        /**
+         * Private member variable.
+         * Row-major storage of the R*C entries
+         */
+        std::array<T, R*C> _data;
+
+    public:
+
+        /**
+        * FixedMatrix class constructor.
+        * Generates a FixedMatrix with all entries zero.
+        */
+        FixedMatrix() : _data{} {};
+
+        /**
+        * FixedMatrix class constructor.
+        * Constructs matrices with list syntax, the list must have exactly R rows of C entries.
+        * Example: FixedMatrix<int,2,2> M = {{1,2},{3,4}};
+        */
+        FixedMatrix(std::initializer_list<std::initializer_list<T>> init);
+
+        /**
+        * Member function for finding the size.
+        * @return A vector containing the sizes in order: {rows, columns}.
+        */
+        std::vector<size_t> getSize() const {return {R, C};};
+
+        /**
+        * Member function for operator() overloading.
+        * Allows for both read and write.
+        * @param r Row index
+        * @param c Column index
+        */
+        T& operator()(size_t r, size_t c);
+
+        /**
+        * Member function for operator() overloading.
+        * Allows only for reading.
+        * @param r Row index
+        * @param c Column index
+        */
+        const T& operator()(size_t r, size_t c) const;
+
+        /**
+        * Member function for unchecked access, used by the kernels.
+        * The indices are checked only if BAROP_BOUNDS_CHECK is enabled (debug builds).
+        * @param r Row index
+        * @param c Column index
+        */
+        T& unchecked(size_t r, size_t c){
+
+            BAROP_CHECK_INDEX(r < R && c < C, "FixedMatrix::unchecked");
+            return _data[r*C + c];
+        };
+
+        /**
+        * Member function for unchecked reading, used by the kernels.
+        * The indices are checked only if BAROP_BOUNDS_CHECK is enabled (debug builds).
+        * @param r Row index
+        * @param c Column index
+        */
+        const T& unchecked(size_t r, size_t c) const{
+
+            BAROP_CHECK_INDEX(r < R && c < C, "FixedMatrix::unchecked");
+            return _data[r*C + c];
+        };
+
+        /**
+        * Member function for operator + .
+        * @param M2 Matrix of the same size
+        * @return Sum of the matrices
+        */
+        FixedMatrix<T,R,C> operator+(const FixedMatrix<T,R,C>& M2) const;
+
+        /**
+        * Member function for operator - .
+        * @param M2 Matrix of the same size
+        * @return Difference of the matrices
+        */
+        FixedMatrix<T,R,C> operator-(const FixedMatrix<T,R,C>& M2) const;
+
+        /**
+        * Member function for multiplication with a scalar.
+        * @param scalar Scalar factor
+        * @return Scaled matrix
+        */
+        FixedMatrix<T,R,C> operator*(T scalar) const;
+
+        /**
+        * Member function for matrix multiplication, sizes are checked at compile time.
+        * @param M2 Matrix multiplied from right
+        * @return Resulting R x K matrix
+        */
+        template<size_t K>
+        FixedMatrix<T,R,K> operator*(const FixedMatrix<T,C,K>& M2) const;
+
+        /**
+        * Member function for computing matrix vector multiplication.
+        * @param vec Vector that is wanted to be multiplied from right
+        * @return Resulting vector
+        */
+        std::array<T,R> mVm(const std::array<T,C>& vec) const;
+
+        /**
+        * Member function for transposing.
+        * @return Transposed matrix
+        */
+        FixedMatrix<T,C,R> transpose() const;
+
+        /**
+        * Member function for converting to a dynamic Matrix.
+        * @return Matrix with the same entries
+        * @see Matrix
+        */
+        Matrix<T> toMatrix() const;
+
+        /**
+        * Member function returning the row-major storage.
+        * @return Pointer to the first entry
+        */
+        T* data() {return _data.data();};
+
+        /**
+        * Member function returning the row-major storage for reading.
+        * @return Pointer to the first entry
+        */
+        const T* data() const {return _data.data();};
+};
+
+// TEMPLATE DEFINITIONS, ONLY-HEADER FILE IMPLEMENTATION!
+
+template<typename T, size_t R, size_t C>
+FixedMatrix<T,R,C>::FixedMatrix(std::initializer_list<std::initializer_list<T>> init) : _data{}{
+
+    if (init.size() != R){
+        throw std::invalid_argument("Number of rows does not match! (FixedMatrix)");
+    };
+
+    size_t i = 0;
+    for (const auto& row : init){
+        if (row.size() != C){
+            throw std::invalid_argument("Number of columns does not match! (FixedMatrix)");
+        };
+        for (const T& value : row){
+            _data[i++] = value;
+        };
+    };
+};
+
+template<typename T, size_t R, size_t C>
+T& FixedMatrix<T,R,C>::operator()(size_t r, size_t c){
+
+    if (r >= R || c >= C){
+        throw std::out_of_range("Index is out of range! (FixedMatrix)");
+    };
+
+    return _data[r*C + c];
+};
+
+template<typename T, size_t R, size_t C>
+const T& FixedMatrix<T,R,C>::operator()(size_t r, size_t c) const{
+
+    if (r >= R || c >= C){
+        throw std::out_of_range("Index is out of range! (FixedMatrix)");
+    };
+
+    return _data[r*C + c];
+};
+
+template<typename T, size_t R, size_t C>
+FixedMatrix<T,R,C> FixedMatrix<T,R,C>::operator+(const FixedMatrix<T,R,C>& M2) const{
+
+    FixedMatrix<T,R,C> result;
+    for (size_t i = 0; i < R*C; ++i){
+        result._data[i] = _data[i] + M2._data[i];
+    };
+    return result;
+};
+
+template<typename T, size_t R, size_t C>
+FixedMatrix<T,R,C> FixedMatrix<T,R,C>::operator-(const FixedMatrix<T,R,C>& M2) const{
+
+    FixedMatrix<T,R,C> result;
+    for (size_t i = 0; i < R*C; ++i){
+        result._data[i] = _data[i] - M2._data[i];
+    };
+    return result;
+};
+
+template<typename T, size_t R, size_t C>
+FixedMatrix<T,R,C> FixedMatrix<T,R,C>::operator*(T scalar) const{
+
+    FixedMatrix<T,R,C> result;
+    for (size_t i = 0; i < R*C; ++i){
+        result._data[i] = _data[i]*scalar;
+    };
+    return result;
+};
+
+template<typename T, size_t R, size_t C>
+template<size_t K>
+FixedMatrix<T,R,K> FixedMatrix<T,R,C>::operator*(const FixedMatrix<T,C,K>& M2) const{
+
+    FixedMatrix<T,R,K> result;
+    T* res = result.data();
+    const T* b = M2.data();
+
+    for (size_t i = 0; i < R; ++i){
+        for (size_t p = 0; p < C; ++p){
+            const T a = _data[i*C + p];
+            for (size_t j = 0; j < K; ++j){
+                res[i*K + j] += a*b[p*K + j];
+            };
+        };
+    };
+    return result;
+};
+
+template<typename T, size_t R, size_t C>
+std::array<T,R> FixedMatrix<T,R,C>::mVm(const std::array<T,C>& vec) const{
+
+    std::array<T,R> result{};
+    for (size_t i = 0; i < R; ++i){
+        T sum{0};
+        for (size_t j = 0; j < C; ++j){
+            sum += _data[i*C + j]*vec[j];
+        };
+        result[i] = sum;
+    };
+    return result;
+};
+
+template<typename T, size_t R, size_t C>
+FixedMatrix<T,C,R> FixedMatrix<T,R,C>::transpose() const{
+
+    FixedMatrix<T,C,R> result;
+    T* res = result.data();
+    for (size_t i = 0; i < R; ++i){
+        for (size_t j = 0; j < C; ++j){
+            res[j*R + i] = _data[i*C + j];
+        };
+    };
+    return result;
+};
+
+template<typename T, size_t R, size_t C>
+Matrix<T> FixedMatrix<T,R,C>::toMatrix() const{
+
+    Matrix<T> M(R, C);
+    std::copy(_data.begin(), _data.end(), M.data());
+    return M;
+};
+
+#endif
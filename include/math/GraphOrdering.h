@@ -0,0 +1,654 @@
+#ifndef GRAPHORDERING_H
+#define GRAPHORDERING_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Function for computing a fill-reducing approximate minimum degree (AMD) ordering.
+ * Works on the quotient graph of the elimination: eliminated vertices become elements that
+ * absorb the elements they cover, vertices with identical adjacency are merged into supervariables
+ * and eliminated together, and the external degree of each variable is bounded by the approximate
+ * degree of Amestoy, Davis and Duff instead of being recomputed exactly. The cost stays close to
+ * linear in the number of edges. Vertices of very high degree are ordered last.
+ * The elimination tree of the result is postordered.
+ * @param adjacency Neighbour lists of each vertex, symmetric, may be unsorted and contain self loops
+ * @return Elimination order, order[k] is the vertex eliminated k-th
+ */
+inline std::vector<size_t> approximateMinimumDegreeOrdering(const std::vector<std::vector<size_t>>& adjacency){
+
+    const long n = static_cast<long>(adjacency.size());
+    if (n == 0) return {};
+
+    // flip(i) marks an absorbed object i and is its own inverse
+    auto flip = [](long i){ return -i - 2; };
+
+    // quotient graph in one array, Cp[i] is the start of the list of vertex or element i in Ci,
+    // elbow room for the new elements and garbage collection when it runs out
+    std::vector<long> Cp(n+1);
+    std::vector<long> Ci;
+    Cp[0] = 0;
+    for (long i = 0; i < n; ++i){
+        for (size_t j : adjacency[i]){
+            if (static_cast<long>(j) != i) Ci.push_back(static_cast<long>(j));
+        };
+        std::sort(Ci.begin() + Cp[i], Ci.end());
+        Ci.erase(std::unique(Ci.begin() + Cp[i], Ci.end()), Ci.end());
+        Cp[i+1] = static_cast<long>(Ci.size());
+    };
+    long cnz = Cp[n];
+    Ci.resize(cnz + cnz/5 + 2*n);
+    const long nzmax = static_cast<long>(Ci.size());
+
+    // len: list length, nv: size of a supervariable (0 if absorbed, negative while in the new element),
+    // elen: number of elements in the list of a variable (-1 absorbed variable, -2 element),
+    // degree: approximate external degree, w: set differences |Le \ Lk| relative to mark,
+    // head/next/last: degree lists, also hash buckets and the assembly tree later
+    std::vector<long> len(n+1), nv(n+1, 1), next(n+1, -1), head(n+1, -1), elen(n+1, 0);
+    std::vector<long> degree(n+1), w(n+1, 1), hhead(n+1, -1), last(n+1, -1);
+
+    for (long k = 0; k < n; ++k){
+        len[k] = Cp[k+1] - Cp[k];
+        degree[k] = len[k];
+    };
+    len[n] = 0;
+    degree[n] = 0;
+
+    // w[0..n-1] < mark holds after each clear
+    auto clear = [&w, n](long mark, long lemax){
+        if (mark < 2 || mark + lemax < 0){
+            for (long k = 0; k < n; ++k){
+                if (w[k] != 0) w[k] = 1;
+            };
+            mark = 2;
+        };
+        return mark;
+    };
+
+    long mark = clear(0, 0);
+    long lemax = 0;
+    long mindeg = 0;
+    long nel = 0;
+
+    // n is a dead element collecting the dense vertices
+    elen[n] = -2;
+    Cp[n] = -1;
+    w[n] = 0;
+
+    long dense = std::max(16L, static_cast<long>(10.0*std::sqrt(static_cast<double>(n))));
+    dense = std::min(n - 2, dense);
+
+    for (long i = 0; i < n; ++i){
+        long d = degree[i];
+        if (d == 0){
+            // isolated vertex, eliminated as an element without neighbours
+            elen[i] = -2;
+            nel++;
+            Cp[i] = -1;
+            w[i] = 0;
+        }
+        else if (d > dense){
+            nv[i] = 0;
+            elen[i] = -1;
+            nel++;
+            Cp[i] = flip(n);
+            nv[n]++;
+        }
+        else {
+            if (head[d] != -1) last[head[d]] = i;
+            next[i] = head[d];
+            head[d] = i;
+        };
+    };
+
+    while (nel < n){
+
+        // variable of minimum approximate degree
+        long k = -1;
+        for (; mindeg < n && (k = head[mindeg]) == -1; mindeg++);
+        if (next[k] != -1) last[next[k]] = -1;
+        head[mindeg] = next[k];
+        long elenk = elen[k];
+        long nvk = nv[k];
+        nel += nvk;
+
+        // garbage collection, compacts the live lists to the front of Ci
+        if (elenk > 0 && cnz + mindeg >= nzmax){
+            for (long j = 0; j < n; ++j){
+                long p = Cp[j];
+                if (p >= 0){
+                    Cp[j] = Ci[p];
+                    Ci[p] = flip(j);
+                };
+            };
+            long q = 0;
+            for (long p = 0; p < cnz;){
+                long j = flip(Ci[p++]);
+                if (j >= 0){
+                    Ci[q] = Cp[j];
+                    Cp[j] = q++;
+                    for (long k3 = 0; k3 < len[j] - 1; ++k3) Ci[q++] = Ci[p++];
+                };
+            };
+            cnz = q;
+        };
+
+        // new element Lk: union of the variables of k and of the elements adjacent to k
+        long dk = 0;
+        nv[k] = -nvk;
+        long p = Cp[k];
+        long pk1 = (elenk == 0) ? p : cnz;
+        long pk2 = pk1;
+        for (long k1 = 1; k1 <= elenk + 1; ++k1){
+            long e, pj, ln;
+            if (k1 > elenk){
+                e = k;
+                pj = p;
+                ln = len[k] - elenk;
+            }
+            else {
+                e = Ci[p++];
+                pj = Cp[e];
+                ln = len[e];
+            };
+            for (long k2 = 1; k2 <= ln; ++k2){
+                long i = Ci[pj++];
+                long nvi = nv[i];
+                if (nvi <= 0) continue;
+                dk += nvi;
+                nv[i] = -nvi;
+                Ci[pk2++] = i;
+                if (next[i] != -1) last[next[i]] = last[i];
+                if (last[i] != -1){
+                    next[last[i]] = next[i];
+                }
+                else {
+                    head[degree[i]] = next[i];
+                };
+            };
+            // element absorption
+            if (e != k){
+                Cp[e] = flip(k);
+                w[e] = 0;
+            };
+        };
+        if (elenk != 0) cnz = pk2;
+        degree[k] = dk;
+        Cp[k] = pk1;
+        len[k] = pk2 - pk1;
+        elen[k] = -2;
+
+        // set differences |Le \ Lk| of all elements adjacent to Lk
+        mark = clear(mark, lemax);
+        for (long pk = pk1; pk < pk2; ++pk){
+            long i = Ci[pk];
+            long eln = elen[i];
+            if (eln <= 0) continue;
+            long nvi = -nv[i];
+            long wnvi = mark - nvi;
+            for (p = Cp[i]; p <= Cp[i] + eln - 1; ++p){
+                long e = Ci[p];
+                if (w[e] >= mark){
+                    w[e] -= nvi;
+                }
+                else if (w[e] != 0){
+                    w[e] = degree[e] + wnvi;
+                };
+            };
+        };
+
+        // approximate degree update, pruning of the lists and hashing of the variables in Lk
+        for (long pk = pk1; pk < pk2; ++pk){
+            long i = Ci[pk];
+            long p1 = Cp[i];
+            long p2 = p1 + elen[i] - 1;
+            long pn = p1;
+            size_t h = 0;
+            long d = 0;
+            for (p = p1; p <= p2; ++p){
+                long e = Ci[p];
+                if (w[e] != 0){
+                    long dext = w[e] - mark;
+                    if (dext > 0){
+                        d += dext;
+                        Ci[pn++] = e;
+                        h += static_cast<size_t>(e);
+                    }
+                    else {
+                        // aggressive absorption, Le is a subset of Lk
+                        Cp[e] = flip(k);
+                        w[e] = 0;
+                    };
+                };
+            };
+            elen[i] = pn - p1 + 1;
+            long p3 = pn;
+            long p4 = p1 + len[i];
+            for (p = p2 + 1; p < p4; ++p){
+                long j = Ci[p];
+                long nvj = nv[j];
+                if (nvj <= 0) continue;
+                d += nvj;
+                Ci[pn++] = j;
+                h += static_cast<size_t>(j);
+            };
+            if (d == 0){
+                // mass elimination, i is adjacent to nothing but Lk
+                Cp[i] = flip(k);
+                long nvi = -nv[i];
+                dk -= nvi;
+                nvk += nvi;
+                nel += nvi;
+                nv[i] = 0;
+                elen[i] = -1;
+            }
+            else {
+                degree[i] = std::min(degree[i], d);
+                Ci[pn] = Ci[p3];
+                Ci[p3] = Ci[p1];
+                Ci[p1] = k;
+                len[i] = pn - p1 + 1;
+                h %= static_cast<size_t>(n);
+                next[i] = hhead[h];
+                hhead[h] = i;
+                last[i] = static_cast<long>(h);
+            };
+        };
+        degree[k] = dk;
+        lemax = std::max(lemax, dk);
+        mark = clear(mark + lemax, lemax);
+
+        // supervariable detection, variables of one hash bucket with identical lists are merged
+        for (long pk = pk1; pk < pk2; ++pk){
+            long i = Ci[pk];
+            if (nv[i] >= 0) continue;
+            long h = last[i];
+            i = hhead[h];
+            hhead[h] = -1;
+            for (; i != -1 && next[i] != -1; i = next[i], mark++){
+                long ln = len[i];
+                long eln = elen[i];
+                for (p = Cp[i] + 1; p <= Cp[i] + ln - 1; ++p) w[Ci[p]] = mark;
+                long jlast = i;
+                for (long j = next[i]; j != -1;){
+                    bool same = (len[j] == ln) && (elen[j] == eln);
+                    for (p = Cp[j] + 1; same && p <= Cp[j] + ln - 1; ++p){
+                        if (w[Ci[p]] != mark) same = false;
+                    };
+                    if (same){
+                        Cp[j] = flip(i);
+                        nv[i] += nv[j];
+                        nv[j] = 0;
+                        elen[j] = -1;
+                        j = next[j];
+                        next[jlast] = j;
+                    }
+                    else {
+                        jlast = j;
+                        j = next[j];
+                    };
+                };
+            };
+        };
+
+        // finalize Lk, put its variables back into the degree lists
+        p = pk1;
+        for (long pk = pk1; pk < pk2; ++pk){
+            long i = Ci[pk];
+            long nvi = -nv[i];
+            if (nvi <= 0) continue;
+            nv[i] = nvi;
+            long d = degree[i] + dk - nvi;
+            d = std::min(d, n - nel - nvi);
+            if (head[d] != -1) last[head[d]] = i;
+            next[i] = head[d];
+            last[i] = -1;
+            head[d] = i;
+            mindeg = std::min(mindeg, d);
+            degree[i] = d;
+            Ci[p++] = i;
+        };
+        nv[k] = nvk;
+        len[k] = p - pk1;
+        if (len[k] == 0){
+            Cp[k] = -1;
+            w[k] = 0;
+        };
+        if (elenk != 0) cnz = p;
+    };
+
+    // assembly tree: absorbed variables are children of their representative, elements of their parent element
+    for (long i = 0; i < n; ++i) Cp[i] = flip(Cp[i]);
+    std::fill(head.begin(), head.end(), -1);
+    for (long j = n; j >= 0; --j){
+        if (nv[j] > 0) continue;
+        next[j] = head[Cp[j]];
+        head[Cp[j]] = j;
+    };
+    for (long e = n; e >= 0; --e){
+        if (nv[e] <= 0) continue;
+        if (Cp[e] != -1){
+            next[e] = head[Cp[e]];
+            head[Cp[e]] = e;
+        };
+    };
+
+    // postorder by depth first search from each root, n is the last root and comes last
+    std::vector<size_t> order;
+    order.reserve(n+1);
+    std::vector<long> stack;
+    for (long root = 0; root <= n; ++root){
+        if (Cp[root] != -1) continue;
+        stack.push_back(root);
+        while (!stack.empty()){
+            long v = stack.back();
+            long child = head[v];
+            if (child == -1){
+                stack.pop_back();
+                order.push_back(static_cast<size_t>(v));
+            }
+            else {
+                head[v] = next[child];
+                stack.push_back(child);
+            };
+        };
+    };
+    order.pop_back();
+
+    return order;
+};
+
+/**
+ * Function for computing a fill-reducing geometric nested dissection ordering.
+ * The vertices are split at the median coordinate of the widest axis of their bounding box,
+ * the vertices of the smaller side that have a neighbour on the other side form a vertex separator.
+ * Both halves are ordered recursively before the separator, so the separator columns of the factor
+ * become dense blocks at the top of the elimination tree. Parts of at most leafSize vertices are
+ * ordered with approximateMinimumDegreeOrdering() on their induced subgraph.
+ * For meshes and lattices in 2D and 3D this keeps the fill far below minimum degree orderings.
+ * @param adjacency Neighbour lists of each vertex, symmetric, may be unsorted and contain self loops
+ * @param coordinates Position of each vertex
+ * @param leafSize Largest part that is not split further
+ * @return Elimination order, order[k] is the vertex eliminated k-th
+ */
+inline std::vector<size_t> nestedDissectionOrdering(const std::vector<std::vector<size_t>>& adjacency,
+                                                    const std::vector<std::array<double,3>>& coordinates,
+                                                    size_t leafSize = 32){
+
+    const size_t n = adjacency.size();
+    if (coordinates.size() != n){
+        throw std::invalid_argument("Number of coordinates does not match the graph! (nestedDissectionOrdering)");
+    };
+
+    std::vector<size_t> order;
+    order.reserve(n);
+
+    // part of each vertex during the split of its current set, local index for the leaf subgraphs
+    std::vector<size_t> part(n, 0);
+    std::vector<size_t> local(n, 0);
+    size_t stamp = 0;
+
+    // orders the vertices of a leaf part by minimum degree on the induced subgraph
+    auto orderLeaf = [&](const std::vector<size_t>& vertices){
+        for (size_t i = 0; i < vertices.size(); ++i) local[vertices[i]] = i;
+        ++stamp;
+        for (size_t v : vertices) part[v] = stamp;
+        std::vector<std::vector<size_t>> sub(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i){
+            for (size_t w : adjacency[vertices[i]]){
+                if (part[w] == stamp) sub[i].push_back(local[w]);
+            };
+        };
+        for (size_t i : approximateMinimumDegreeOrdering(sub)) order.push_back(vertices[i]);
+    };
+
+    // recursion depth is logarithmic, the separators are appended after both halves
+    std::function<void(std::vector<size_t>&)> dissect = [&](std::vector<size_t>& vertices){
+
+        if (vertices.size() <= leafSize){
+            orderLeaf(vertices);
+            return;
+        };
+
+        std::array<double,3> lo = coordinates[vertices[0]];
+        std::array<double,3> hi = lo;
+        for (size_t v : vertices){
+            for (size_t d = 0; d < 3; ++d){
+                lo[d] = std::min(lo[d], coordinates[v][d]);
+                hi[d] = std::max(hi[d], coordinates[v][d]);
+            };
+        };
+        size_t axis = 0;
+        for (size_t d = 1; d < 3; ++d){
+            if (hi[d] - lo[d] > hi[axis] - lo[axis]) axis = d;
+        };
+        if (!(hi[axis] > lo[axis])){
+            orderLeaf(vertices);
+            return;
+        };
+
+        // median coordinate, vertices on the median plane go to the upper half so that planes stay whole
+        std::vector<double> c(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) c[i] = coordinates[vertices[i]][axis];
+        std::nth_element(c.begin(), c.begin() + c.size()/2, c.end());
+        double median = c[c.size()/2];
+        if (!(median > lo[axis])) median = std::nextafter(lo[axis], hi[axis]);
+
+        const size_t lower = ++stamp;
+        const size_t upper = ++stamp;
+        for (size_t v : vertices){
+            part[v] = (coordinates[v][axis] < median) ? lower : upper;
+        };
+
+        // one-sided vertex separators, the smaller one is taken
+        std::vector<size_t> sepLower;
+        std::vector<size_t> sepUpper;
+        for (size_t v : vertices){
+            size_t other = (part[v] == lower) ? upper : lower;
+            for (size_t w : adjacency[v]){
+                if (part[w] == other){
+                    ((part[v] == lower) ? sepLower : sepUpper).push_back(v);
+                    break;
+                };
+            };
+        };
+        const size_t separated = (sepLower.size() <= sepUpper.size()) ? lower : upper;
+        std::vector<size_t>& separator = (separated == lower) ? sepLower : sepUpper;
+        const size_t sepStamp = ++stamp;
+        for (size_t v : separator) part[v] = sepStamp;
+
+        std::vector<size_t> first;
+        std::vector<size_t> second;
+        for (size_t v : vertices){
+            if (part[v] == lower){
+                first.push_back(v);
+            }
+            else if (part[v] == upper){
+                second.push_back(v);
+            };
+        };
+        std::vector<size_t>().swap(vertices);
+
+        dissect(first);
+        dissect(second);
+        order.insert(order.end(), separator.begin(), separator.end());
+    };
+
+    std::vector<size_t> all(n);
+    for (size_t v = 0; v < n; ++v) all[v] = v;
+    dissect(all);
+
+    return order;
+};
+
+/**
+ * Function for counting the nonzeros of the Cholesky factor of a graph under an elimination order,
+ * diagonal included. Builds the elimination tree and walks the row subtrees, the cost is of the
+ * order of the counted nonzeros, so orderings can be compared before any numeric work.
+ * @param adjacency Neighbour lists of each vertex, symmetric, may be unsorted and contain self loops
+ * @param order Elimination order, order[k] is the vertex eliminated k-th
+ * @return Number of nonzeros in the lower triangular factor
+ */
+inline size_t choleskyFactorNonzeros(const std::vector<std::vector<size_t>>& adjacency, const std::vector<size_t>& order){
+
+    const size_t n = adjacency.size();
+    if (order.size() != n){
+        throw std::invalid_argument("Order does not match the graph! (choleskyFactorNonzeros)");
+    };
+    const size_t none = n;
+
+    std::vector<size_t> pinv(n, none);
+    for (size_t k = 0; k < n; ++k){
+        if (order[k] >= n || pinv[order[k]] != none){
+            throw std::invalid_argument("Order is not a permutation! (choleskyFactorNonzeros)");
+        };
+        pinv[order[k]] = k;
+    };
+
+    // elimination tree with path compression
+    std::vector<size_t> parent(n, none);
+    std::vector<size_t> ancestor(n, none);
+    for (size_t k = 0; k < n; ++k){
+        for (size_t w : adjacency[order[k]]){
+            size_t i = pinv[w];
+            while (i < k){
+                size_t next = ancestor[i];
+                ancestor[i] = k;
+                if (next == none){
+                    parent[i] = k;
+                    break;
+                };
+                i = next;
+            };
+        };
+    };
+
+    // row k of the factor is the union of the tree paths from its neighbours up to k
+    std::vector<size_t> mark(n, none);
+    size_t nnz = n;
+    for (size_t k = 0; k < n; ++k){
+        mark[k] = k;
+        for (size_t w : adjacency[order[k]]){
+            for (size_t i = pinv[w]; i < k && mark[i] != k; i = parent[i]){
+                mark[i] = k;
+                ++nnz;
+            };
+        };
+    };
+    return nnz;
+};
+
+/**
+ * Function for computing a bandwidth-reducing reverse Cuthill-McKee ordering.
+ * Each connected component is traversed breadth-first from a pseudo-peripheral vertex,
+ * visiting neighbours by increasing degree, the resulting sequence is reversed.
+ * @param adjacency Neighbour lists of each vertex, may be unsorted and contain self loops
+ * @return New order, order[k] is the vertex placed at position k
+ */
+inline std::vector<size_t> reverseCuthillMcKee(std::vector<std::vector<size_t>> adjacency){
+
+    size_t n = adjacency.size();
+
+    for (size_t v = 0; v < n; ++v){
+        std::vector<size_t>& nb = adjacency[v];
+        std::sort(nb.begin(), nb.end());
+        nb.erase(std::unique(nb.begin(), nb.end()), nb.end());
+        auto self = std::lower_bound(nb.begin(), nb.end(), v);
+        if (self != nb.end() && *self == v) nb.erase(self);
+    };
+
+    // visit neighbours by increasing degree, ties by index
+    for (size_t v = 0; v < n; ++v){
+        std::stable_sort(adjacency[v].begin(), adjacency[v].end(),
+                         [&adjacency](size_t a, size_t b){ return adjacency[a].size() < adjacency[b].size(); });
+    };
+
+    std::vector<size_t> order;
+    order.reserve(n);
+    std::vector<bool> placed(n, false);
+
+    // work arrays for the level structure search, searches count from 1 so stamp 0 is never reached
+    std::vector<size_t> stamp(n, 0);
+    std::vector<size_t> level;
+    size_t search = 0;
+
+    // breadth first search from root, returns the eccentricity of root, level holds the visit order
+    auto levelStructure = [&](size_t root, size_t& last){
+        ++search;
+        level.clear();
+        level.push_back(root);
+        stamp[root] = search;
+        size_t depth = 0;
+        size_t begin = 0;
+        while (begin < level.size()){
+            size_t end = level.size();
+            for (size_t i = begin; i < end; ++i){
+                for (size_t w : adjacency[level[i]]){
+                    if (stamp[w] != search && !placed[w]){
+                        stamp[w] = search;
+                        level.push_back(w);
+                    };
+                };
+            };
+            // smallest degree vertex of the last level
+            if (end == level.size()){
+                last = level[begin];
+                for (size_t i = begin; i < end; ++i){
+                    if (adjacency[level[i]].size() < adjacency[last].size()) last = level[i];
+                };
+            }
+            else {
+                depth++;
+            };
+            begin = end;
+        };
+        return depth;
+    };
+
+    for (size_t s = 0; s < n; ++s){
+
+        if (placed[s]) continue;
+
+        // smallest degree vertex of this component as starting guess
+        size_t root = s;
+        size_t last = s;
+        levelStructure(s, last);
+        for (size_t v : level){
+            if (adjacency[v].size() < adjacency[root].size()) root = v;
+        };
+
+        // pseudo-peripheral vertex: move to the far end while the eccentricity grows
+        size_t ecc = levelStructure(root, last);
+        while (true){
+            size_t candidate = last;
+            size_t candidateEcc = levelStructure(candidate, last);
+            if (candidateEcc <= ecc) break;
+            root = candidate;
+            ecc = candidateEcc;
+        };
+
+        // Cuthill-McKee traversal of the component
+        size_t head = order.size();
+        order.push_back(root);
+        placed[root] = true;
+        while (head < order.size()){
+            size_t v = order[head++];
+            for (size_t w : adjacency[v]){
+                if (!placed[w]){
+                    placed[w] = true;
+                    order.push_back(w);
+                };
+            };
+        };
+    };
+
+    std::reverse(order.begin(), order.end());
+    return order;
+};
+
+#endif
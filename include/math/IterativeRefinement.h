@@ -0,0 +1,123 @@
+#ifndef ITERATIVEREFINEMENT_H
+#define ITERATIVEREFINEMENT_H
+
+#include "PackedMatrix.h"
+#include "VectorKernels.h"
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Convergence report of a mixed precision solve with iterative refinement.
+ */
+template<typename T>
+struct RefinementReport{
+
+    /**
+     * Number of refinement steps performed, the first solve with the factor included
+     */
+    size_t iterations = 0;
+
+    /**
+     * True if the backward error dropped below the tolerance
+     */
+    bool converged = false;
+
+    /**
+     * Normwise backward error ||b - A*x|| / (||A||*||x|| + ||b||) before the first and after each step,
+     * computed in the working precision T
+     */
+    std::vector<T> backwardErrorHistory;
+};
+
+/**
+ * Function for solving A*x = b with a Cholesky factor of lower precision and iterative refinement.
+ * Each step solves L*L^T*d = r in the precision F of the factor and updates x += d, the residual
+ * r = b - A*x is computed in the working precision T. For a well-conditioned A the error
+ * drops by about cond(A)*eps(F) per step down to the accuracy of a factorization in T.
+ * Convergence is measured by the normwise backward error ||r|| / (||A||*||x|| + ||b||), which a
+ * backward stable solver in T brings down to a small multiple of eps(T) regardless of cond(A);
+ * the relative residual ||r|| / ||b|| is larger by up to cond(A) and would stall above such a tolerance.
+ * Stops when the tolerance is met, at the iteration cap or when a step no longer reduces the residual.
+ * A can be any operator providing mVm() in precision T, e.g. SparseMatrix or PackedMatrix.
+ * @param A Operator of the linear system
+ * @param normA Norm of A consistent with the vector 2-norm, e.g. the Frobenius norm
+ * @param L Cholesky factor of A in precision F, see PackedMatrix::choInPlace()
+ * @param b Right hand side vector
+ * @param tolerance Backward error at which the iteration stops, a few eps(T)
+ * @param maxIterations Iteration cap
+ * @param report Receives iteration count, convergence flag and backward error history
+ * @return Approximate solution x
+ */
+template<typename T, typename F, typename Operator>
+std::vector<T> iterativeRefinement(const Operator& A, T normA, const PackedMatrix<F>& L, const std::vector<T>& b,
+                                   T tolerance, size_t maxIterations, RefinementReport<T>& report);
+
+// TEMPLATE DEFINITIONS, ONLY-HEADER FILE IMPLEMENTATION!
+
+template<typename T, typename F, typename Operator>
+std::vector<T> iterativeRefinement(const Operator& A, T normA, const PackedMatrix<F>& L, const std::vector<T>& b,
+                                   T tolerance, size_t maxIterations, RefinementReport<T>& report){
+
+    size_t n = b.size();
+    if (L.getSize()[0] != n){
+        throw std::invalid_argument("Matrix-vector sizes don't match! (iterativeRefinement)");
+    };
+
+    report.iterations = 0;
+    report.converged = false;
+    report.backwardErrorHistory.clear();
+
+    std::vector<T> x(n, T{0});
+    std::vector<T> r(b);
+
+    T bNorm = std::sqrt(dotProduct(b.data(), b.data(), n));
+    if (bNorm == T{0}){
+        report.converged = true;
+        report.backwardErrorHistory.push_back(T{0});
+        return x;
+    };
+
+    report.backwardErrorHistory.push_back(T{1});
+    T rNorm = bNorm;
+    std::vector<F> r_low(n);
+
+    while (report.iterations < maxIterations){
+
+        // the residual is scaled to unit norm so that it stays inside the range of F
+        for (size_t i = 0; i < n; ++i){
+            r_low[i] = static_cast<F>(r[i]/rNorm);
+        };
+        std::vector<F> d = L.transposedBackwardSubstitution(L.forwardSubstitution(r_low));
+
+        for (size_t i = 0; i < n; ++i){
+            x[i] += rNorm*static_cast<T>(d[i]);
+        };
+        report.iterations++;
+
+        std::vector<T> Ax = A.mVm(x);
+        for (size_t i = 0; i < n; ++i){
+            r[i] = b[i] - Ax[i];
+        };
+
+        T rNormNew = std::sqrt(dotProduct(r.data(), r.data(), n));
+        T xNorm = std::sqrt(dotProduct(x.data(), x.data(), n));
+        T backwardError = rNormNew/(normA*xNorm + bNorm);
+        report.backwardErrorHistory.push_back(backwardError);
+        if (backwardError < tolerance){
+            report.converged = true;
+            break;
+        };
+
+        // stagnation, the accuracy of T is reached or A is too ill-conditioned for F
+        if (!(rNormNew < rNorm)){
+            break;
+        };
+        rNorm = rNormNew;
+    };
+
+    return x;
+};
+
+#endif
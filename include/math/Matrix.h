@@ -5,17 +5,43 @@
 #include <cstddef>
 #include <initializer_list>
 #include <iostream>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <string>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include "Parallel.h"
+#include "VectorKernels.h"
+#include "VectorView.h"
+#include "MatrixExpression.h"
+
+/**
+ * Byte alignment of the contiguous Matrix storage buffer.
+ * Defaults to a 64-byte cache line; define as 0 before including this header
+ * to fall back to the natural alignment of the element type.
+ */
+#ifndef BAROP_MATRIX_ALIGNMENT
+#define BAROP_MATRIX_ALIGNMENT 64
+#endif
+
+/**
+ * Tile size of the cache-blocked kernels used by operator* and cho().
+ * A 64x64 tile of doubles is 32 KB, i.e. about one L1 data cache.
+ */
+#ifndef BAROP_MATRIX_BLOCK_SIZE
+#define BAROP_MATRIX_BLOCK_SIZE 64
+#endif
 
 /**
  * Templated class Matrix.
  * A matrix class that is used to represent matrix like data structures.
+ * Entries are stored row-major in a single contiguous (cache line aligned) buffer.
  * Contains important functions such as deleteRows(), deleteColumns() and cho() to handle LSEs.
  */
 template<typename T>
-class Matrix {
+class Matrix : public MatrixExpr<Matrix<T>> {
 
     private:
 
@@ -33,18 +59,131 @@ class Matrix {
 
         /**
          * Private member variable.
-         * A dynamic matrix structure
+         * Number of entries the storage buffer can hold
+         */
+        size_t _capacity;
+
+        /**
+         * Private member variable.
+         * Contiguous row-major storage, entry (r,c) is at _matrix[r*_size2 + c]
+         */
+        T* _matrix;
+
+        /**
+         * Private member variable.
+         * Alignment used for the storage buffer
          */
-        T** _matrix;
+        static constexpr std::align_val_t _alignment{
+            BAROP_MATRIX_ALIGNMENT > alignof(T) ? BAROP_MATRIX_ALIGNMENT : alignof(T)};
+
+        /**
+         * Private member function.
+         * Allocates an aligned buffer of n default-initialized entries.
+         * @param n Number of entries
+         * @return Pointer to the buffer, nullptr if n is zero
+         */
+        static T* allocate(size_t n);
+
+        /**
+         * Private member function.
+         * Releases a buffer obtained from allocate().
+         * @param p Pointer to the buffer
+         * @param n Number of entries the buffer holds
+         */
+        static void deallocate(T* p, size_t n);
+
+        /**
+        * Private member variable.
+        * Tile size of the blocked kernels
+        */
+        static constexpr size_t _block = BAROP_MATRIX_BLOCK_SIZE > 0 ? BAROP_MATRIX_BLOCK_SIZE : 1;
+
+        /**
+        * Private member variable.
+        * Rows of the register tile of the blocked kernels
+        */
+        static constexpr size_t _tileRows = 4;
+
+        /**
+        * Private member variable.
+        * Columns of the register tile of the blocked kernels
+        */
+        static constexpr size_t _tileCols = 32;
+
+        /**
+        * Private member function.
+        * Register tile of the blocked kernels, acc = A*B for a _tileRows x _tileCols block of the result.
+        * Fixed sizes and local accumulators let the compiler keep acc in vector registers.
+        * Entry (r,p) of A is at A[r*rsa + p*csa], so A can also be a transposed row-major matrix.
+        * @param k Columns of A, rows of B
+        * @param acc Receives the product, row-major
+        */
+        static void tile(size_t k, const T* A, size_t rsa, size_t csa, const T* B, size_t ldb, T* acc);
+
+        /**
+        * Private member function.
+        * Cache-blocked GEMM kernel, C += alpha*A*B on row-major B and C with leading dimensions.
+        * Entry (i,p) of A is at A[i*rsa + p*csa], so A can also be a transposed row-major matrix.
+        * @param m Rows of A and C
+        * @param n Columns of B and C
+        * @param k Columns of A, rows of B
+        * @param alpha Scalar factor of the product
+        */
+        static void gemm(size_t m, size_t n, size_t k, const T* A, size_t rsa, size_t csa,
+                         const T* B, size_t ldb, T* C, size_t ldc, T alpha);
+
+        template<typename L, typename R>
+        friend class MatrixProduct;
+
+        template<typename U>
+        friend class PackedMatrix;
+
+        template<typename U>
+        friend class SparseCholesky;
+
+        /**
+        * Private member function.
+        * Cache-blocked SYRK kernel, lower triangle of C -= A*A^T.
+        * A is packed transposed once, so the inner loop streams contiguous rows.
+        * @param m Rows of A, size of C
+        * @param k Columns of A
+        */
+        static void syrk(size_t m, size_t k, const T* A, size_t lda, T* C, size_t ldc);
+
+        /**
+        * Private member function.
+        * TRSM kernel, B := B*L^-T with L lower triangular (the panel solve of a blocked Cholesky).
+        * @param m Rows of B
+        * @param k Size of L, columns of B
+        */
+        static void trsm(size_t m, size_t k, const T* L, size_t ldl, T* B, size_t ldb);
+
+        /**
+        * Private member function.
+        * Unblocked in-place Cholesky factorization of the lower triangle of a diagonal block.
+        * @param n Size of the block
+        */
+        static void choBlock(size_t n, T* A, size_t lda);
+
+        /**
+        * Private member function.
+        * Rank-1 modification of a Cholesky factor, L*L^T + sign*x*x^T, in place.
+        * @param x Modification vector, overwritten
+        * @param sign +1 for an update, -1 for a downdate
+        * @param caller Name of the public member function reported in exceptions
+        */
+        void choRankOne(std::vector<T>& x, int sign, const char* caller);
 
     public:
 
         /**
         * A static public vartible for checking memory leaks (dangling pointers and such).
+        * Counts live storage buffers, i.e. one per non-empty matrix.
         * Used in unit tests to compare the number of allocations and destructions.
+        * Atomic, matrices are created concurrently e.g. by the parallel element assembly.
         * Should not be used for analysis!
         */
-        static int allocations;
+        static std::atomic<int> allocations;
 
         /**
         * Matrix class constructor.
@@ -82,6 +221,13 @@ class Matrix {
         */
         Matrix(const Matrix& M);
 
+        /**
+        * Matrix class move-constructor.
+        * Takes over the storage buffer, M is left as an empty 0x0 matrix.
+        * @param M Matrix whose storage is taken over
+        */
+        Matrix(Matrix&& M) noexcept;
+
         /**
         * Matrix class destructor
         */
@@ -114,6 +260,74 @@ class Matrix {
         */
         const T& operator()(const size_t& r, const size_t& c) const;
 
+        /**
+        * Member function for unchecked access, used by the kernels.
+        * The indices are checked only if BAROP_BOUNDS_CHECK is enabled (debug builds).
+        * @param r Row index
+        * @param c Column index
+        */
+        T& unchecked(size_t r, size_t c){
+
+            BAROP_CHECK_INDEX(r < _size1 && c < _size2, "Matrix::unchecked");
+            return _matrix[r*_size2 + c];
+        };
+
+        /**
+        * Member function for unchecked reading, used by the kernels.
+        * The indices are checked only if BAROP_BOUNDS_CHECK is enabled (debug builds).
+        * @param r Row index
+        * @param c Column index
+        */
+        const T& unchecked(size_t r, size_t c) const{
+
+            BAROP_CHECK_INDEX(r < _size1 && c < _size2, "Matrix::unchecked");
+            return _matrix[r*_size2 + c];
+        };
+
+        /**
+        * Member function returning a contiguous view of a row.
+        * @param r Row index, checked only if BAROP_BOUNDS_CHECK is enabled
+        * @return View of the _size2 entries of row r
+        */
+        VectorView<T> row(size_t r){
+
+            BAROP_CHECK_INDEX(r < _size1, "Matrix::row");
+            return VectorView<T>(_matrix + r*_size2, _size2);
+        };
+
+        /**
+        * Member function returning a read-only contiguous view of a row.
+        * @param r Row index, checked only if BAROP_BOUNDS_CHECK is enabled
+        * @return View of the _size2 entries of row r
+        */
+        VectorView<const T> row(size_t r) const{
+
+            BAROP_CHECK_INDEX(r < _size1, "Matrix::row");
+            return VectorView<const T>(_matrix + r*_size2, _size2);
+        };
+
+        /**
+        * Member function returning a strided view of a column.
+        * @param c Column index, checked only if BAROP_BOUNDS_CHECK is enabled
+        * @return View of the _size1 entries of column c
+        */
+        VectorView<T> column(size_t c){
+
+            BAROP_CHECK_INDEX(c < _size2, "Matrix::column");
+            return VectorView<T>(_matrix + c, _size1, _size2);
+        };
+
+        /**
+        * Member function returning a read-only strided view of a column.
+        * @param c Column index, checked only if BAROP_BOUNDS_CHECK is enabled
+        * @return View of the _size1 entries of column c
+        */
+        VectorView<const T> column(size_t c) const{
+
+            BAROP_CHECK_INDEX(c < _size2, "Matrix::column");
+            return VectorView<const T>(_matrix + c, _size1, _size2);
+        };
+
         /**
         * Member function for operator = .
         * Deep copies matrices.
@@ -123,36 +337,94 @@ class Matrix {
         Matrix<T>& operator=(const Matrix& M);
 
         /**
-        * Member function for operator + .
-        * Allows for adding matrices.
-        * @param M2 Matrix that is to be added
-        * @return Resulting matrix
+        * Member function for move operator = .
+        * Takes over the storage buffer without copying, M is left as an empty 0x0 matrix.
+        * @param M Matrix whose storage is taken over
+        * @return Reference to this matrix
+        */
+        Matrix<T>& operator=(Matrix&& M) noexcept;
+
+        /**
+        * Member function for swapping the contents of two matrices.
+        * Only the sizes and the buffer pointers are exchanged.
+        * @param M Matrix to swap with
+        */
+        void swap(Matrix& M) noexcept;
+
+        /**
+        * Matrix class constructor.
+        * Evaluates a matrix expression, e.g. Matrix<double> C = A + 2.0*B;
+        * Element-wise parts are computed in a single pass, products by the blocked GEMM kernel.
+        * Sums, differences, scalar multiples and products of matrices are expressions, see MatrixExpression.h
+        * @param expr Matrix expression
+        */
+        template<typename E>
+        Matrix(const MatrixExpr<E>& expr);
+
+        /**
+        * Member function for assigning a matrix expression.
+        * The buffer is reused when it is large enough. Expressions reading this matrix are safe,
+        * transposes and products of it are evaluated into a temporary first.
+        * @param expr Matrix expression
+        * @return Reference to this matrix
+        */
+        template<typename E>
+        Matrix<T>& operator=(const MatrixExpr<E>& expr);
+
+        /**
+        * Member function for adding a matrix expression in place, e.g. K += Ke; or C += A*B;
+        * @param expr Matrix expression of the same size
+        * @return Reference to this matrix
+        */
+        template<typename E>
+        Matrix<T>& operator+=(const MatrixExpr<E>& expr);
+
+        /**
+        * Member function for subtracting a matrix expression in place.
+        * @param expr Matrix expression of the same size
+        * @return Reference to this matrix
+        */
+        template<typename E>
+        Matrix<T>& operator-=(const MatrixExpr<E>& expr);
+
+        /**
+        * Matrix expression interface, see MatrixExpr.
+        */
+        using value_type = T;
+        static constexpr bool isLeaf = true;
+        static constexpr bool isLinear = true;
+        static constexpr bool hasProduct = false;
+
+        /**
+        * Member function for finding the number of rows without allocating.
+        * @return Number of rows
+        */
+        size_t rows() const {return _size1;};
+
+        /**
+        * Member function for finding the number of columns without allocating.
+        * @return Number of columns
         */
-        Matrix<T> operator+(const Matrix<T>& M2) const;
+        size_t cols() const {return _size2;};
 
         /**
-        * Member function for operator -.
-        * Allows for subtracting matrices.
-        * @param M2 Matrix that is to be subtracted
-        * @return Resulting matrix
+        * Member function for reading an entry inside expressions, unchecked.
+        * @param i Row index
+        * @param j Column index
         */
-        Matrix<T> operator-(const Matrix<T>& M2) const;
+        T coeff(size_t i, size_t j) const {return _matrix[i*_size2 + j];};
 
         /**
-        * Member function for operator * overloading.
-        * Allows for multiplying matrices.
-        * @param M2 Matrix that is to be multiplied from right
-        * @return Resulting matrix
+        * Member function for reading an entry by its row-major index inside expressions, unchecked.
+        * @param k Row-major index
         */
-        Matrix<T> operator*(const Matrix<T>& M2) const;
+        T coeff(size_t k) const {return _matrix[k];};
 
         /**
-        * Member function for operator * overloading.
-        * Allows for multiplying matrices with scalars.
-        * @param scalar Scalar that is to be multiplied
-        * @return Resulting matrix
+        * Member function checking whether the storage of an expression destination is this matrix.
+        * @param p Storage of the destination
         */
-        Matrix<T> operator*(T scalar) const;
+        bool aliases(const T* p) const {return p != nullptr && p == _matrix;};
 
         /**
         * Member function for transposing a matrix.
@@ -191,6 +463,13 @@ class Matrix {
         */
         void deleteColumns(std::vector<size_t>& c);
 
+        /**
+        * Member function for deleting the same rows and columns of a square matrix.
+        * Compacts the buffer in a single pass, no reallocation.
+        * @param rc Vector of row/column indices to be deleted
+        */
+        void deleteRowsColumns(std::vector<size_t>& rc);
+
         /**
         * Member function for computing matrix vector multiplication.
         * @param vec Vector that is wanted to be multiplied from right
@@ -200,51 +479,141 @@ class Matrix {
 
         /**
         * Member function for computing complete Cholesky decompositon.
-        * Handy for SPD systems. Uses Cholesky–Banachiewicz algorithm
+        * Handy for SPD systems. Right-looking blocked algorithm built on the TRSM and SYRK kernels,
+        * diagonal blocks use the Cholesky–Banachiewicz algorithm
         * @return Lower triangle matrix
         */
         Matrix<T> cho() const;
 
+        /**
+        * Member function for the rank-1 update of a Cholesky factor.
+        * The matrix is treated as the lower triangular factor L returned by cho(),
+        * it is overwritten by the factor of L*L^T + x*x^T in O(n^2) operations.
+        * @param x Update vector
+        */
+        void choUpdate(std::vector<T> x);
+
+        /**
+        * Member function for the rank-1 downdate of a Cholesky factor.
+        * The matrix is overwritten by the factor of L*L^T - x*x^T in O(n^2) operations.
+        * Throws std::runtime_error if the result is not positive definite or numerically singular.
+        * @param x Downdate vector
+        */
+        void choDowndate(std::vector<T> x);
+
+        /**
+        * Member function for the rank-k update of a Cholesky factor, L*L^T + X*X^T.
+        * @param X Update matrix, one update vector per column
+        */
+        void choRankUpdate(const Matrix<T>& X);
+
+        /**
+        * Member function for the rank-k downdate of a Cholesky factor, L*L^T - X*X^T.
+        * @param X Downdate matrix, one downdate vector per column
+        */
+        void choRankDowndate(const Matrix<T>& X);
+
         /**
         * Member function for computing inverse of a lower triangular matrix.
         * Used to solve the finite element linear system of equations. Banachiewicz inversion
         * @return Inverse of the lower triangular matrix.
         */
         Matrix<T> L_inverse() const;
+
+        /**
+        * Member function for solving L*x = b by forward substitution.
+        * The matrix is treated as lower triangular, its upper triangle is not read.
+        * @param b Right hand side vector
+        * @return Solution vector x
+        */
+        std::vector<T> forwardSubstitution(const std::vector<T>& b) const;
+
+        /**
+        * Member function for solving U*x = b by backward substitution.
+        * The matrix is treated as upper triangular, its lower triangle is not read.
+        * @param b Right hand side vector
+        * @return Solution vector x
+        */
+        std::vector<T> backwardSubstitution(const std::vector<T>& b) const;
+
+        /**
+        * Member function for solving L^T*x = b by backward substitution.
+        * The matrix is treated as lower triangular, L^T is never formed.
+        * Together with cho() and forwardSubstitution() it solves SPD systems without any inverse.
+        * @param b Right hand side vector
+        * @return Solution vector x
+        */
+        std::vector<T> transposedBackwardSubstitution(const std::vector<T>& b) const;
+
+        /**
+        * Member function for solving L*X = B for many right hand sides at once.
+        * Each column of B is one right hand side, rows of X are updated as contiguous blocks.
+        * @param B Right hand side matrix of size rows x number of right hand sides
+        * @return Solution matrix X
+        */
+        Matrix<T> blockForwardSubstitution(const Matrix<T>& B) const;
+
+        /**
+        * Member function for solving L^T*X = B for many right hand sides at once.
+        * Each column of B is one right hand side, rows of X are updated as contiguous blocks.
+        * @param B Right hand side matrix of size rows x number of right hand sides
+        * @return Solution matrix X
+        */
+        Matrix<T> blockTransposedBackwardSubstitution(const Matrix<T>& B) const;
+
+        /**
+        * Member function returning the row-major storage.
+        * @return Pointer to the first entry, entry (r,c) is at r*columns + c
+        */
+        T* data() {return _matrix;};
+
+        /**
+        * Member function returning the row-major storage for reading.
+        * @return Pointer to the first entry, entry (r,c) is at r*columns + c
+        */
+        const T* data() const {return _matrix;};
 };
 
 template<typename T>
-int Matrix<T>::allocations = 0;
+std::atomic<int> Matrix<T>::allocations{0};
 
 // TEMPLATE DEFINITIONS, ONLY-HEADER FILE IMPLEMENTATION!
 
 template<typename T>
-Matrix<T>::Matrix() : _matrix(nullptr), _size1(0), _size2(0){};
+T* Matrix<T>::allocate(size_t n){
+
+    if (n == 0) return nullptr;
+
+    T* p = static_cast<T*>(::operator new[](n*sizeof(T), _alignment));
+    std::uninitialized_default_construct_n(p, n);
+    allocations++;
+    return p;
+};
 
 template<typename T>
-Matrix<T>::Matrix(const size_t& r,const size_t& c) : _size1(r), _size2(c){
+void Matrix<T>::deallocate(T* p, size_t n){
 
-    _matrix = new T*[_size1];
-    for (size_t i = 0; i < _size1; ++i){
-      _matrix[i] = new T[_size2];
-      allocations++;
-    };
+    if (p == nullptr) return;
+
+    std::destroy_n(p, n);
+    ::operator delete[](p, _alignment);
+    allocations--;
 };
 
 template<typename T>
-Matrix<T>::Matrix(const size_t& r,const size_t& c, T value) : _size1(r), _size2(c){
+Matrix<T>::Matrix() : _size1(0), _size2(0), _capacity(0), _matrix(nullptr){};
 
-    _matrix = new T*[_size1];
-    for (size_t i = 0; i < _size1; ++i){
-      _matrix[i] = new T[_size2];
-      allocations++;
-    };
+template<typename T>
+Matrix<T>::Matrix(const size_t& r,const size_t& c) : _size1(r), _size2(c), _capacity(r*c){
 
-    for (size_t i = 0; i < _size1; ++i){
-        for (size_t j = 0; j < _size2; ++j){
-            _matrix[i][j] = value;
-        }
-    }
+    _matrix = allocate(_capacity);
+};
+
+template<typename T>
+Matrix<T>::Matrix(const size_t& r,const size_t& c, T value) : _size1(r), _size2(c), _capacity(r*c){
+
+    _matrix = allocate(_capacity);
+    std::fill(_matrix, _matrix + _capacity, value);
 };
 
 template<typename T>
@@ -253,49 +622,42 @@ Matrix<T>::Matrix(std::initializer_list<std::initializer_list<T>> init){
     _size1 = init.size();
     _size2 = init.begin()->size();
 
-    size_t m = 0;
     for (const auto& row : init) {
         if (row.size() != _size2)
             throw std::runtime_error("Rows must all have equal size");
-        m++;
     }
 
-    _matrix = new T*[_size1];
-    for (size_t i = 0; i < _size1; ++i){
-      _matrix[i] = new T[_size2];
-      allocations++;
-    };
+    _capacity = _size1*_size2;
+    _matrix = allocate(_capacity);
 
     size_t i = 0;
-        for (const auto& row : init) {
-
-            size_t j = 0;
-            for (const auto& value : row) {
-                _matrix[i][j++] = value;
-            }
-            i++;
-        }
+    for (const auto& row : init) {
+        std::copy(row.begin(), row.end(), _matrix + i*_size2);
+        i++;
+    }
 };
 
 template<typename T>
 Matrix<T>::Matrix(const Matrix& M)
-    : _size1(M._size1), _size2(M._size2)
+    : _size1(M._size1), _size2(M._size2), _capacity(M._size1*M._size2)
 {
-    _matrix = new T*[_size1];
-    for (size_t i = 0; i < _size1; ++i) {
-        _matrix[i] = new T[_size2];
-        std::copy(M._matrix[i], M._matrix[i] + _size2, _matrix[i]);
-        allocations++;
-    }
+    _matrix = allocate(_capacity);
+    std::copy(M._matrix, M._matrix + _capacity, _matrix);
+}
+
+template<typename T>
+Matrix<T>::Matrix(Matrix&& M) noexcept
+    : _size1(M._size1), _size2(M._size2), _capacity(M._capacity), _matrix(M._matrix)
+{
+    M._size1 = 0;
+    M._size2 = 0;
+    M._capacity = 0;
+    M._matrix = nullptr;
 }
 
 template<typename T>
 Matrix<T>::~Matrix() {
-    for (size_t i = 0; i < _size1; ++i){
-        delete[] _matrix[i];
-        allocations--;
-    };
-    delete[] _matrix;
+    deallocate(_matrix, _capacity);
 }
 
 template<typename T>
@@ -317,7 +679,7 @@ T& Matrix<T>::operator()(const size_t& r, const size_t& c){
         throw std::out_of_range("Index is out of range!");
     };
 
-    return _matrix[r][c];
+    return _matrix[r*_size2 + c];
 };
 
 template<typename T>
@@ -328,7 +690,7 @@ const T& Matrix<T>::operator()(const size_t& r, const size_t& c)const{
         throw std::out_of_range("Index is out of range!");
     };
 
-    return _matrix[r][c];
+    return _matrix[r*_size2 + c];
 };
 
 template<typename T>
@@ -336,25 +698,61 @@ Matrix<T>& Matrix<T>::operator=(const Matrix& M)
 {
     if (this == &M) return *this;
 
-    // free old memory
-    for (size_t i = 0; i < _size1; ++i){
-        delete[] _matrix[i];
-        allocations--;
+    size_t n = M._size1*M._size2;
+
+    // reuse the buffer when it is large enough
+    if (n > _capacity){
+        T* newMatrix = allocate(n);
+        deallocate(_matrix, _capacity);
+        _matrix = newMatrix;
+        _capacity = n;
     }
-    delete[] _matrix;
 
-    // allocate new
     _size1 = M._size1;
     _size2 = M._size2;
-    _matrix = new T*[_size1];
-    for (size_t i = 0; i < _size1; ++i) {
-        _matrix[i] = new T[_size2];
-        std::copy(M._matrix[i], M._matrix[i] + _size2, _matrix[i]);
-        allocations++;
-    }
+    std::copy(M._matrix, M._matrix + n, _matrix);
+
     return *this;
 };
 
+template<typename T>
+Matrix<T>& Matrix<T>::operator=(Matrix&& M) noexcept
+{
+    if (this == &M) return *this;
+
+    deallocate(_matrix, _capacity);
+
+    _size1 = M._size1;
+    _size2 = M._size2;
+    _capacity = M._capacity;
+    _matrix = M._matrix;
+
+    M._size1 = 0;
+    M._size2 = 0;
+    M._capacity = 0;
+    M._matrix = nullptr;
+
+    return *this;
+};
+
+template<typename T>
+void Matrix<T>::swap(Matrix& M) noexcept{
+
+    std::swap(_size1, M._size1);
+    std::swap(_size2, M._size2);
+    std::swap(_capacity, M._capacity);
+    std::swap(_matrix, M._matrix);
+};
+
+/**
+ * Non-member swap so that std algorithms and ADL pick up the cheap Matrix swap.
+ */
+template<typename T>
+void swap(Matrix<T>& A, Matrix<T>& B) noexcept{
+
+    A.swap(B);
+};
+
 template<typename T>
 void Matrix<T>::printOut() const{
 
@@ -362,7 +760,7 @@ void Matrix<T>::printOut() const{
     for (size_t i = 0; i < _size1; ++i){
         if(i != 0) std::cout << " ";
         for (size_t j = 0; j < _size2; ++j){
-            std::cout << _matrix[i][j];
+            std::cout << _matrix[i*_size2 + j];
            if(i != _size1-1 || j !=_size2-1) std::cout << ", ";
         }
         if (i != _size1-1){std::cout << '\n';};
@@ -371,78 +769,245 @@ void Matrix<T>::printOut() const{
 };
 
 template<typename T>
-Matrix<T> Matrix<T>::operator+(const Matrix<T>& M2) const{
-    if (_size1 != M2._size1 || _size2 != M2._size2){
+template<typename E>
+Matrix<T>::Matrix(const MatrixExpr<E>& expr)
+    : _size1(expr.derived().rows()), _size2(expr.derived().cols()), _capacity(_size1*_size2)
+{
+    _matrix = allocate(_capacity);
+    if constexpr (E::hasProduct){
+        std::fill(_matrix, _matrix + _capacity, T{0});
+        addExpression(*this, expr.derived(), T{1});
+    }
+    else {
+        assignExpression(_matrix, expr.derived());
+    };
+};
+
+template<typename T>
+template<typename E>
+Matrix<T>& Matrix<T>::operator=(const MatrixExpr<E>& expr){
 
-            throw std::invalid_argument("Matrices have inequal sizes!");
+    const E& e = expr.derived();
+
+    // element-wise expressions read entry k before it is written, anything else needs a temporary
+    if (!E::isLinear && e.aliases(_matrix)){
+        Matrix<T> result(e);
+        this->swap(result);
+        return *this;
     };
 
-    Matrix<T> M3(_size1, _size2, T{0});
-    for (size_t i = 0; i < _size1; ++i){
-        for (size_t j = 0; j < _size2; ++j){
+    const size_t n = e.rows()*e.cols();
+    if (n > _capacity){
+        T* newMatrix = allocate(n);
+        deallocate(_matrix, _capacity);
+        _matrix = newMatrix;
+        _capacity = n;
+    };
+    _size1 = e.rows();
+    _size2 = e.cols();
 
-            M3(i,j) = (*this)(i,j) + M2(i,j);
+    if constexpr (E::hasProduct){
+        std::fill(_matrix, _matrix + n, T{0});
+        addExpression(*this, e, T{1});
+    }
+    else {
+        assignExpression(_matrix, e);
+    };
+    return *this;
+};
 
-        };
+template<typename T>
+template<typename E>
+Matrix<T>& Matrix<T>::operator+=(const MatrixExpr<E>& expr){
+
+    const E& e = expr.derived();
+    if (e.rows() != _size1 || e.cols() != _size2){
+        throw std::invalid_argument("Matrices have inequal sizes! (operator+=)");
     };
 
-    return M3;
+    if (!E::isLinear && e.aliases(_matrix)){
+        addExpression(*this, Matrix<T>(e), T{1});
+    }
+    else {
+        addExpression(*this, e, T{1});
+    };
+    return *this;
 };
 
 template<typename T>
-Matrix<T> Matrix<T>::operator-(const Matrix<T>& M2) const{
+template<typename E>
+Matrix<T>& Matrix<T>::operator-=(const MatrixExpr<E>& expr){
 
-    if (_size1 != M2._size1 || _size2 != M2._size2){
+    const E& e = expr.derived();
+    if (e.rows() != _size1 || e.cols() != _size2){
+        throw std::invalid_argument("Matrices have inequal sizes! (operator-=)");
+    };
 
-            throw std::invalid_argument("Matrices have inequal sizes! (operator-)");
+    if (!E::isLinear && e.aliases(_matrix)){
+        addExpression(*this, Matrix<T>(e), T{-1});
+    }
+    else {
+        addExpression(*this, e, T{-1});
     };
+    return *this;
+};
 
-    Matrix<T> M3(_size1, _size2, T{0});
+template<typename T>
+void Matrix<T>::tile(size_t k, const T* A, size_t rsa, size_t csa, const T* B, size_t ldb, T* acc){
 
-    for (size_t i = 0; i < _size1; ++i){
-        for (size_t j = 0; j < _size2; ++j){
+    T c[_tileRows][_tileCols] = {};
 
-            M3(i,j) = (*this)(i,j) - M2(i,j);
+    for (size_t p = 0; p < k; ++p){
+        const T* Bp = B + p*ldb;
+        for (size_t r = 0; r < _tileRows; ++r){
+            const T a = A[r*rsa + p*csa];
+            for (size_t j = 0; j < _tileCols; ++j){
+                c[r][j] += a*Bp[j];
+            };
         };
     };
 
-    return M3;
+    for (size_t r = 0; r < _tileRows; ++r){
+        for (size_t j = 0; j < _tileCols; ++j){
+            acc[r*_tileCols + j] = c[r][j];
+        };
+    };
 };
 
 template<typename T>
-Matrix<T> Matrix<T>::operator*(const Matrix<T>& M2) const{
+void Matrix<T>::gemm(size_t m, size_t n, size_t k, const T* A, size_t rsa, size_t csa,
+                     const T* B, size_t ldb, T* C, size_t ldc, T alpha){
+
+    // a _block x (4*_block) tile of B stays in cache while all rows of A stream past it,
+    // inside it register tiles of C are accumulated over the whole k range of the tile
+    const size_t kb = _block;
+    const size_t nb = 4*_block;
+    const size_t mr = _tileRows;
+    const size_t nr = _tileCols;
+    T acc[_tileRows*_tileCols];
+
+    for (size_t j0 = 0; j0 < n; j0 += nb){
+        const size_t j1 = std::min(j0 + nb, n);
+        for (size_t k0 = 0; k0 < k; k0 += kb){
+            const size_t k1 = std::min(k0 + kb, k);
+
+            size_t i = 0;
+            for (; i + mr <= m; i += mr){
+                size_t j = j0;
+                for (; j + nr <= j1; j += nr){
+                    tile(k1 - k0, A + i*rsa + k0*csa, rsa, csa, B + k0*ldb + j, ldb, acc);
+                    for (size_t r = 0; r < mr; ++r){
+                        T* Cr = C + (i + r)*ldc + j;
+                        for (size_t c = 0; c < nr; ++c) Cr[c] += alpha*acc[r*nr + c];
+                    };
+                };
+                // remaining columns
+                for (size_t r = i; r < i + mr; ++r){
+                    T* Cr = C + r*ldc;
+                    for (size_t p = k0; p < k1; ++p){
+                        const T a = alpha*A[r*rsa + p*csa];
+                        const T* Bp = B + p*ldb;
+                        for (size_t jj = j; jj < j1; ++jj) Cr[jj] += a*Bp[jj];
+                    };
+                };
+            };
+            // remaining rows
+            for (; i < m; ++i){
+                T* Ci = C + i*ldc;
+                for (size_t p = k0; p < k1; ++p){
+                    const T a = alpha*A[i*rsa + p*csa];
+                    const T* Bp = B + p*ldb;
+                    for (size_t j = j0; j < j1; ++j) Ci[j] += a*Bp[j];
+                };
+            };
+        };
+    };
+};
 
-    if (_size2 != M2._size1){
-        throw std::runtime_error("Sizes don't match! (operator * )");
+template<typename T>
+void Matrix<T>::syrk(size_t m, size_t k, const T* A, size_t lda, T* C, size_t ldc){
+
+    // W = A^T, row p of W holds column p of A contiguously
+    std::vector<T> W(k*m);
+    for (size_t i = 0; i < m; ++i){
+        for (size_t p = 0; p < k; ++p){
+            W[p*m + i] = A[i*lda + p];
+        };
     };
 
-    Matrix<T> result(_size1, M2._size2, T{0});
+    const size_t mr = _tileRows;
+    const size_t nr = _tileCols;
 
-    for (size_t i = 0; i < result._size1; ++i){
-        for (size_t j = 0; j < result._size2; ++j){
+    // one task per block of _block rows, the tiling inside a row does not depend on the split
+    parallelFor((m + _block - 1)/_block, [&](size_t t){
 
-            T sum {0};
-            for (size_t m = 0; m < _size2; ++m){
+        const size_t i0 = t*_block;
+        const size_t i1 = std::min(i0 + _block, m);
+        T acc[_tileRows*_tileCols];
 
-                sum +=  _matrix[i][m] * M2(m,j);
+        size_t i = i0;
+        for (; i + mr <= i1; i += mr){
+            // full register tiles left of the diagonal
+            size_t j = 0;
+            for (; j + nr <= i + 1; j += nr){
+                tile(k, A + i*lda, lda, 1, W.data() + j, m, acc);
+                for (size_t r = 0; r < mr; ++r){
+                    T* Cr = C + (i + r)*ldc + j;
+                    for (size_t c = 0; c < nr; ++c) Cr[c] -= acc[r*nr + c];
+                };
+            };
+            // the diagonal part of each row
+            for (size_t r = i; r < i + mr; ++r){
+                const T* Ar = A + r*lda;
+                T* Cr = C + r*ldc;
+                for (size_t p = 0; p < k; ++p){
+                    axpy(-Ar[p], W.data() + p*m + j, Cr + j, r + 1 - j);
+                };
             };
-            result(i,j)= sum;
         };
-    };
+        for (; i < i1; ++i){
+            const T* Ai = A + i*lda;
+            T* Ci = C + i*ldc;
+            for (size_t p = 0; p < k; ++p){
+                axpy(-Ai[p], W.data() + p*m, Ci, i + 1);
+            };
+        };
+    });
+};
 
-    return result;
+template<typename T>
+void Matrix<T>::trsm(size_t m, size_t k, const T* L, size_t ldl, T* B, size_t ldb){
+
+    // each row x of B solves x*L^T = b, i.e. a forward substitution with L, rows are independent
+    parallelFor((m + _block - 1)/_block, [&](size_t t){
+        const size_t i1 = std::min((t + 1)*_block, m);
+        for (size_t i = t*_block; i < i1; ++i){
+            T* Bi = B + i*ldb;
+            for (size_t j = 0; j < k; ++j){
+                const T* Lj = L + j*ldl;
+                Bi[j] = (Bi[j] - dotProduct(Lj, Bi, j))/Lj[j];
+            };
+        };
+    });
 };
 
 template<typename T>
-Matrix<T> Matrix<T>::operator*(T scalar) const{
+void Matrix<T>::choBlock(size_t n, T* A, size_t lda){
 
-    Matrix<T> result(*this);
-    for (size_t i = 0; i < _size1; ++i){
-        for (size_t j = 0; j < _size2; ++j){
-          result(i,j) = (*this)(i,j) * scalar;
+    // Cholesky-Banachiewicz on the lower triangle, entries are overwritten after their last read
+    for (size_t i = 0; i < n; ++i){
+        T* Li = A + i*lda;
+        for (size_t j = 0; j <= i; ++j){
+            const T* Lj = A + j*lda;
+            const T sum = dotProduct(Lj, Li, j);
+            if (i == j){
+                Li[j] = std::sqrt(Li[j] - sum);
+            }
+            else {
+                Li[j] = (Li[j] - sum)/Lj[j];
+            };
         };
     };
-    return result;
 };
 
 template<typename T>
@@ -450,16 +1015,8 @@ void Matrix<T>::deleteRow(size_t r) {
     if (r >= _size1)
         throw std::out_of_range("Row index out of range! (deleteRow)");
 
-    // Delete row
-    delete[] _matrix[r];
-    allocations--;
-
-    // Shift remaining row pointers up
-    for (size_t i = r; i < _size1 - 1; ++i)
-        _matrix[i] = _matrix[i + 1];
-
-    // Set the last pointer to nullptr
-    _matrix[_size1 - 1] = nullptr;
+    // Shift remaining rows up, the buffer is kept
+    std::copy(_matrix + (r+1)*_size2, _matrix + _size1*_size2, _matrix + r*_size2);
 
     // Reduce the number of rows
     --_size1;
@@ -494,27 +1051,23 @@ void Matrix<T>::deleteRows(std::vector<size_t>& r){
 template<typename T>
 void Matrix<T>::addRows(Matrix<T>& r){
 
-    if (r.getSize()[1] != _size2){
+    if (r._size2 != _size2){
       throw std::invalid_argument("Given row size do not match with original matrix! (addrows)");
     };
 
-    size_t newSize = _size1+r.getSize()[0];
-    Matrix<T> newMatrix(newSize,_size2);
+    size_t oldCount = _size1*_size2;
+    size_t addCount = r._size1*r._size2;
+    size_t newCapacity = oldCount + addCount;
 
-    for (size_t i = 0; i < _size1; ++i){
-        for (size_t j = 0; j < _size2; ++j){
-
-            newMatrix(i,j) = (*this)(i,j);
-        };
-    };
-
-    for (size_t k = _size1; k < newSize; ++k){
-        for (size_t m = 0; m < r.getSize()[1]; ++m){
-        newMatrix(k,m) = r(k-_size1,m);
-        };
-    };
+    // r may be *this, so copy into a fresh buffer before releasing the old one
+    T* newMatrix = allocate(newCapacity);
+    std::copy(_matrix, _matrix + oldCount, newMatrix);
+    std::copy(r._matrix, r._matrix + addCount, newMatrix + oldCount);
 
-    *this = newMatrix;
+    deallocate(_matrix, _capacity);
+    _matrix = newMatrix;
+    _capacity = newCapacity;
+    _size1 += r._size1;
 };
 
 
@@ -525,21 +1078,16 @@ void Matrix<T>::deleteColumn(size_t c){
         throw std::out_of_range("Given index is out of range! (deleteColumn)");
     };
 
+    // Compact the buffer in place in a single forward pass
+    size_t w = 0;
     for (size_t i = 0; i < _size1; ++i){
-
-        T* newRow = new T[_size2 - 1];
-        allocations++;
-
-        for (size_t j = 0, nj = 0; j < _size2; ++j){
+        for (size_t j = 0; j < _size2; ++j){
 
             if (j != c){
 
-                newRow[nj++] = _matrix[i][j];
+                _matrix[w++] = _matrix[i*_size2 + j];
             };
         };
-        delete[] _matrix[i];
-        allocations--;
-        _matrix[i] = newRow;
     };
     --_size2;
 };
@@ -569,6 +1117,46 @@ void Matrix<T>::deleteColumns(std::vector<size_t>& c){
     };
 };
 
+template<typename T>
+void Matrix<T>::deleteRowsColumns(std::vector<size_t>& rc){
+
+    if (_size1 != _size2){
+        throw std::invalid_argument("Given matrix is not square! (deleteRowsColumns)");
+    };
+
+    std::sort(rc.begin(), rc.end());
+    rc.erase(std::unique(rc.begin(), rc.end()), rc.end());
+
+    if (!rc.empty() && rc.back() >= _size1){
+        throw std::out_of_range("Row/column index out of range! (deleteRowsColumns)");
+    };
+
+    // indices that are kept, ascending
+    std::vector<size_t> keep;
+    keep.reserve(_size1 - rc.size());
+    for (size_t i = 0, d = 0; i < _size1; ++i){
+        if (d < rc.size() && rc[d] == i){
+            ++d;
+        }
+        else {
+            keep.push_back(i);
+        };
+    };
+
+    // every entry moves to a lower or equal position, so a forward pass is safe
+    const size_t n = keep.size();
+    for (size_t i = 0; i < n; ++i){
+        const T* src = _matrix + keep[i]*_size2;
+        T* dst = _matrix + i*n;
+        for (size_t j = 0; j < n; ++j){
+            dst[j] = src[keep[j]];
+        };
+    };
+
+    _size1 = n;
+    _size2 = n;
+};
+
 template<typename T>
 std::vector<T> Matrix<T>::mVm(const std::vector<T>& vec) const{
 
@@ -580,12 +1168,7 @@ std::vector<T> Matrix<T>::mVm(const std::vector<T>& vec) const{
     std::vector<T> result(_size1,T{0});
 
     for (size_t i = 0; i < _size1; ++i){
-        T sum {0};
-        for (size_t j = 0; j < _size2; ++j){
-
-         sum += _matrix[i][j] * vec[j];
-        };
-        result[i] = sum;
+        result[i] = dotProduct(_matrix + i*_size2, vec.data(), _size2);
     };
 
     return result;
@@ -594,11 +1177,19 @@ std::vector<T> Matrix<T>::mVm(const std::vector<T>& vec) const{
 template<typename T>
 Matrix<T>  Matrix<T>::transpose() const{
 
-    Matrix<T> t(_size2, _size1, T{0});
-
-    for (size_t i = 0; i < _size2; ++i){
-        for (size_t j = 0; j < _size1; ++j){
-            t(i,j) = _matrix[j][i];
+    Matrix<T> t(_size2, _size1);
+
+    // Tiled copy so that both the reads and the writes stay within a few cache lines
+    const size_t tile = 32;
+    for (size_t ii = 0; ii < _size1; ii += tile){
+        size_t iEnd = std::min(ii + tile, _size1);
+        for (size_t jj = 0; jj < _size2; jj += tile){
+            size_t jEnd = std::min(jj + tile, _size2);
+            for (size_t i = ii; i < iEnd; ++i){
+                for (size_t j = jj; j < jEnd; ++j){
+                    t._matrix[j*_size1 + i] = _matrix[i*_size2 + j];
+                };
+            };
         };
     };
 
@@ -612,60 +1203,279 @@ Matrix<T> Matrix<T>::cho() const{
         throw std::invalid_argument("Given matrix is not square! (cho)");
     };
 
-    Matrix<T> L(_size1,_size2,T{0});
+    const size_t n = _size1;
+    Matrix<T> L(*this);
+    T* a = L._matrix;
 
-    for (size_t i = 0; i < _size1; ++i){
-        for (size_t j = 0; j <= i; ++j){
-            T sum{0};
-            for (size_t k = 0; k < j; ++k){
-                sum += L(j,k)*L(i,k);
-            };
-               if(i==j){
-                   L(j,j) = std::sqrt(_matrix[j][j]-sum);
-               }
-               else{
-                 L(i,j) = (_matrix[i][j]-sum)/L(j,j);
-               };
+    // right-looking blocked factorization: diagonal block, panel below it, trailing update
+    for (size_t k0 = 0; k0 < n; k0 += _block){
 
-        };
+        const size_t kb = std::min(_block, n - k0);
+        T* A11 = a + k0*n + k0;
+        choBlock(kb, A11, n);
+
+        const size_t m = n - k0 - kb;
+        if (m == 0) break;
+
+        T* A21 = a + (k0 + kb)*n + k0;
+        T* A22 = a + (k0 + kb)*n + (k0 + kb);
+        trsm(m, kb, A11, n, A21, n);
+        syrk(m, kb, A21, n, A22, n);
+    };
+
+    // only the lower triangle was referenced
+    for (size_t i = 0; i < n; ++i){
+        std::fill(a + i*n + i + 1, a + (i+1)*n, T{0});
     };
 
     return L;
 };
 
+template<typename T>
+void Matrix<T>::choRankOne(std::vector<T>& x, int sign, const char* caller){
+
+    if (_size1 != _size2){
+        throw std::invalid_argument(std::string("Given triangular matrix is not square! (") + caller + ")");
+    };
+    if (_size1 != x.size()){
+        throw std::invalid_argument(std::string("Matrix-vector sizes don't match! (") + caller + ")");
+    };
+
+    const size_t n = _size1;
+
+    // sequence of Givens (update) or hyperbolic (downdate) rotations, column by column
+    for (size_t k = 0; k < n; ++k){
+
+        if (x[k] == T{0}) continue;
+
+        T& lkk = _matrix[k*n + k];
+        T r2 = lkk*lkk + sign*x[k]*x[k];
+
+        // a downdate that cancels the pivot down to rounding error leaves a singular matrix
+        if (!(r2 > ((sign < 0) ? T(1E-10)*lkk*lkk : T{0}))){
+            throw std::runtime_error(std::string("Downdated matrix is not positive definite! (") + caller + ")");
+        };
+
+        T r = std::sqrt(r2);
+        T c = r/lkk;
+        T s = x[k]/lkk;
+        lkk = r;
+
+        for (size_t i = k+1; i < n; ++i){
+            T& lik = _matrix[i*n + k];
+            lik = (lik + sign*s*x[i])/c;
+            x[i] = c*x[i] - s*lik;
+        };
+    };
+};
+
+template<typename T>
+void Matrix<T>::choUpdate(std::vector<T> x){
+
+    choRankOne(x, 1, "Matrix::choUpdate");
+};
+
+template<typename T>
+void Matrix<T>::choDowndate(std::vector<T> x){
+
+    choRankOne(x, -1, "Matrix::choDowndate");
+};
+
+template<typename T>
+void Matrix<T>::choRankUpdate(const Matrix<T>& X){
+
+    if (X._size1 != _size1){
+        throw std::invalid_argument("Matrix sizes don't match! (Matrix::choRankUpdate)");
+    };
+
+    std::vector<T> x(_size1);
+    for (size_t j = 0; j < X._size2; ++j){
+        for (size_t i = 0; i < _size1; ++i) x[i] = X._matrix[i*X._size2 + j];
+        choRankOne(x, 1, "Matrix::choRankUpdate");
+    };
+};
+
+template<typename T>
+void Matrix<T>::choRankDowndate(const Matrix<T>& X){
+
+    if (X._size1 != _size1){
+        throw std::invalid_argument("Matrix sizes don't match! (Matrix::choRankDowndate)");
+    };
+
+    std::vector<T> x(_size1);
+    for (size_t j = 0; j < X._size2; ++j){
+        for (size_t i = 0; i < _size1; ++i) x[i] = X._matrix[i*X._size2 + j];
+        choRankOne(x, -1, "Matrix::choRankDowndate");
+    };
+};
+
 template<typename T>
 Matrix<T> Matrix<T>::L_inverse() const {
 
-    Matrix<T> L = *this;
-    if (L.getSize()[0] != L.getSize()[1]){
+    if (_size1 != _size2){
       throw std::invalid_argument("Given triangular matrix is not square! (Matrix::L_inverse)");
     }
-    for (size_t i = 0; i < L.getSize()[0]; ++i){
-        for (size_t j = 0; j < L.getSize()[1]; ++j){
-          if (j > i){
-            if (L(i,j) != 0){
+    const size_t n = _size1;
+    for (size_t i = 0; i < n; ++i){
+        VectorView<const T> Li = this->row(i);
+        for (size_t j = i+1; j < n; ++j){
+            if (Li[j] != 0){
                 throw std::invalid_argument("Given matrix is not triangular! (Matrix::L_inverse)");
             };
-          };
         };
     };
-    Matrix<T> M(L.getSize()[0], L.getSize()[1], T{0});
+    Matrix<T> M(n, n, T{0});
 
+    // column j of the inverse by forward substitution, rows of L are read contiguously
     T sum;
-    for (size_t j = 0; j < L.getSize()[0]; ++j){
-        M(j,j) = T{1}/L(j,j);
-        for (size_t i = j+1; i < L.getSize()[0]; ++i){
+    for (size_t j = 0; j < n; ++j){
+        M.unchecked(j,j) = T{1}/this->unchecked(j,j);
+        for (size_t i = j+1; i < n; ++i){
+         VectorView<const T> Li = this->row(i);
          sum = {0};
          for(size_t k = j; k < i; ++k){
 
-             sum += L(i,k)*M(k,j);
+             sum += Li[k]*M.unchecked(k,j);
          };
 
-         M(i,j) = -sum/L(i,i);
+         M.unchecked(i,j) = -sum/Li[i];
         };
     };
 
     return M;
 };
 
+template<typename T>
+std::vector<T> Matrix<T>::forwardSubstitution(const std::vector<T>& b) const{
+
+    if (_size1 != _size2){
+        throw std::invalid_argument("Given triangular matrix is not square! (forwardSubstitution)");
+    };
+    if (_size1 != b.size()){
+        throw std::invalid_argument("Matrix-vector sizes don't match! (forwardSubstitution)");
+    };
+
+    const size_t n = _size1;
+    std::vector<T> x(n);
+
+    for (size_t i = 0; i < n; ++i){
+        const T* Li = _matrix + i*n;
+        x[i] = (b[i] - dotProduct(Li, x.data(), i))/Li[i];
+    };
+
+    return x;
+};
+
+template<typename T>
+std::vector<T> Matrix<T>::backwardSubstitution(const std::vector<T>& b) const{
+
+    if (_size1 != _size2){
+        throw std::invalid_argument("Given triangular matrix is not square! (backwardSubstitution)");
+    };
+    if (_size1 != b.size()){
+        throw std::invalid_argument("Matrix-vector sizes don't match! (backwardSubstitution)");
+    };
+
+    const size_t n = _size1;
+    std::vector<T> x(n);
+
+    for (size_t i = n; i-- > 0;){
+        const T* Ui = _matrix + i*n;
+        x[i] = (b[i] - dotProduct(Ui+i+1, x.data()+i+1, n-i-1))/Ui[i];
+    };
+
+    return x;
+};
+
+template<typename T>
+std::vector<T> Matrix<T>::transposedBackwardSubstitution(const std::vector<T>& b) const{
+
+    if (_size1 != _size2){
+        throw std::invalid_argument("Given triangular matrix is not square! (transposedBackwardSubstitution)");
+    };
+    if (_size1 != b.size()){
+        throw std::invalid_argument("Matrix-vector sizes don't match! (transposedBackwardSubstitution)");
+    };
+
+    const size_t n = _size1;
+    std::vector<T> x(b);
+
+    // Column-oriented sweep: row i of L is column i of L^T, so memory is read contiguously
+    for (size_t i = n; i-- > 0;){
+        const T* Li = _matrix + i*n;
+        x[i] /= Li[i];
+        axpy(-x[i], Li, x.data(), i);
+    };
+
+    return x;
+};
+
+template<typename T>
+Matrix<T> Matrix<T>::blockForwardSubstitution(const Matrix<T>& B) const{
+
+    if (_size1 != _size2){
+        throw std::invalid_argument("Given triangular matrix is not square! (blockForwardSubstitution)");
+    };
+    if (_size1 != B._size1){
+        throw std::invalid_argument("Matrix sizes don't match! (blockForwardSubstitution)");
+    };
+
+    const size_t n = _size1;
+    const size_t m = B._size2;
+    Matrix<T> X(B);
+
+    // right-hand sides are independent, each task sweeps one fixed block of columns
+    parallelFor((m + _block - 1)/_block, [&](size_t t){
+        const size_t j0 = t*_block;
+        const size_t mc = std::min(_block, m - j0);
+        for (size_t i = 0; i < n; ++i){
+            const T* Li = _matrix + i*n;
+            T* Xi = X._matrix + i*m + j0;
+            for (size_t k = 0; k < i; ++k){
+                axpy(-Li[k], X._matrix + k*m + j0, Xi, mc);
+            };
+            const T inv = T{1}/Li[i];
+            for (size_t j = 0; j < mc; ++j){
+                Xi[j] *= inv;
+            };
+        };
+    });
+
+    return X;
+};
+
+template<typename T>
+Matrix<T> Matrix<T>::blockTransposedBackwardSubstitution(const Matrix<T>& B) const{
+
+    if (_size1 != _size2){
+        throw std::invalid_argument("Given triangular matrix is not square! (blockTransposedBackwardSubstitution)");
+    };
+    if (_size1 != B._size1){
+        throw std::invalid_argument("Matrix sizes don't match! (blockTransposedBackwardSubstitution)");
+    };
+
+    const size_t n = _size1;
+    const size_t m = B._size2;
+    Matrix<T> X(B);
+
+    // right-hand sides are independent, each task sweeps one fixed block of columns
+    parallelFor((m + _block - 1)/_block, [&](size_t t){
+        const size_t j0 = t*_block;
+        const size_t mc = std::min(_block, m - j0);
+        for (size_t i = n; i-- > 0;){
+            const T* Li = _matrix + i*n;
+            T* Xi = X._matrix + i*m + j0;
+            const T inv = T{1}/Li[i];
+            for (size_t j = 0; j < mc; ++j){
+                Xi[j] *= inv;
+            };
+            for (size_t k = 0; k < i; ++k){
+                axpy(-Li[k], Xi, X._matrix + k*m + j0, mc);
+            };
+        };
+    });
+
+    return X;
+};
+
 #endif
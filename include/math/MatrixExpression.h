@@ -0,0 +1,401 @@
+#ifndef MATRIXEXPRESSION_H
+#define MATRIXEXPRESSION_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "VectorKernels.h"
+
+/**
+ * Expression templates of the Matrix arithmetic.
+ * A + B, A - B, s*A, A.transposeView() and A*B build lightweight expression objects instead of matrices.
+ * Nothing is computed until the expression is assigned to a Matrix, then element-wise parts are
+ * evaluated in a single fused pass without temporaries and products go through the blocked GEMM kernel,
+ * accumulating straight into the destination with the scalar factors folded in.
+ * Operands that are matrices are held by reference, so expressions must not outlive them, e.g.
+ * store results as Matrix<T> X = A + B; and not as auto X = A + B;
+ * @see Matrix
+ */
+
+template<typename T>
+class Matrix;
+
+/**
+ * Templated class MatrixExpr.
+ * CRTP base of Matrix and of all expression nodes.
+ * A derived type E provides value_type, rows(), cols(), coeff(i,j), coeff(k) (row-major index,
+ * only if isLinear), aliases(p) and the flags isLeaf, isLinear and hasProduct.
+ */
+template<typename E>
+class MatrixExpr {
+
+    public:
+
+        /**
+        * Member function returning the derived expression.
+        */
+        const E& derived() const {return static_cast<const E&>(*this);};
+
+        /**
+        * Member function for reading one entry of the expression.
+        * Products compute the entry as a dot product, use eval() for repeated access.
+        * @param i Row index
+        * @param j Column index
+        */
+        auto operator()(size_t i, size_t j) const {return derived().coeff(i, j);};
+
+        /**
+        * Member function evaluating the expression.
+        * @return Matrix holding the result
+        */
+        auto eval() const {return Matrix<typename E::value_type>(derived());};
+
+        /**
+        * Member function returning a transposed view, no entries are copied.
+        * @return Lazy transpose of the expression
+        */
+        auto transposeView() const;
+};
+
+/**
+ * Operands of the expression nodes, matrices are held by reference and nodes by value.
+ */
+template<typename E>
+using MatrixExprOperand = std::conditional_t<E::isLeaf, const E&, const E>;
+
+/**
+ * Templated class MatrixSum.
+ * Lazy A + B (Sign = 1) or A - B (Sign = -1).
+ */
+template<typename L, typename R, int Sign>
+class MatrixSum : public MatrixExpr<MatrixSum<L,R,Sign>> {
+
+    private:
+
+        MatrixExprOperand<L> _l;
+        MatrixExprOperand<R> _r;
+
+    public:
+
+        using value_type = typename L::value_type;
+        static constexpr bool isLeaf = false;
+        static constexpr bool isLinear = L::isLinear && R::isLinear;
+        static constexpr bool hasProduct = L::hasProduct || R::hasProduct;
+
+        MatrixSum(const L& l, const R& r) : _l(l), _r(r){
+
+            if (l.rows() != r.rows() || l.cols() != r.cols()){
+                throw std::invalid_argument(Sign > 0 ? "Matrices have inequal sizes!"
+                                                     : "Matrices have inequal sizes! (operator-)");
+            };
+        };
+
+        size_t rows() const {return _l.rows();};
+        size_t cols() const {return _l.cols();};
+        value_type coeff(size_t i, size_t j) const {
+            return Sign > 0 ? _l.coeff(i, j) + _r.coeff(i, j) : _l.coeff(i, j) - _r.coeff(i, j);
+        };
+        value_type coeff(size_t k) const {
+            return Sign > 0 ? _l.coeff(k) + _r.coeff(k) : _l.coeff(k) - _r.coeff(k);
+        };
+        bool aliases(const value_type* p) const {return _l.aliases(p) || _r.aliases(p);};
+
+        void addTo(Matrix<value_type>& dst, value_type alpha) const;
+};
+
+/**
+ * Templated class MatrixScaled.
+ * Lazy s*A.
+ */
+template<typename E>
+class MatrixScaled : public MatrixExpr<MatrixScaled<E>> {
+
+    public:
+
+        using value_type = typename E::value_type;
+        static constexpr bool isLeaf = false;
+        static constexpr bool isLinear = E::isLinear;
+        static constexpr bool hasProduct = E::hasProduct;
+
+    private:
+
+        MatrixExprOperand<E> _e;
+        value_type _s;
+
+    public:
+
+        MatrixScaled(const E& e, value_type s) : _e(e), _s(s) {};
+
+        const E& expression() const {return _e;};
+        value_type scalar() const {return _s;};
+
+        size_t rows() const {return _e.rows();};
+        size_t cols() const {return _e.cols();};
+        value_type coeff(size_t i, size_t j) const {return _e.coeff(i, j)*_s;};
+        value_type coeff(size_t k) const {return _e.coeff(k)*_s;};
+        bool aliases(const value_type* p) const {return _e.aliases(p);};
+
+        void addTo(Matrix<value_type>& dst, value_type alpha) const;
+};
+
+/**
+ * Templated class MatrixTransposed.
+ * Lazy transpose, reads the operand with swapped indices.
+ */
+template<typename E>
+class MatrixTransposed : public MatrixExpr<MatrixTransposed<E>> {
+
+    private:
+
+        MatrixExprOperand<E> _e;
+
+    public:
+
+        using value_type = typename E::value_type;
+        static constexpr bool isLeaf = false;
+        static constexpr bool isLinear = false;
+        static constexpr bool hasProduct = E::hasProduct;
+
+        explicit MatrixTransposed(const E& e) : _e(e) {};
+
+        const E& expression() const {return _e;};
+
+        size_t rows() const {return _e.cols();};
+        size_t cols() const {return _e.rows();};
+        value_type coeff(size_t i, size_t j) const {return _e.coeff(j, i);};
+        value_type coeff(size_t k) const = delete;
+        bool aliases(const value_type* p) const {return _e.aliases(p);};
+
+        void addTo(Matrix<value_type>& dst, value_type alpha) const;
+};
+
+/**
+ * Templated class MatrixProduct.
+ * Lazy A*B, evaluated by the blocked GEMM kernel of Matrix.
+ * Matrix operands, scaled matrices and transposed matrices on the left are passed to the kernel
+ * directly, other operands are evaluated into a temporary first.
+ */
+template<typename L, typename R>
+class MatrixProduct : public MatrixExpr<MatrixProduct<L,R>> {
+
+    private:
+
+        MatrixExprOperand<L> _l;
+        MatrixExprOperand<R> _r;
+
+    public:
+
+        using value_type = typename L::value_type;
+        static constexpr bool isLeaf = false;
+        static constexpr bool isLinear = false;
+        static constexpr bool hasProduct = true;
+
+        MatrixProduct(const L& l, const R& r) : _l(l), _r(r){
+
+            if (l.cols() != r.rows()){
+                throw std::runtime_error("Sizes don't match! (operator * )");
+            };
+        };
+
+        size_t rows() const {return _l.rows();};
+        size_t cols() const {return _r.cols();};
+        value_type coeff(size_t i, size_t j) const {
+            value_type sum{0};
+            for (size_t p = 0; p < _l.cols(); ++p) sum += _l.coeff(i, p)*_r.coeff(p, j);
+            return sum;
+        };
+        value_type coeff(size_t k) const = delete;
+        bool aliases(const value_type* p) const {return _l.aliases(p) || _r.aliases(p);};
+
+        void addTo(Matrix<value_type>& dst, value_type alpha) const;
+};
+
+/**
+ * Function for operator + of matrix expressions.
+ * @return Lazy sum, sizes are checked immediately
+ */
+template<typename L, typename R>
+MatrixSum<L,R,1> operator+(const MatrixExpr<L>& l, const MatrixExpr<R>& r){
+
+    static_assert(std::is_same_v<typename L::value_type, typename R::value_type>, "Matrix entry types differ!");
+    return MatrixSum<L,R,1>(l.derived(), r.derived());
+};
+
+/**
+ * Function for operator - of matrix expressions.
+ * @return Lazy difference, sizes are checked immediately
+ */
+template<typename L, typename R>
+MatrixSum<L,R,-1> operator-(const MatrixExpr<L>& l, const MatrixExpr<R>& r){
+
+    static_assert(std::is_same_v<typename L::value_type, typename R::value_type>, "Matrix entry types differ!");
+    return MatrixSum<L,R,-1>(l.derived(), r.derived());
+};
+
+/**
+ * Function for multiplying a matrix expression with a scalar.
+ * @return Lazy scaled expression
+ */
+template<typename E>
+MatrixScaled<E> operator*(const MatrixExpr<E>& e, typename E::value_type scalar){
+
+    return MatrixScaled<E>(e.derived(), scalar);
+};
+
+/**
+ * Function for multiplying a scalar with a matrix expression.
+ * @return Lazy scaled expression
+ */
+template<typename E>
+MatrixScaled<E> operator*(typename E::value_type scalar, const MatrixExpr<E>& e){
+
+    return MatrixScaled<E>(e.derived(), scalar);
+};
+
+/**
+ * Function for the matrix product of matrix expressions.
+ * @return Lazy product, sizes are checked immediately
+ */
+template<typename L, typename R>
+MatrixProduct<L,R> operator*(const MatrixExpr<L>& l, const MatrixExpr<R>& r){
+
+    static_assert(std::is_same_v<typename L::value_type, typename R::value_type>, "Matrix entry types differ!");
+    return MatrixProduct<L,R>(l.derived(), r.derived());
+};
+
+// TEMPLATE DEFINITIONS, ONLY-HEADER FILE IMPLEMENTATION!
+
+template<typename E>
+auto MatrixExpr<E>::transposeView() const{
+
+    return MatrixTransposed<E>(derived());
+};
+
+/**
+ * Function for the fused element-wise pass dst = e, e must not contain a product.
+ * @param dst Row-major destination of e.rows()*e.cols() entries
+ */
+template<typename T, typename E>
+void assignExpression(T* dst, const E& e){
+
+    static_assert(!E::hasProduct, "Products are evaluated by addTo()");
+    const size_t m = e.rows();
+    const size_t n = e.cols();
+    if constexpr (E::isLinear){
+        for (size_t k = 0; k < m*n; ++k) dst[k] = e.coeff(k);
+    }
+    else {
+        for (size_t i = 0; i < m; ++i){
+            for (size_t j = 0; j < n; ++j) dst[i*n + j] = e.coeff(i, j);
+        };
+    };
+};
+
+/**
+ * Function for dst += alpha*e, products are accumulated by GEMM and all other parts in one fused pass.
+ * @param dst Matrix of the size of e
+ */
+template<typename T, typename E>
+void addExpression(Matrix<T>& dst, const E& e, T alpha){
+
+    T* d = dst.data();
+    const size_t m = e.rows();
+    const size_t n = e.cols();
+    if constexpr (E::hasProduct){
+        e.addTo(dst, alpha);
+    }
+    else if constexpr (E::isLeaf){
+        axpy(alpha, e.data(), d, m*n);
+    }
+    else if constexpr (E::isLinear){
+        for (size_t k = 0; k < m*n; ++k) d[k] += alpha*e.coeff(k);
+    }
+    else {
+        for (size_t i = 0; i < m; ++i){
+            for (size_t j = 0; j < n; ++j) d[i*n + j] += alpha*e.coeff(i, j);
+        };
+    };
+};
+
+template<typename L, typename R, int Sign>
+void MatrixSum<L,R,Sign>::addTo(Matrix<value_type>& dst, value_type alpha) const{
+
+    addExpression(dst, static_cast<const L&>(_l), alpha);
+    addExpression(dst, static_cast<const R&>(_r), Sign > 0 ? alpha : -alpha);
+};
+
+template<typename E>
+void MatrixScaled<E>::addTo(Matrix<value_type>& dst, value_type alpha) const{
+
+    addExpression(dst, static_cast<const E&>(_e), alpha*_s);
+};
+
+template<typename E>
+void MatrixTransposed<E>::addTo(Matrix<value_type>& dst, value_type alpha) const{
+
+    // the transpose of a product is formed from its value
+    const Matrix<value_type> value(_e);
+    addExpression(dst, MatrixTransposed<Matrix<value_type>>(value), alpha);
+};
+
+/**
+ * Structure describing a GEMM operand: entry (i,p) is at data[i*rowStride + p*colStride] times scale.
+ */
+template<typename T>
+struct ProductOperand{
+    const T* data;
+    size_t rowStride;
+    size_t colStride;
+    T scale;
+    Matrix<T> storage;
+};
+
+/**
+ * Functions packing an operand of a product for the GEMM kernel.
+ * The right operand needs contiguous rows, contiguousRows is set for it.
+ */
+template<typename T>
+ProductOperand<T> productOperand(const Matrix<T>& M, bool){
+
+    return {M.data(), M.cols(), 1, T{1}, Matrix<T>()};
+};
+
+template<typename T>
+ProductOperand<T> productOperand(const MatrixScaled<Matrix<T>>& S, bool contiguousRows){
+
+    ProductOperand<T> op = productOperand(S.expression(), contiguousRows);
+    op.scale = S.scalar();
+    return op;
+};
+
+template<typename T>
+ProductOperand<T> productOperand(const MatrixTransposed<Matrix<T>>& Tr, bool contiguousRows){
+
+    if (contiguousRows){
+        Matrix<T> storage(Tr);
+        const T* data = storage.data();
+        return {data, storage.cols(), 1, T{1}, std::move(storage)};
+    };
+    return {Tr.expression().data(), 1, Tr.expression().cols(), T{1}, Matrix<T>()};
+};
+
+template<typename E>
+ProductOperand<typename E::value_type> productOperand(const MatrixExpr<E>& e, bool){
+
+    using T = typename E::value_type;
+    Matrix<T> storage(e.derived());
+    const T* data = storage.data();
+    return {data, storage.cols(), 1, T{1}, std::move(storage)};
+};
+
+template<typename L, typename R>
+void MatrixProduct<L,R>::addTo(Matrix<value_type>& dst, value_type alpha) const{
+
+    const ProductOperand<value_type> A = productOperand(static_cast<const L&>(_l), false);
+    const ProductOperand<value_type> B = productOperand(static_cast<const R&>(_r), true);
+
+    Matrix<value_type>::gemm(rows(), cols(), _l.cols(), A.data, A.rowStride, A.colStride,
+                             B.data, B.rowStride, dst.data(), dst.cols(), alpha*A.scale*B.scale);
+};
+
+#endif
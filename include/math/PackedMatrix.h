@@ -0,0 +1,547 @@
+#ifndef PACKEDMATRIX_H
+#define PACKEDMATRIX_H
+
+#include "Matrix.h"
+#include "SparseMatrix.h"
+#include "Parallel.h"
+#include "VectorKernels.h"
+#include "VectorView.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Templated class PackedMatrix.
+ * Dense symmetric matrix of which only the lower triangle is stored, in tiled packed format:
+ * the lower triangle is split into BAROP_MATRIX_BLOCK_SIZE square tiles, each stored contiguously
+ * row-major, tiles above the diagonal are not stored. This needs about half the memory of a full
+ * Matrix, yet every tile is a full-format block, so cho() runs the same blocked TRSM/SYRK/GEMM
+ * kernels as Matrix::cho().
+ * The Cholesky factor has the same storage and can overwrite the matrix with choInPlace().
+ * @see Matrix
+ */
+template<typename T>
+class PackedMatrix {
+
+    private:
+
+        /**
+         * Private member variable.
+         * Tile size
+         */
+        static constexpr size_t _block = BAROP_MATRIX_BLOCK_SIZE > 0 ? BAROP_MATRIX_BLOCK_SIZE : 1;
+
+        /**
+         * Private member variable.
+         * Number of rows and columns
+         */
+        size_t _size;
+
+        /**
+         * Private member variable.
+         * Number of tile rows
+         */
+        size_t _numTiles;
+
+        /**
+         * Private member variable.
+         * Start of tile (I,J), J <= I, in _values at index I*(I+1)/2 + J
+         */
+        std::vector<size_t> _tileStart;
+
+        /**
+         * Private member variable.
+         * Tiles of the lower triangle, row-major, tile (I,J) has tileSize(I) rows and tileSize(J) columns
+         */
+        std::vector<T> _values;
+
+        /**
+         * Private member function.
+         * @param I Tile index
+         * @return Number of rows of the tiles in tile row I
+         */
+        size_t tileSize(size_t I) const {return std::min(_block, _size - I*_block);};
+
+        /**
+         * Private member function.
+         * @return Pointer to the first entry of tile (I,J), J <= I
+         */
+        T* tile(size_t I, size_t J) {return _values.data() + _tileStart[I*(I+1)/2 + J];};
+
+        /**
+         * Private member function.
+         * @return Pointer to the first entry of tile (I,J), J <= I
+         */
+        const T* tile(size_t I, size_t J) const {return _values.data() + _tileStart[I*(I+1)/2 + J];};
+
+        /**
+         * Private member function.
+         * Visits the stored part of row i, i.e. row i of the lower triangle up to and including the diagonal,
+         * as contiguous segments f(first column, pointer, length).
+         */
+        template<typename F>
+        void forEachRowSegment(size_t i, F&& f) const;
+
+        /**
+         * Private member function.
+         * @return Diagonal entry i
+         */
+        const T& diagonal(size_t i) const {
+            const size_t I = i/_block;
+            const size_t r = i - I*_block;
+            return tile(I, I)[r*tileSize(I) + r];
+        };
+
+    public:
+
+        /**
+        * PackedMatrix class constructor.
+        * Generates an empty 0x0 PackedMatrix.
+        */
+        PackedMatrix() : PackedMatrix(0) {};
+
+        /**
+        * PackedMatrix class constructor.
+        * Generates an n x n matrix with all entries zero.
+        * @param n Number of rows and columns
+        */
+        explicit PackedMatrix(size_t n);
+
+        /**
+        * PackedMatrix class constructor.
+        * Copies the lower triangle of a square matrix, the upper triangle is not read.
+        * @param A Symmetric matrix
+        * @see Matrix
+        */
+        explicit PackedMatrix(const Matrix<T>& A);
+
+        /**
+        * PackedMatrix class constructor.
+        * Copies the lower triangle of a symmetric sparse matrix.
+        * @param A Symmetric sparse matrix, both triangles stored
+        * @see SparseMatrix
+        */
+        explicit PackedMatrix(const SparseMatrix<T>& A);
+
+        /**
+        * Member function for finding the size.
+        * @return A vector containing the sizes in order: {rows, columns}.
+        */
+        std::vector<size_t> getSize() const {return {_size, _size};};
+
+        /**
+        * Member function for finding the number of stored entries.
+        * @return About n*(n+BAROP_MATRIX_BLOCK_SIZE)/2
+        */
+        size_t getStorageSize() const {return _values.size();};
+
+        /**
+        * Member function for operator() overloading.
+        * Allows for both read and write, (r,c) and (c,r) are the same entry.
+        * @param r Row index
+        * @param c Column index
+        */
+        T& operator()(size_t r, size_t c);
+
+        /**
+        * Member function for operator() overloading.
+        * Allows only for reading, (r,c) and (c,r) are the same entry.
+        * @param r Row index
+        * @param c Column index
+        */
+        const T& operator()(size_t r, size_t c) const;
+
+        /**
+        * Member function for unchecked access to an entry of the lower triangle, used by the assembly.
+        * The indices are checked only if BAROP_BOUNDS_CHECK is enabled (debug builds).
+        * @param r Row index
+        * @param c Column index, c <= r
+        */
+        T& unchecked(size_t r, size_t c);
+
+        /**
+        * Member function for converting to a full Matrix.
+        * Both triangles are filled, for a Cholesky factor the upper one reads as L^T.
+        * @return Dense symmetric matrix
+        * @see Matrix
+        */
+        Matrix<T> toDense() const;
+
+        /**
+        * Member function for computing matrix vector multiplication with the symmetric matrix.
+        * @param vec Vector that is wanted to be multiplied from right
+        * @return Resulting vector
+        */
+        std::vector<T> mVm(const std::vector<T>& vec) const;
+
+        /**
+        * Member function for computing complete Cholesky decomposition in place.
+        * Right-looking tiled algorithm, the tiles of a step are processed in parallel.
+        * Throws std::runtime_error if the matrix is not positive definite.
+        */
+        void choInPlace();
+
+        /**
+        * Member function for computing complete Cholesky decomposition.
+        * @return Cholesky factor L in packed storage
+        */
+        PackedMatrix<T> cho() const;
+
+        /**
+        * Member function for solving L*x = b by forward substitution.
+        * The matrix is treated as the lower triangular factor returned by cho().
+        * @param b Right hand side vector
+        * @return Solution vector x
+        */
+        std::vector<T> forwardSubstitution(const std::vector<T>& b) const;
+
+        /**
+        * Member function for solving L^T*x = b by backward substitution.
+        * The matrix is treated as the lower triangular factor returned by cho().
+        * @param b Right hand side vector
+        * @return Solution vector x
+        */
+        std::vector<T> transposedBackwardSubstitution(const std::vector<T>& b) const;
+
+        /**
+        * Member function for solving L*X = B for many right hand sides at once.
+        * @param B Right hand side matrix, one right hand side per column
+        * @return Solution matrix X
+        * @see Matrix
+        */
+        Matrix<T> blockForwardSubstitution(const Matrix<T>& B) const;
+
+        /**
+        * Member function for solving L^T*X = B for many right hand sides at once.
+        * @param B Right hand side matrix, one right hand side per column
+        * @return Solution matrix X
+        * @see Matrix
+        */
+        Matrix<T> blockTransposedBackwardSubstitution(const Matrix<T>& B) const;
+};
+
+// TEMPLATE DEFINITIONS, ONLY-HEADER FILE IMPLEMENTATION!
+
+template<typename T>
+PackedMatrix<T>::PackedMatrix(size_t n)
+    : _size(n), _numTiles((n + _block - 1)/_block), _tileStart(_numTiles*(_numTiles+1)/2 + 1, 0)
+{
+    size_t k = 0;
+    for (size_t I = 0; I < _numTiles; ++I){
+        for (size_t J = 0; J <= I; ++J, ++k){
+            _tileStart[k+1] = _tileStart[k] + tileSize(I)*tileSize(J);
+        };
+    };
+
+    _values.assign(_tileStart.back(), T{0});
+};
+
+template<typename T>
+PackedMatrix<T>::PackedMatrix(const Matrix<T>& A) : PackedMatrix(A.rows()){
+
+    if (A.rows() != A.cols()){
+        throw std::invalid_argument("Given matrix is not square! (PackedMatrix)");
+    };
+
+    for (size_t I = 0; I < _numTiles; ++I){
+        for (size_t J = 0; J <= I; ++J){
+            const size_t nJ = tileSize(J);
+            T* AIJ = tile(I, J);
+            for (size_t r = 0; r < tileSize(I); ++r){
+                const T* Ar = A.data() + (I*_block + r)*_size + J*_block;
+                std::copy(Ar, Ar + nJ, AIJ + r*nJ);
+            };
+        };
+    };
+};
+
+template<typename T>
+PackedMatrix<T>::PackedMatrix(const SparseMatrix<T>& A) : PackedMatrix(A.getSize()[0]){
+
+    if (A.getSize()[0] != A.getSize()[1]){
+        throw std::invalid_argument("Given matrix is not square! (PackedMatrix)");
+    };
+
+    const std::vector<size_t>& rowPtr = A.getRowPtr();
+    const std::vector<size_t>& colIdx = A.getColIdx();
+    const std::vector<T>& values = A.getValues();
+
+    for (size_t i = 0; i < _size; ++i){
+        for (size_t p = rowPtr[i]; p < rowPtr[i+1] && colIdx[p] <= i; ++p){
+            this->unchecked(i, colIdx[p]) = values[p];
+        };
+    };
+};
+
+template<typename T>
+template<typename F>
+void PackedMatrix<T>::forEachRowSegment(size_t i, F&& f) const{
+
+    const size_t I = i/_block;
+    const size_t r = i - I*_block;
+    for (size_t J = 0; J < I; ++J){
+        f(J*_block, tile(I, J) + r*_block, size_t{_block});
+    };
+    f(I*_block, tile(I, I) + r*tileSize(I), r + 1);
+};
+
+template<typename T>
+T& PackedMatrix<T>::unchecked(size_t r, size_t c){
+
+    BAROP_CHECK_INDEX(r < _size && c <= r, "PackedMatrix::unchecked");
+    const size_t I = r/_block;
+    const size_t J = c/_block;
+    return tile(I, J)[(r - I*_block)*tileSize(J) + (c - J*_block)];
+};
+
+template<typename T>
+T& PackedMatrix<T>::operator()(size_t r, size_t c){
+
+    if (r >= _size || c >= _size){
+        throw std::out_of_range("Index is out of range!");
+    };
+    if (c > r) std::swap(r, c);
+
+    return this->unchecked(r, c);
+};
+
+template<typename T>
+const T& PackedMatrix<T>::operator()(size_t r, size_t c) const{
+
+    if (r >= _size || c >= _size){
+        throw std::out_of_range("Index is out of range!");
+    };
+    if (c > r) std::swap(r, c);
+
+    return const_cast<PackedMatrix<T>*>(this)->unchecked(r, c);
+};
+
+template<typename T>
+Matrix<T> PackedMatrix<T>::toDense() const{
+
+    Matrix<T> A(_size, _size);
+    T* a = A.data();
+    for (size_t i = 0; i < _size; ++i){
+        forEachRowSegment(i, [&](size_t c0, const T* p, size_t len){
+            for (size_t c = 0; c < len; ++c){
+                a[i*_size + c0 + c] = p[c];
+                a[(c0 + c)*_size + i] = p[c];
+            };
+        });
+    };
+    return A;
+};
+
+template<typename T>
+std::vector<T> PackedMatrix<T>::mVm(const std::vector<T>& vec) const{
+
+    if (_size != vec.size()){
+        throw std::invalid_argument("Matrix-vector sizes don't match! (PackedMatrix::mVm)");
+    };
+
+    std::vector<T> result(_size, T{0});
+
+    for (size_t i = 0; i < _size; ++i){
+        forEachRowSegment(i, [&](size_t c0, const T* p, size_t len){
+            // the diagonal closes the last segment, it is counted once
+            const size_t off = (c0 + len == i + 1) ? len - 1 : len;
+            result[i] += dotProduct(p, vec.data() + c0, len);
+            axpy(vec[i], p, result.data() + c0, off);
+        });
+    };
+
+    return result;
+};
+
+template<typename T>
+void PackedMatrix<T>::choInPlace(){
+
+    for (size_t K = 0; K < _numTiles; ++K){
+
+        const size_t nK = tileSize(K);
+        T* LKK = tile(K, K);
+        Matrix<T>::choBlock(nK, LKK, nK);
+        for (size_t r = 0; r < nK; ++r){
+            if (!(LKK[r*nK + r] > T{0})){
+                throw std::runtime_error("Matrix is not positive definite! (PackedMatrix::cho)");
+            };
+        };
+
+        const size_t m = _numTiles - K - 1;
+        if (m == 0) break;
+
+        // panel: L_IK = A_IK*L_KK^-T
+        parallelFor(m, [&](size_t t){
+            const size_t I = K + 1 + t;
+            Matrix<T>::trsm(tileSize(I), nK, LKK, nK, tile(I, K), nK);
+        });
+
+        // W_J = L_JK^T, so that the GEMM kernel streams contiguous rows
+        const size_t rowsBelow = _size - (K + 1)*_block;
+        std::vector<T> W(nK*rowsBelow);
+        parallelFor(m, [&](size_t t){
+            const size_t J = K + 1 + t;
+            const size_t nJ = tileSize(J);
+            const T* LJK = tile(J, K);
+            T* WJ = W.data() + nK*t*_block;
+            for (size_t r = 0; r < nJ; ++r){
+                for (size_t p = 0; p < nK; ++p){
+                    WJ[p*nJ + r] = LJK[r*nK + p];
+                };
+            };
+        });
+
+        // trailing update A_IJ -= L_IK*L_JK^T, one task per tile of the trailing triangle
+        parallelFor(m*(m+1)/2, [&](size_t t){
+            size_t a = static_cast<size_t>((std::sqrt(8.0*t + 1.0) - 1.0)/2.0);
+            while (a*(a+1)/2 > t) --a;
+            while ((a+1)*(a+2)/2 <= t) ++a;
+            const size_t I = K + 1 + a;
+            const size_t J = K + 1 + (t - a*(a+1)/2);
+            const size_t nI = tileSize(I);
+            const size_t nJ = tileSize(J);
+            if (I == J){
+                Matrix<T>::syrk(nI, nK, tile(I, K), nK, tile(I, I), nI);
+            }
+            else {
+                Matrix<T>::gemm(nI, nJ, nK, tile(I, K), nK, 1, W.data() + nK*(J-K-1)*_block, nJ,
+                                tile(I, J), nJ, T{-1});
+            };
+        });
+    };
+
+    // only the lower triangle of the diagonal tiles was referenced
+    for (size_t I = 0; I < _numTiles; ++I){
+        const size_t nI = tileSize(I);
+        T* LII = tile(I, I);
+        for (size_t r = 0; r < nI; ++r){
+            std::fill(LII + r*nI + r + 1, LII + (r+1)*nI, T{0});
+        };
+    };
+};
+
+template<typename T>
+PackedMatrix<T> PackedMatrix<T>::cho() const{
+
+    PackedMatrix<T> L(*this);
+    L.choInPlace();
+    return L;
+};
+
+template<typename T>
+std::vector<T> PackedMatrix<T>::forwardSubstitution(const std::vector<T>& b) const{
+
+    if (_size != b.size()){
+        throw std::invalid_argument("Matrix-vector sizes don't match! (PackedMatrix::forwardSubstitution)");
+    };
+
+    std::vector<T> x(_size);
+
+    for (size_t i = 0; i < _size; ++i){
+        T sum = b[i];
+        T diag = T{1};
+        forEachRowSegment(i, [&](size_t c0, const T* p, size_t len){
+            if (c0 + len == i + 1){
+                diag = p[len-1];
+                --len;
+            };
+            sum -= dotProduct(p, x.data() + c0, len);
+        });
+        x[i] = sum/diag;
+    };
+
+    return x;
+};
+
+template<typename T>
+std::vector<T> PackedMatrix<T>::transposedBackwardSubstitution(const std::vector<T>& b) const{
+
+    if (_size != b.size()){
+        throw std::invalid_argument("Matrix-vector sizes don't match! (PackedMatrix::transposedBackwardSubstitution)");
+    };
+
+    std::vector<T> x(b);
+
+    // column i of L^T is row i of L, it is subtracted as soon as x[i] is known
+    for (size_t i = _size; i-- > 0;){
+        x[i] /= diagonal(i);
+        forEachRowSegment(i, [&](size_t c0, const T* p, size_t len){
+            axpy(-x[i], p, x.data() + c0, (c0 + len == i + 1) ? len - 1 : len);
+        });
+    };
+
+    return x;
+};
+
+template<typename T>
+Matrix<T> PackedMatrix<T>::blockForwardSubstitution(const Matrix<T>& B) const{
+
+    if (_size != B.rows()){
+        throw std::invalid_argument("Matrix sizes don't match! (PackedMatrix::blockForwardSubstitution)");
+    };
+
+    const size_t m = B.cols();
+    Matrix<T> X(B);
+    T* x = X.data();
+
+    // right-hand sides are independent, each task sweeps one fixed block of columns
+    parallelFor((m + _block - 1)/_block, [&](size_t t){
+        const size_t j0 = t*_block;
+        const size_t mc = std::min(_block, m - j0);
+        for (size_t i = 0; i < _size; ++i){
+            T* Xi = x + i*m + j0;
+            T inv = T{1};
+            forEachRowSegment(i, [&](size_t c0, const T* p, size_t len){
+                if (c0 + len == i + 1){
+                    inv = T{1}/p[len-1];
+                    --len;
+                };
+                for (size_t k = 0; k < len; ++k){
+                    axpy(-p[k], x + (c0 + k)*m + j0, Xi, mc);
+                };
+            });
+            for (size_t j = 0; j < mc; ++j){
+                Xi[j] *= inv;
+            };
+        };
+    });
+
+    return X;
+};
+
+template<typename T>
+Matrix<T> PackedMatrix<T>::blockTransposedBackwardSubstitution(const Matrix<T>& B) const{
+
+    if (_size != B.rows()){
+        throw std::invalid_argument("Matrix sizes don't match! (PackedMatrix::blockTransposedBackwardSubstitution)");
+    };
+
+    const size_t m = B.cols();
+    Matrix<T> X(B);
+    T* x = X.data();
+
+    // right-hand sides are independent, each task sweeps one fixed block of columns
+    parallelFor((m + _block - 1)/_block, [&](size_t t){
+        const size_t j0 = t*_block;
+        const size_t mc = std::min(_block, m - j0);
+        for (size_t i = _size; i-- > 0;){
+            T* Xi = x + i*m + j0;
+            const T inv = T{1}/diagonal(i);
+            for (size_t j = 0; j < mc; ++j){
+                Xi[j] *= inv;
+            };
+            forEachRowSegment(i, [&](size_t c0, const T* p, size_t len){
+                if (c0 + len == i + 1) --len;
+                for (size_t k = 0; k < len; ++k){
+                    axpy(-p[k], Xi, x + (c0 + k)*m + j0, mc);
+                };
+            });
+        };
+    });
+
+    return X;
+};
+
+#endif
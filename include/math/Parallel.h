@@ -0,0 +1,334 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Class ThreadPool.
+ * Persistent pool of worker threads executing independent tasks of a parallelFor.
+ * Tasks are handed out dynamically, but every task writes its own part of the result
+ * and performs the same operations as in a serial run, so results do not depend on
+ * the number of threads or on the scheduling.
+ * Nested parallelFor calls from inside a task run serially on the calling thread.
+ */
+class ThreadPool {
+
+    private:
+
+        /**
+         * Private member variable.
+         * Worker threads, the calling thread of parallelFor takes part as well
+         */
+        std::vector<std::thread> _workers;
+
+        /**
+         * Private member variable.
+         * Total number of threads including the calling one
+         */
+        size_t _numThreads;
+
+        /**
+         * Private member variable.
+         * Guards the job state below
+         */
+        std::mutex _mutex;
+
+        /**
+         * Private member variable.
+         * Serializes parallelFor calls coming from different user threads
+         */
+        std::mutex _submit;
+
+        /**
+         * Private member variable.
+         * Wakes the workers for a new job
+         */
+        std::condition_variable _wake;
+
+        /**
+         * Private member variable.
+         * Signals the calling thread that all workers finished the job
+         */
+        std::condition_variable _done;
+
+        /**
+         * Private member variable.
+         * Task function of the current job
+         */
+        const std::function<void(size_t)>* _job = nullptr;
+
+        /**
+         * Private member variable.
+         * Number of tasks of the current job
+         */
+        size_t _numTasks = 0;
+
+        /**
+         * Private member variable.
+         * Next task index to be handed out
+         */
+        std::atomic<size_t> _next{0};
+
+        /**
+         * Private member variable.
+         * Number of workers still busy with the current job
+         */
+        size_t _active = 0;
+
+        /**
+         * Private member variable.
+         * Job counter, a change wakes the workers
+         */
+        size_t _generation = 0;
+
+        /**
+         * Private member variable.
+         * Set when the workers are shut down
+         */
+        bool _stop = false;
+
+        /**
+         * Private member variable.
+         * First exception thrown by a task of the current job
+         */
+        std::exception_ptr _error;
+
+        /**
+         * Private member function.
+         * Flag of the current thread, true while it executes a task.
+         */
+        static bool& insideTask(){
+
+            thread_local bool flag = false;
+            return flag;
+        };
+
+        /**
+         * Private member function.
+         * Executes tasks of the current job until none are left.
+         */
+        void runTasks(){
+
+            insideTask() = true;
+            size_t t;
+            while ((t = _next.fetch_add(1)) < _numTasks){
+                try {
+                    (*_job)(t);
+                }
+                catch (...){
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (!_error) _error = std::current_exception();
+                };
+            };
+            insideTask() = false;
+        };
+
+        /**
+         * Private member function.
+         * Main loop of a worker thread.
+         * @param seen Job counter at the start of the worker, earlier jobs are not waited for
+         */
+        void workerLoop(size_t seen){
+
+            while (true){
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [this, &seen]{ return _stop || _generation != seen; });
+                if (_stop) return;
+                seen = _generation;
+                lock.unlock();
+
+                runTasks();
+
+                lock.lock();
+                if (--_active == 0) _done.notify_one();
+            };
+        };
+
+        /**
+         * Private member function.
+         * Starts numThreads-1 workers.
+         */
+        void start(size_t numThreads){
+
+            _numThreads = std::max<size_t>(numThreads, 1);
+
+            // workers created after earlier jobs must not wake up for them
+            size_t generation;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                generation = _generation;
+            }
+            for (size_t i = 1; i < _numThreads; ++i){
+                _workers.emplace_back(&ThreadPool::workerLoop, this, generation);
+            };
+        };
+
+        /**
+         * Private member function.
+         * Stops and joins all workers.
+         */
+        void shutdown(){
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _wake.notify_all();
+            for (std::thread& w : _workers) w.join();
+            _workers.clear();
+            _stop = false;
+        };
+
+    public:
+
+        /**
+        * ThreadPool class constructor.
+        * @param numThreads Number of threads, 0 selects the number of hardware threads
+        */
+        explicit ThreadPool(size_t numThreads = 0){
+
+            start(numThreads == 0 ? std::thread::hardware_concurrency() : numThreads);
+        };
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+        * ThreadPool class destructor.
+        * Joins all worker threads.
+        */
+        ~ThreadPool(){
+
+            shutdown();
+        };
+
+        /**
+        * Member function for changing the number of threads.
+        * @param numThreads Number of threads, 0 selects the number of hardware threads
+        */
+        void setNumThreads(size_t numThreads){
+
+            std::lock_guard<std::mutex> guard(_submit);
+            if (numThreads == 0) numThreads = std::thread::hardware_concurrency();
+            numThreads = std::max<size_t>(numThreads, 1);
+            if (numThreads == _numThreads) return;
+            shutdown();
+            start(numThreads);
+        };
+
+        /**
+        * Member function for finding the number of threads.
+        * @return Number of threads including the calling one
+        */
+        size_t getNumThreads() const {return _numThreads;};
+
+        /**
+        * Member function executing f(0), ..., f(numTasks-1) in parallel and waiting for all of them.
+        * The first exception thrown by a task is rethrown after all tasks finished.
+        * @param numTasks Number of tasks
+        * @param f Task function, called once per task index
+        */
+        template<typename F>
+        void parallelFor(size_t numTasks, F&& f){
+
+            if (numTasks == 0) return;
+            if (_numThreads <= 1 || numTasks == 1 || insideTask()){
+                for (size_t t = 0; t < numTasks; ++t) f(t);
+                return;
+            };
+
+            std::lock_guard<std::mutex> guard(_submit);
+            const std::function<void(size_t)> job(std::ref(f));
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _job = &job;
+                _numTasks = numTasks;
+                _next = 0;
+                _active = _workers.size();
+                _error = nullptr;
+                ++_generation;
+            }
+            _wake.notify_all();
+
+            runTasks();
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            _done.wait(lock, [this]{ return _active == 0; });
+            _job = nullptr;
+            if (_error) std::rethrow_exception(_error);
+        };
+
+        /**
+        * Static member function returning the pool shared by the math kernels.
+        * Its initial size is read from the environment variable BAROP_NUM_THREADS,
+        * otherwise the number of hardware threads is used.
+        * @return Shared thread pool
+        */
+        static ThreadPool& global(){
+
+            static ThreadPool pool([]{
+                const char* env = std::getenv("BAROP_NUM_THREADS");
+                return env ? static_cast<size_t>(std::strtoul(env, nullptr, 10)) : size_t{0};
+            }());
+            return pool;
+        };
+};
+
+/**
+ * Function for setting the number of threads used by the parallel math kernels.
+ * @param numThreads Number of threads, 0 selects the number of hardware threads
+ */
+inline void setNumThreads(size_t numThreads){
+
+    ThreadPool::global().setNumThreads(numThreads);
+};
+
+/**
+ * Function for finding the number of threads used by the parallel math kernels.
+ * @return Number of threads
+ */
+inline size_t getNumThreads(){
+
+    return ThreadPool::global().getNumThreads();
+};
+
+/**
+ * Function executing f(0), ..., f(numTasks-1) on the shared thread pool.
+ * @param numTasks Number of tasks
+ * @param f Task function, called once per task index
+ */
+template<typename F>
+inline void parallelFor(size_t numTasks, F&& f){
+
+    ThreadPool::global().parallelFor(numTasks, std::forward<F>(f));
+};
+
+/**
+ * Function executing f(i) for every index i of every group, one group after the other.
+ * The indices of a group are split into tasks of chunk indices that run in parallel,
+ * e.g. the colors of an element coloring, whose elements share no node.
+ * @param groups Index groups, processed in order
+ * @param chunk Number of indices per task
+ * @param f Function called once per index
+ */
+template<typename F>
+inline void parallelForEachGroup(const std::vector<std::vector<size_t>>& groups, size_t chunk, F&& f){
+
+    for (const std::vector<size_t>& group : groups){
+        parallelFor((group.size() + chunk - 1)/chunk, [&](size_t t){
+            size_t last = std::min(group.size(), (t + 1)*chunk);
+            for (size_t k = t*chunk; k < last; ++k) f(group[k]);
+        });
+    };
+};
+
+#endif
@@ -0,0 +1,399 @@
+#ifndef SKYLINEMATRIX_H
+#define SKYLINEMATRIX_H
+
+#include "SparseMatrix.h"
+#include "Parallel.h"
+#include "VectorKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Templated class SkylineMatrix.
+ * Symmetric matrix in skyline (profile) storage: row i of the lower triangle is stored
+ * contiguously from its first nonzero column up to the diagonal.
+ * The Cholesky factor has the same profile, so memory is O(n*bandwidth) after a
+ * bandwidth-reducing renumbering such as reverseCuthillMcKee().
+ */
+template<typename T>
+class SkylineMatrix {
+
+    private:
+
+        /**
+         * Private member variable.
+         * Number of rows and columns
+         */
+        size_t _size;
+
+        /**
+         * Private member variable.
+         * First stored column of each row
+         */
+        std::vector<size_t> _firstCol;
+
+        /**
+         * Private member variable.
+         * Start of each row in _values, size _size+1, the diagonal is at _rowStart[i+1]-1
+         */
+        std::vector<size_t> _rowStart;
+
+        /**
+         * Private member variable.
+         * Values of the lower triangle inside the profile, row by row
+         */
+        std::vector<T> _values;
+
+    public:
+
+        /**
+        * SkylineMatrix class constructor.
+        * Generates an empty 0x0 SkylineMatrix.
+        */
+        SkylineMatrix();
+
+        /**
+        * SkylineMatrix class constructor.
+        * Generates a matrix with given profile, all values are zero.
+        * @param firstCol First stored column of each row, firstCol[i] <= i
+        */
+        explicit SkylineMatrix(const std::vector<size_t>& firstCol);
+
+        /**
+        * SkylineMatrix class constructor.
+        * Copies the lower triangle of a symmetric sparse matrix into its profile.
+        * @param A Symmetric sparse matrix, both triangles stored
+        * @see SparseMatrix
+        */
+        explicit SkylineMatrix(const SparseMatrix<T>& A);
+
+        /**
+        * Member function for finding the size.
+        * @return A vector containing the sizes in order: {rows, columns}.
+        */
+        std::vector<size_t> getSize() const;
+
+        /**
+        * Member function for finding the number of stored entries.
+        * @return Number of entries inside the profile
+        */
+        size_t getProfileSize() const {return _values.size();};
+
+        /**
+        * Member function for finding the half bandwidth.
+        * @return max(i - firstCol[i]) over all rows
+        */
+        size_t getBandwidth() const;
+
+        /**
+        * Member function for operator() overloading.
+        * Allows for both read and write of entries inside the profile, (r,c) and (c,r) are the same entry.
+        * @param r Row index
+        * @param c Column index
+        */
+        T& operator()(size_t r, size_t c);
+
+        /**
+        * Member function for operator() overloading.
+        * Allows only for reading, entries outside the profile read as zero.
+        * @param r Row index
+        * @param c Column index
+        */
+        T operator()(size_t r, size_t c) const;
+
+        /**
+        * Member function for computing matrix vector multiplication.
+        * @param vec Vector that is wanted to be multiplied from right
+        * @return Resulting vector
+        */
+        std::vector<T> mVm(const std::vector<T>& vec) const;
+
+        /**
+        * Member function for computing complete Cholesky decomposition.
+        * Uses Cholesky-Banachiewicz algorithm restricted to the profile.
+        * The lower triangular factor L is returned in the same profile (upper part reads as L^T).
+        * @return Cholesky factor L
+        */
+        SkylineMatrix<T> cho() const;
+
+        /**
+        * Member function for solving L*x = b by forward substitution.
+        * The matrix is treated as the lower triangular factor returned by cho().
+        * @param b Right hand side vector
+        * @return Solution vector x
+        */
+        std::vector<T> forwardSubstitution(const std::vector<T>& b) const;
+
+        /**
+        * Member function for solving L^T*x = b by backward substitution.
+        * The matrix is treated as the lower triangular factor returned by cho().
+        * @param b Right hand side vector
+        * @return Solution vector x
+        */
+        std::vector<T> transposedBackwardSubstitution(const std::vector<T>& b) const;
+
+        /**
+        * Member function for solving L*X = B for many right hand sides at once.
+        * @param B Right hand side matrix, one right hand side per column
+        * @return Solution matrix X
+        * @see Matrix
+        */
+        Matrix<T> blockForwardSubstitution(const Matrix<T>& B) const;
+
+        /**
+        * Member function for solving L^T*X = B for many right hand sides at once.
+        * @param B Right hand side matrix, one right hand side per column
+        * @return Solution matrix X
+        * @see Matrix
+        */
+        Matrix<T> blockTransposedBackwardSubstitution(const Matrix<T>& B) const;
+};
+
+// TEMPLATE DEFINITIONS, ONLY-HEADER FILE IMPLEMENTATION!
+
+template<typename T>
+SkylineMatrix<T>::SkylineMatrix() : _size(0), _rowStart(1, 0){};
+
+template<typename T>
+SkylineMatrix<T>::SkylineMatrix(const std::vector<size_t>& firstCol)
+    : _size(firstCol.size()), _firstCol(firstCol), _rowStart(firstCol.size()+1, 0)
+{
+    for (size_t i = 0; i < _size; ++i){
+        if (_firstCol[i] > i){
+            throw std::invalid_argument("First column is right of the diagonal! (SkylineMatrix)");
+        };
+        _rowStart[i+1] = _rowStart[i] + (i - _firstCol[i] + 1);
+    };
+
+    _values.assign(_rowStart[_size], T{0});
+};
+
+template<typename T>
+SkylineMatrix<T>::SkylineMatrix(const SparseMatrix<T>& A) : SkylineMatrix(){
+
+    if (A.getSize()[0] != A.getSize()[1]){
+        throw std::invalid_argument("Given matrix is not square! (SkylineMatrix)");
+    };
+
+    size_t n = A.getSize()[0];
+    const std::vector<size_t>& rowPtr = A.getRowPtr();
+    const std::vector<size_t>& colIdx = A.getColIdx();
+    const std::vector<T>& values = A.getValues();
+
+    // column indices are sorted, so the first one of a row bounds the profile
+    std::vector<size_t> firstCol(n);
+    for (size_t i = 0; i < n; ++i){
+        firstCol[i] = (rowPtr[i] < rowPtr[i+1]) ? std::min(colIdx[rowPtr[i]], i) : i;
+    };
+
+    *this = SkylineMatrix<T>(firstCol);
+
+    for (size_t i = 0; i < n; ++i){
+        for (size_t p = rowPtr[i]; p < rowPtr[i+1] && colIdx[p] <= i; ++p){
+            _values[_rowStart[i] + colIdx[p] - _firstCol[i]] = values[p];
+        };
+    };
+};
+
+template<typename T>
+std::vector<size_t> SkylineMatrix<T>::getSize() const{
+
+    std::vector<size_t> result = {_size, _size};
+    return result;
+};
+
+template<typename T>
+size_t SkylineMatrix<T>::getBandwidth() const{
+
+    size_t b = 0;
+    for (size_t i = 0; i < _size; ++i){
+        b = std::max(b, i - _firstCol[i]);
+    };
+    return b;
+};
+
+template<typename T>
+T& SkylineMatrix<T>::operator()(size_t r, size_t c){
+
+    if (r >= _size || c >= _size){
+        throw std::out_of_range("Index is out of range!");
+    };
+    if (c > r) std::swap(r, c);
+    if (c < _firstCol[r]){
+        throw std::invalid_argument("Entry is outside the profile! (SkylineMatrix)");
+    };
+
+    return _values[_rowStart[r] + c - _firstCol[r]];
+};
+
+template<typename T>
+T SkylineMatrix<T>::operator()(size_t r, size_t c) const{
+
+    if (r >= _size || c >= _size){
+        throw std::out_of_range("Index is out of range!");
+    };
+    if (c > r) std::swap(r, c);
+    if (c < _firstCol[r]) return T{0};
+
+    return _values[_rowStart[r] + c - _firstCol[r]];
+};
+
+template<typename T>
+std::vector<T> SkylineMatrix<T>::mVm(const std::vector<T>& vec) const{
+
+    if (_size != vec.size()){
+        throw std::invalid_argument("Matrix-vector sizes don't match! (SkylineMatrix::mVm)");
+    };
+
+    std::vector<T> result(_size, T{0});
+
+    for (size_t i = 0; i < _size; ++i){
+        const T* row = _values.data() + _rowStart[i];
+        const size_t f = _firstCol[i];
+        // row i of the lower triangle is also column i of the upper triangle
+        result[i] += row[i-f]*vec[i] + dotProduct(row, vec.data() + f, i-f);
+        axpy(vec[i], row, result.data() + f, i-f);
+    };
+
+    return result;
+};
+
+template<typename T>
+SkylineMatrix<T> SkylineMatrix<T>::cho() const{
+
+    SkylineMatrix<T> L(*this);
+
+    for (size_t i = 0; i < _size; ++i){
+        // Li[j-fi] is entry (i,j) for fi <= j <= i
+        T* Li = L._values.data() + L._rowStart[i];
+        const size_t fi = _firstCol[i];
+
+        for (size_t j = fi; j <= i; ++j){
+            const T* Lj = L._values.data() + L._rowStart[j];
+            const size_t fj = _firstCol[j];
+
+            const size_t k0 = std::max(fi, fj);
+            const T sum = dotProduct(Li + (k0-fi), Lj + (k0-fj), j-k0);
+
+            if (i == j){
+                T d = Li[i-fi] - sum;
+                if (!(d > T{0})){
+                    throw std::runtime_error("Matrix is not positive definite! (SkylineMatrix::cho)");
+                };
+                Li[i-fi] = std::sqrt(d);
+            }
+            else {
+                Li[j-fi] = (Li[j-fi] - sum)/Lj[j-fj];
+            };
+        };
+    };
+
+    return L;
+};
+
+template<typename T>
+std::vector<T> SkylineMatrix<T>::forwardSubstitution(const std::vector<T>& b) const{
+
+    if (_size != b.size()){
+        throw std::invalid_argument("Matrix-vector sizes don't match! (SkylineMatrix::forwardSubstitution)");
+    };
+
+    std::vector<T> x(_size);
+
+    for (size_t i = 0; i < _size; ++i){
+        const T* Li = _values.data() + _rowStart[i];
+        const size_t f = _firstCol[i];
+        x[i] = (b[i] - dotProduct(Li, x.data() + f, i-f))/Li[i-f];
+    };
+
+    return x;
+};
+
+template<typename T>
+std::vector<T> SkylineMatrix<T>::transposedBackwardSubstitution(const std::vector<T>& b) const{
+
+    if (_size != b.size()){
+        throw std::invalid_argument("Matrix-vector sizes don't match! (SkylineMatrix::transposedBackwardSubstitution)");
+    };
+
+    std::vector<T> x(b);
+
+    for (size_t i = _size; i-- > 0;){
+        const T* Li = _values.data() + _rowStart[i];
+        const size_t f = _firstCol[i];
+        x[i] /= Li[i-f];
+        axpy(-x[i], Li, x.data() + f, i-f);
+    };
+
+    return x;
+};
+
+template<typename T>
+Matrix<T> SkylineMatrix<T>::blockForwardSubstitution(const Matrix<T>& B) const{
+
+    if (_size != B.getSize()[0]){
+        throw std::invalid_argument("Matrix sizes don't match! (SkylineMatrix::blockForwardSubstitution)");
+    };
+
+    const size_t m = B.getSize()[1];
+    Matrix<T> X(B);
+    T* x = X.data();
+
+    // right-hand sides are independent, each task sweeps one fixed block of columns
+    const size_t nb = BAROP_MATRIX_BLOCK_SIZE > 0 ? BAROP_MATRIX_BLOCK_SIZE : 1;
+    parallelFor((m + nb - 1)/nb, [&](size_t t){
+        const size_t j0 = t*nb;
+        const size_t mc = std::min(nb, m - j0);
+        for (size_t i = 0; i < _size; ++i){
+            const T* Li = _values.data() + _rowStart[i];
+            const size_t f = _firstCol[i];
+            T* Xi = x + i*m + j0;
+            for (size_t k = f; k < i; ++k){
+                axpy(-Li[k-f], x + k*m + j0, Xi, mc);
+            };
+            const T inv = T{1}/Li[i-f];
+            for (size_t j = 0; j < mc; ++j){
+                Xi[j] *= inv;
+            };
+        };
+    });
+
+    return X;
+};
+
+template<typename T>
+Matrix<T> SkylineMatrix<T>::blockTransposedBackwardSubstitution(const Matrix<T>& B) const{
+
+    if (_size != B.getSize()[0]){
+        throw std::invalid_argument("Matrix sizes don't match! (SkylineMatrix::blockTransposedBackwardSubstitution)");
+    };
+
+    const size_t m = B.getSize()[1];
+    Matrix<T> X(B);
+    T* x = X.data();
+
+    // right-hand sides are independent, each task sweeps one fixed block of columns
+    const size_t nb = BAROP_MATRIX_BLOCK_SIZE > 0 ? BAROP_MATRIX_BLOCK_SIZE : 1;
+    parallelFor((m + nb - 1)/nb, [&](size_t t){
+        const size_t j0 = t*nb;
+        const size_t mc = std::min(nb, m - j0);
+        for (size_t i = _size; i-- > 0;){
+            const T* Li = _values.data() + _rowStart[i];
+            const size_t f = _firstCol[i];
+            T* Xi = x + i*m + j0;
+            const T inv = T{1}/Li[i-f];
+            for (size_t j = 0; j < mc; ++j){
+                Xi[j] *= inv;
+            };
+            for (size_t k = f; k < i; ++k){
+                axpy(-Li[k-f], Xi, x + k*m + j0, mc);
+            };
+        };
+    });
+
+    return X;
+};
+
+#endif
@@ -0,0 +1,779 @@
+#ifndef SPARSECHOLESKY_H
+#define SPARSECHOLESKY_H
+
+#include "SparseMatrix.h"
+#include "GraphOrdering.h"
+#include "Parallel.h"
+#include "VectorKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Templated class SparseCholesky.
+ * Sparse Cholesky factorization P*A*P^T = L*L^T of a symmetric positive definite SparseMatrix.
+ * The symbolic analysis (ordering, elimination tree, supernodes, pattern of L) is done once by analyze(),
+ * factorize() then only recomputes the values of L (supernodal left-looking algorithm).
+ * Consecutive columns with nested patterns form a supernode, stored as one dense row-major block
+ * of (rows x columns), so the numeric work runs in the blocked GEMM, SYRK, TRSM and Cholesky kernels of Matrix.
+ */
+template<typename T>
+class SparseCholesky {
+
+    private:
+
+        /**
+         * Private member variable.
+         * Marker for "no entry" in index arrays
+         */
+        static constexpr size_t _none = std::numeric_limits<size_t>::max();
+
+        /**
+         * Private member variable.
+         * Smallest supernode update (rows x columns x width) that goes through the blocked GEMM kernel,
+         * smaller ones are scattered directly from dot products
+         */
+        static constexpr size_t _gemmWork = 4096;
+
+        /**
+         * Private member variable.
+         * Dimension of the factorized matrix
+         */
+        size_t _n;
+
+        /**
+         * Private member variable.
+         * Fill-reducing permutation, _perm[k] is the original index of the k-th pivot
+         */
+        std::vector<size_t> _perm;
+
+        /**
+         * Private member variable.
+         * Inverse permutation, _pinv[_perm[k]] = k
+         */
+        std::vector<size_t> _pinv;
+
+        /**
+         * Private member variable.
+         * Elimination tree, parent of each column of L (_none for roots)
+         */
+        std::vector<size_t> _parent;
+
+        /**
+         * Private member variable.
+         * First column of each supernode, size number of supernodes + 1
+         */
+        std::vector<size_t> _super;
+
+        /**
+         * Private member variable.
+         * Supernode of each column
+         */
+        std::vector<size_t> _colSuper;
+
+        /**
+         * Private member variable.
+         * Start of the row indices of each supernode in _Ri, size number of supernodes + 1
+         */
+        std::vector<size_t> _Rp;
+
+        /**
+         * Private member variable.
+         * Row indices of the supernodes, ascending, the first rows of a supernode are its own columns
+         */
+        std::vector<size_t> _Ri;
+
+        /**
+         * Private member variable.
+         * Start of each supernode block in _Lx, size number of supernodes + 1
+         */
+        std::vector<size_t> _Xp;
+
+        /**
+         * Private member variable.
+         * Values of L, one row-major block per supernode, the upper triangle of the diagonal block is unused
+         */
+        std::vector<T> _Lx;
+
+        /**
+         * Private member variable.
+         * Number of entries of L, including the diagonal
+         */
+        size_t _nnz;
+
+        /**
+         * Private member function.
+         * Finds the nonzero pattern of row k of L (excluding the diagonal) from the elimination tree.
+         * @param A Matrix being factorized
+         * @param k Row index in the permuted system
+         * @param flag Work array of size _n, marks visited columns with k
+         * @param stack Work array of size _n, receives the pattern in stack[top.._n-1]
+         * @return top, the start of the pattern inside stack (topologically ordered)
+         */
+        size_t ereach(const SparseMatrix<T>& A, size_t k,
+                      std::vector<size_t>& flag, std::vector<size_t>& stack) const;
+
+        /**
+         * Private member function.
+         * Rank-1 modification L*L^T + sign*x*x^T along the elimination tree path.
+         * @param x Modification vector in the original ordering
+         * @param sign +1 for an update, -1 for a downdate
+         * @param caller Name of the public member function reported in exceptions
+         */
+        void rankOne(const std::vector<T>& x, int sign, const char* caller);
+
+    public:
+
+        /**
+        * SparseCholesky class constructor.
+        * Generates an empty factorization, analyze() and factorize() must be called before solving.
+        */
+        SparseCholesky();
+
+        /**
+        * SparseCholesky class constructor.
+        * Orders the matrix with approximateMinimumDegreeOrdering() and factorizes it.
+        * @param A Symmetric positive definite matrix, both triangles stored
+        */
+        explicit SparseCholesky(const SparseMatrix<T>& A);
+
+        /**
+        * SparseCholesky class constructor.
+        * Factorizes the matrix with a given fill-reducing permutation.
+        * @param A Symmetric positive definite matrix, both triangles stored
+        * @param perm Permutation, perm[k] is the original index of the k-th pivot
+        */
+        SparseCholesky(const SparseMatrix<T>& A, std::vector<size_t> perm);
+
+        /**
+        * Member function for the symbolic analysis.
+        * Computes the elimination tree, finds the supernodes and allocates the pattern of L.
+        * @param A Symmetric matrix, only its pattern is used
+        * @param perm Permutation, perm[k] is the original index of the k-th pivot
+        */
+        void analyze(const SparseMatrix<T>& A, std::vector<size_t> perm);
+
+        /**
+        * Member function for the numeric factorization.
+        * Reuses the symbolic analysis, A must have the pattern passed to analyze().
+        * Throws std::runtime_error if A is not positive definite.
+        * @param A Symmetric positive definite matrix
+        */
+        void factorize(const SparseMatrix<T>& A);
+
+        /**
+        * Member function for solving A*x = b with the computed factor.
+        * @param b Right hand side vector
+        * @return Solution vector x
+        */
+        std::vector<T> solve(const std::vector<T>& b) const;
+
+        /**
+        * Member function for the rank-1 update of the factor to the one of A + x*x^T.
+        * Only the columns on the elimination tree path of x are touched.
+        * The nonzeros of x must form a clique of A (e.g. the dof of one element),
+        * so that the pattern of L does not change, otherwise std::invalid_argument is thrown.
+        * @param x Update vector in the original ordering
+        */
+        void update(const std::vector<T>& x);
+
+        /**
+        * Member function for the rank-1 downdate of the factor to the one of A - x*x^T.
+        * Same pattern requirement as update().
+        * Throws std::runtime_error if the result is not positive definite or numerically singular,
+        * the factor is invalid then.
+        * @param x Downdate vector in the original ordering
+        */
+        void downdate(const std::vector<T>& x);
+
+        /**
+        * Member function for the rank-k update A + X*X^T, one rank-1 update per column of X.
+        * @param X Update matrix in the original ordering
+        */
+        void rankUpdate(const Matrix<T>& X);
+
+        /**
+        * Member function for the rank-k downdate A - X*X^T, one rank-1 downdate per column of X.
+        * @param X Downdate matrix in the original ordering
+        */
+        void rankDowndate(const Matrix<T>& X);
+
+        /**
+        * Member function for solving A*X = B for many right hand sides with one sweep over L.
+        * @param B Right hand side matrix, one right hand side per column
+        * @return Solution matrix X
+        * @see Matrix
+        */
+        Matrix<T> blockSolve(const Matrix<T>& B) const;
+
+        /**
+        * Member function for finding the number of entries in L.
+        * @return Number of entries of L, including the diagonal
+        */
+        size_t getNNZ() const {return _nnz;};
+
+        /**
+        * Member function returning the permutation used.
+        * @return Permutation, perm[k] is the original index of the k-th pivot
+        */
+        const std::vector<size_t>& getPermutation() const {return _perm;};
+};
+
+// TEMPLATE DEFINITIONS, ONLY-HEADER FILE IMPLEMENTATION!
+
+template<typename T>
+SparseCholesky<T>::SparseCholesky() : _n(0), _super(1, 0), _Rp(1, 0), _Xp(1, 0), _nnz(0){};
+
+template<typename T>
+SparseCholesky<T>::SparseCholesky(const SparseMatrix<T>& A) : _n(0), _nnz(0){
+
+    size_t n = A.getSize()[0];
+    const std::vector<size_t>& rowPtr = A.getRowPtr();
+    const std::vector<size_t>& colIdx = A.getColIdx();
+
+    std::vector<std::vector<size_t>> adjacency(n);
+    for (size_t i = 0; i < n; ++i){
+        adjacency[i].assign(colIdx.begin() + rowPtr[i], colIdx.begin() + rowPtr[i+1]);
+    };
+
+    analyze(A, approximateMinimumDegreeOrdering(adjacency));
+    factorize(A);
+};
+
+template<typename T>
+SparseCholesky<T>::SparseCholesky(const SparseMatrix<T>& A, std::vector<size_t> perm) : _n(0), _nnz(0){
+
+    analyze(A, std::move(perm));
+    factorize(A);
+};
+
+template<typename T>
+size_t SparseCholesky<T>::ereach(const SparseMatrix<T>& A, size_t k,
+                                 std::vector<size_t>& flag, std::vector<size_t>& stack) const{
+
+    const std::vector<size_t>& rowPtr = A.getRowPtr();
+    const std::vector<size_t>& colIdx = A.getColIdx();
+
+    size_t top = _n;
+    flag[k] = k;
+
+    for (size_t p = rowPtr[_perm[k]]; p < rowPtr[_perm[k]+1]; ++p){
+
+        size_t i = _pinv[colIdx[p]];
+        if (i > k) continue;
+
+        // walk up the elimination tree until an already visited column
+        size_t len = 0;
+        for (; flag[i] != k; i = _parent[i]){
+            stack[len++] = i;
+            flag[i] = k;
+        };
+        while (len > 0) stack[--top] = stack[--len];
+    };
+
+    return top;
+};
+
+template<typename T>
+void SparseCholesky<T>::analyze(const SparseMatrix<T>& A, std::vector<size_t> perm){
+
+    if (A.getSize()[0] != A.getSize()[1]){
+        throw std::invalid_argument("Given matrix is not square! (SparseCholesky::analyze)");
+    };
+
+    _n = A.getSize()[0];
+
+    if (perm.size() != _n){
+        throw std::invalid_argument("Permutation size does not match the matrix! (SparseCholesky::analyze)");
+    };
+
+    _perm = std::move(perm);
+    _pinv.assign(_n, _none);
+    for (size_t k = 0; k < _n; ++k){
+        if (_perm[k] >= _n || _pinv[_perm[k]] != _none){
+            throw std::invalid_argument("Given vector is not a permutation! (SparseCholesky::analyze)");
+        };
+        _pinv[_perm[k]] = k;
+    };
+
+    const std::vector<size_t>& rowPtr = A.getRowPtr();
+    const std::vector<size_t>& colIdx = A.getColIdx();
+
+    // Elimination tree with path compression through ancestor
+    _parent.assign(_n, _none);
+    std::vector<size_t> ancestor(_n, _none);
+    for (size_t k = 0; k < _n; ++k){
+        for (size_t p = rowPtr[_perm[k]]; p < rowPtr[_perm[k]+1]; ++p){
+
+            size_t i = _pinv[colIdx[p]];
+            while (i != _none && i < k){
+                size_t inext = ancestor[i];
+                ancestor[i] = k;
+                if (inext == _none) _parent[i] = k;
+                i = inext;
+            };
+        };
+    };
+
+    // Column counts of L from the row patterns
+    std::vector<size_t> count(_n, 1);
+    std::vector<size_t> flag(_n, _none);
+    std::vector<size_t> stack(_n);
+    for (size_t k = 0; k < _n; ++k){
+        for (size_t top = ereach(A, k, flag, stack); top < _n; ++top){
+            count[stack[top]]++;
+        };
+    };
+
+    // column j joins the supernode of j-1 if it is its parent and the patterns nest
+    _super.clear();
+    _colSuper.assign(_n, 0);
+    for (size_t j = 0; j < _n; ++j){
+        if (j == 0 || _parent[j-1] != j || count[j-1] != count[j] + 1){
+            _super.push_back(j);
+        };
+        _colSuper[j] = _super.size() - 1;
+    };
+    _super.push_back(_n);
+    const size_t ns = _super.size() - 1;
+
+    // the rows of a supernode are the pattern of its first column
+    _Rp.assign(ns+1, 0);
+    _Xp.assign(ns+1, 0);
+    _nnz = 0;
+    for (size_t s = 0; s < ns; ++s){
+        const size_t w = _super[s+1] - _super[s];
+        const size_t rows = count[_super[s]];
+        _Rp[s+1] = _Rp[s] + rows;
+        _Xp[s+1] = _Xp[s] + rows*w;
+        _nnz += rows*w - w*(w-1)/2;
+    };
+
+    // the rows of a supernode below its columns are the entries of A there and the rows of its children
+    std::vector<size_t> childHead(ns, _none);
+    std::vector<size_t> childNext(ns, _none);
+    for (size_t c = 0; c < ns; ++c){
+        size_t p = _parent[_super[c+1]-1];
+        if (p != _none){
+            childNext[c] = childHead[_colSuper[p]];
+            childHead[_colSuper[p]] = c;
+        };
+    };
+
+    _Ri.assign(_Rp[ns], 0);
+    std::fill(flag.begin(), flag.end(), _none);
+    for (size_t s = 0; s < ns; ++s){
+        const size_t j0 = _super[s];
+        const size_t j1 = _super[s+1];
+        size_t* R = _Ri.data() + _Rp[s];
+        size_t len = 0;
+
+        for (size_t j = j0; j < j1; ++j){
+            R[len++] = j;
+        };
+        for (size_t j = j0; j < j1; ++j){
+            for (size_t p = rowPtr[_perm[j]]; p < rowPtr[_perm[j]+1]; ++p){
+                size_t i = _pinv[colIdx[p]];
+                if (i >= j1 && flag[i] != s){
+                    flag[i] = s;
+                    R[len++] = i;
+                };
+            };
+        };
+        for (size_t c = childHead[s]; c != _none; c = childNext[c]){
+            for (size_t r = _Rp[c] + (_super[c+1] - _super[c]); r < _Rp[c+1]; ++r){
+                size_t i = _Ri[r];
+                if (i >= j1 && flag[i] != s){
+                    flag[i] = s;
+                    R[len++] = i;
+                };
+            };
+        };
+        std::sort(R + (j1 - j0), R + len);
+    };
+
+    _Lx.assign(_Xp[ns], T{0});
+};
+
+template<typename T>
+void SparseCholesky<T>::factorize(const SparseMatrix<T>& A){
+
+    if (A.getSize()[0] != _n || A.getSize()[1] != _n){
+        throw std::invalid_argument("Matrix size does not match the analysis! (SparseCholesky::factorize)");
+    };
+
+    const std::vector<size_t>& rowPtr = A.getRowPtr();
+    const std::vector<size_t>& colIdx = A.getColIdx();
+    const std::vector<T>& values = A.getValues();
+
+    const size_t ns = _super.size() - 1;
+    std::fill(_Lx.begin(), _Lx.end(), T{0});
+
+    // position of each row inside the current supernode
+    std::vector<size_t> map(_n);
+
+    // descendants waiting to update a supernode, linked through next, pos is the first row still to apply
+    std::vector<size_t> head(ns, _none);
+    std::vector<size_t> next(ns, _none);
+    std::vector<size_t> pos(ns, 0);
+
+    // packed transposed rows and product of one update
+    std::vector<T> W;
+    std::vector<T> C;
+
+    for (size_t J = 0; J < ns; ++J){
+
+        const size_t j0 = _super[J];
+        const size_t wJ = _super[J+1] - j0;
+        const size_t* RJ = _Ri.data() + _Rp[J];
+        const size_t nrowJ = _Rp[J+1] - _Rp[J];
+        T* LJ = _Lx.data() + _Xp[J];
+
+        for (size_t r = 0; r < nrowJ; ++r){
+            map[RJ[r]] = r;
+        };
+
+        // scatter the lower part of the columns of P*A*P^T
+        for (size_t j = j0; j < j0 + wJ; ++j){
+            for (size_t p = rowPtr[_perm[j]]; p < rowPtr[_perm[j]+1]; ++p){
+                size_t i = _pinv[colIdx[p]];
+                if (i >= j) LJ[map[i]*wJ + (j - j0)] += values[p];
+            };
+        };
+
+        // updates from every descendant K with rows in the columns of J
+        for (size_t K = head[J]; K != _none;){
+
+            const size_t nextK = next[K];
+            const size_t wK = _super[K+1] - _super[K];
+            const size_t* RK = _Ri.data() + _Rp[K];
+            const size_t nrowK = _Rp[K+1] - _Rp[K];
+            const T* LK = _Lx.data() + _Xp[K];
+
+            // rows r1..r2-1 of K lie in the columns of J, rows r1.. receive the update
+            const size_t r1 = pos[K];
+            size_t r2 = r1;
+            while (r2 < nrowK && RK[r2] < j0 + wJ) ++r2;
+            const size_t m1 = r2 - r1;
+            const size_t m2 = nrowK - r1;
+
+            if (m1*m2*wK < _gemmWork){
+                for (size_t i = 0; i < m2; ++i){
+                    const T* Li = LK + (r1 + i)*wK;
+                    T* Ci = LJ + map[RK[r1 + i]]*wJ;
+                    for (size_t j = 0; j < std::min(i + 1, m1); ++j){
+                        Ci[RK[r1 + j] - j0] -= dotProduct(Li, LK + (r1 + j)*wK, wK);
+                    };
+                };
+            }
+            else {
+                // lower triangle of the diagonal part by SYRK, the rows below by GEMM against the packed transpose
+                C.assign(m2*m1, T{0});
+                Matrix<T>::syrk(m1, wK, LK + r1*wK, wK, C.data(), m1);
+                if (m2 > m1){
+                    W.resize(wK*m1);
+                    for (size_t j = 0; j < m1; ++j){
+                        for (size_t p = 0; p < wK; ++p){
+                            W[p*m1 + j] = LK[(r1 + j)*wK + p];
+                        };
+                    };
+                    Matrix<T>::gemm(m2 - m1, m1, wK, LK + r2*wK, wK, 1, W.data(), m1, C.data() + m1*m1, m1, T{-1});
+                };
+
+                for (size_t i = 0; i < m2; ++i){
+                    T* Ci = LJ + map[RK[r1 + i]]*wJ;
+                    for (size_t j = 0; j < std::min(i + 1, m1); ++j){
+                        Ci[RK[r1 + j] - j0] += C[i*m1 + j];
+                    };
+                };
+            };
+
+            pos[K] = r2;
+            if (r2 < nrowK){
+                size_t S = _colSuper[RK[r2]];
+                next[K] = head[S];
+                head[S] = K;
+            };
+            K = nextK;
+        };
+
+        // dense Cholesky of the diagonal block, then the rows below solve against it
+        Matrix<T>::choBlock(wJ, LJ, wJ);
+        for (size_t c = 0; c < wJ; ++c){
+            if (!(LJ[c*wJ + c] > T{0})){
+                throw std::runtime_error("Matrix is not positive definite! (SparseCholesky::factorize)");
+            };
+        };
+
+        if (nrowJ > wJ){
+            Matrix<T>::trsm(nrowJ - wJ, wJ, LJ, wJ, LJ + wJ*wJ, wJ);
+
+            pos[J] = wJ;
+            size_t S = _colSuper[RJ[wJ]];
+            next[J] = head[S];
+            head[S] = J;
+        };
+    };
+};
+
+template<typename T>
+std::vector<T> SparseCholesky<T>::solve(const std::vector<T>& b) const{
+
+    if (b.size() != _n){
+        throw std::invalid_argument("Matrix-vector sizes don't match! (SparseCholesky::solve)");
+    };
+
+    std::vector<T> x(_n);
+    for (size_t k = 0; k < _n; ++k){
+        x[k] = b[_perm[k]];
+    };
+
+    const size_t ns = _super.size() - 1;
+
+    // L*y = P*b, triangular solve with the diagonal block, the rows below take dot products with it
+    for (size_t s = 0; s < ns; ++s){
+        const size_t j0 = _super[s];
+        const size_t w = _super[s+1] - j0;
+        const size_t* R = _Ri.data() + _Rp[s];
+        const size_t nrow = _Rp[s+1] - _Rp[s];
+        const T* Ls = _Lx.data() + _Xp[s];
+        T* xs = x.data() + j0;
+
+        for (size_t c = 0; c < w; ++c){
+            xs[c] = (xs[c] - dotProduct(Ls + c*w, xs, c))/Ls[c*w + c];
+        };
+        for (size_t r = w; r < nrow; ++r){
+            x[R[r]] -= dotProduct(Ls + r*w, xs, w);
+        };
+    };
+
+    // L^T*z = y
+    for (size_t s = ns; s-- > 0;){
+        const size_t j0 = _super[s];
+        const size_t w = _super[s+1] - j0;
+        const size_t* R = _Ri.data() + _Rp[s];
+        const size_t nrow = _Rp[s+1] - _Rp[s];
+        const T* Ls = _Lx.data() + _Xp[s];
+        T* xs = x.data() + j0;
+
+        for (size_t r = w; r < nrow; ++r){
+            axpy(-x[R[r]], Ls + r*w, xs, w);
+        };
+        for (size_t c = w; c-- > 0;){
+            xs[c] /= Ls[c*w + c];
+            axpy(-xs[c], Ls + c*w, xs, c);
+        };
+    };
+
+    std::vector<T> result(_n);
+    for (size_t k = 0; k < _n; ++k){
+        result[_perm[k]] = x[k];
+    };
+
+    return result;
+};
+
+template<typename T>
+void SparseCholesky<T>::rankOne(const std::vector<T>& x, int sign, const char* caller){
+
+    if (x.size() != _n){
+        throw std::invalid_argument(std::string("Matrix-vector sizes don't match! (") + caller + ")");
+    };
+
+    // permuted copy, f is the first nonzero
+    std::vector<T> w(_n, T{0});
+    size_t f = _none;
+    size_t nnz = 0;
+    for (size_t k = 0; k < _n; ++k){
+        w[k] = x[_perm[k]];
+        if (w[k] != T{0}){
+            if (f == _none) f = k;
+            nnz++;
+        };
+    };
+
+    if (f == _none) return;
+
+    // the pattern of x must be inside column f of L, then the pattern of L stays the same
+    {
+        const size_t s = _colSuper[f];
+        size_t inColumn = 1;
+        for (size_t r = _Rp[s] + (f - _super[s]) + 1; r < _Rp[s+1]; ++r){
+            if (w[_Ri[r]] != T{0}) inColumn++;
+        };
+        if (inColumn != nnz){
+            throw std::invalid_argument(std::string("Update pattern is not contained in the factor! (") + caller + ")");
+        };
+    }
+
+    const T s = static_cast<T>(sign);
+
+    // Givens (update) or hyperbolic (downdate) rotation of each column on the path from f to the root,
+    // the nonzeros of w only ever spread to ancestors in the elimination tree
+    for (size_t j = f; j != _none; j = _parent[j]){
+
+        if (w[j] == T{0}) continue;
+
+        // column j is column col of its supernode block, entry r of it is at Lj[r*width]
+        const size_t super = _colSuper[j];
+        const size_t width = _super[super+1] - _super[super];
+        const size_t col = j - _super[super];
+        const size_t* R = _Ri.data() + _Rp[super];
+        const size_t nrow = _Rp[super+1] - _Rp[super];
+        T* Lj = _Lx.data() + _Xp[super] + col;
+
+        T ljj = Lj[col*width];
+        T r2 = ljj*ljj + s*w[j]*w[j];
+
+        // a downdate that cancels the pivot down to rounding error leaves a singular matrix
+        if (!(r2 > ((sign < 0) ? T(1E-10)*ljj*ljj : T{0}))){
+            throw std::runtime_error(std::string("Downdated matrix is not positive definite! (") + caller + ")");
+        };
+
+        T r = std::sqrt(r2);
+        T c = r/ljj;
+        T sn = w[j]/ljj;
+        Lj[col*width] = r;
+
+        for (size_t q = col + 1; q < nrow; ++q){
+            size_t i = R[q];
+            T& lij = Lj[q*width];
+            lij = (lij + s*sn*w[i])/c;
+            w[i] = c*w[i] - sn*lij;
+        };
+    };
+};
+
+template<typename T>
+void SparseCholesky<T>::update(const std::vector<T>& x){
+
+    rankOne(x, 1, "SparseCholesky::update");
+};
+
+template<typename T>
+void SparseCholesky<T>::downdate(const std::vector<T>& x){
+
+    rankOne(x, -1, "SparseCholesky::downdate");
+};
+
+template<typename T>
+void SparseCholesky<T>::rankUpdate(const Matrix<T>& X){
+
+    if (X.getSize()[0] != _n){
+        throw std::invalid_argument("Matrix sizes don't match! (SparseCholesky::rankUpdate)");
+    };
+
+    std::vector<T> x(_n);
+    for (size_t j = 0; j < X.getSize()[1]; ++j){
+        VectorView<const T> Xj = X.column(j);
+        for (size_t i = 0; i < _n; ++i) x[i] = Xj[i];
+        rankOne(x, 1, "SparseCholesky::rankUpdate");
+    };
+};
+
+template<typename T>
+void SparseCholesky<T>::rankDowndate(const Matrix<T>& X){
+
+    if (X.getSize()[0] != _n){
+        throw std::invalid_argument("Matrix sizes don't match! (SparseCholesky::rankDowndate)");
+    };
+
+    std::vector<T> x(_n);
+    for (size_t j = 0; j < X.getSize()[1]; ++j){
+        VectorView<const T> Xj = X.column(j);
+        for (size_t i = 0; i < _n; ++i) x[i] = Xj[i];
+        rankOne(x, -1, "SparseCholesky::rankDowndate");
+    };
+};
+
+template<typename T>
+Matrix<T> SparseCholesky<T>::blockSolve(const Matrix<T>& B) const{
+
+    if (B.getSize()[0] != _n){
+        throw std::invalid_argument("Matrix sizes don't match! (SparseCholesky::blockSolve)");
+    };
+
+    const size_t m = B.getSize()[1];
+    const T* b = B.data();
+
+    // permuted copy, row k holds row _perm[k] of B
+    Matrix<T> X(_n, m);
+    T* x = X.data();
+    for (size_t k = 0; k < _n; ++k){
+        std::copy(b + _perm[k]*m, b + (_perm[k]+1)*m, x + k*m);
+    };
+
+    // right-hand sides are independent, each task solves one fixed block of columns
+    const size_t ns = _super.size() - 1;
+    const size_t nb = BAROP_MATRIX_BLOCK_SIZE > 0 ? BAROP_MATRIX_BLOCK_SIZE : 1;
+    parallelFor((m + nb - 1)/nb, [&](size_t t){
+        const size_t r0 = t*nb;
+        const size_t mc = std::min(nb, m - r0);
+
+        // L*Y = P*B
+        for (size_t s = 0; s < ns; ++s){
+            const size_t j0 = _super[s];
+            const size_t w = _super[s+1] - j0;
+            const size_t* R = _Ri.data() + _Rp[s];
+            const size_t nrow = _Rp[s+1] - _Rp[s];
+            const T* Ls = _Lx.data() + _Xp[s];
+
+            for (size_t c = 0; c < w; ++c){
+                T* Xc = x + (j0 + c)*m + r0;
+                for (size_t p = 0; p < c; ++p){
+                    axpy(-Ls[c*w + p], x + (j0 + p)*m + r0, Xc, mc);
+                };
+                const T inv = T{1}/Ls[c*w + c];
+                for (size_t r = 0; r < mc; ++r){
+                    Xc[r] *= inv;
+                };
+            };
+            for (size_t q = w; q < nrow; ++q){
+                T* Xq = x + R[q]*m + r0;
+                for (size_t c = 0; c < w; ++c){
+                    axpy(-Ls[q*w + c], x + (j0 + c)*m + r0, Xq, mc);
+                };
+            };
+        };
+
+        // L^T*Z = Y
+        for (size_t s = ns; s-- > 0;){
+            const size_t j0 = _super[s];
+            const size_t w = _super[s+1] - j0;
+            const size_t* R = _Ri.data() + _Rp[s];
+            const size_t nrow = _Rp[s+1] - _Rp[s];
+            const T* Ls = _Lx.data() + _Xp[s];
+
+            for (size_t q = w; q < nrow; ++q){
+                const T* Xq = x + R[q]*m + r0;
+                for (size_t c = 0; c < w; ++c){
+                    axpy(-Ls[q*w + c], Xq, x + (j0 + c)*m + r0, mc);
+                };
+            };
+            for (size_t c = w; c-- > 0;){
+                T* Xc = x + (j0 + c)*m + r0;
+                const T inv = T{1}/Ls[c*w + c];
+                for (size_t r = 0; r < mc; ++r){
+                    Xc[r] *= inv;
+                };
+                for (size_t p = 0; p < c; ++p){
+                    axpy(-Ls[c*w + p], Xc, x + (j0 + p)*m + r0, mc);
+                };
+            };
+        };
+    });
+
+    Matrix<T> result(_n, m);
+    T* res = result.data();
+    for (size_t k = 0; k < _n; ++k){
+        std::copy(x + k*m, x + (k+1)*m, res + _perm[k]*m);
+    };
+
+    return result;
+};
+
+#endif
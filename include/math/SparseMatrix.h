@@ -0,0 +1,356 @@
+#ifndef SPARSEMATRIX_H
+#define SPARSEMATRIX_H
+
+#include "Matrix.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Templated class SparseMatrix.
+ * Square or rectangular matrix in compressed sparse row (CSR) format.
+ * The sparsity pattern is fixed at construction (symbolic phase), afterwards only
+ * the values of the stored entries are changed (numeric phase).
+ */
+template<typename T>
+class SparseMatrix {
+
+    private:
+
+        /**
+         * Private member variable.
+         * Number of rows
+         */
+        size_t _size1;
+
+        /**
+         * Private member variable.
+         * Number of columns
+         */
+        size_t _size2;
+
+        /**
+         * Private member variable.
+         * Start of each row in _colIdx/_values, size _size1+1
+         */
+        std::vector<size_t> _rowPtr;
+
+        /**
+         * Private member variable.
+         * Column index of each stored entry, sorted ascending within a row
+         */
+        std::vector<size_t> _colIdx;
+
+        /**
+         * Private member variable.
+         * Value of each stored entry
+         */
+        std::vector<T> _values;
+
+    public:
+
+        /**
+        * SparseMatrix class constructor.
+        * Generates an empty 0x0 SparseMatrix.
+        */
+        SparseMatrix();
+
+        /**
+        * SparseMatrix class constructor.
+        * Builds the sparsity pattern from column indices per row, all values are zero.
+        * Column indices may be unsorted and contain duplicates.
+        * @param r Number of rows
+        * @param c Number of columns
+        * @param pattern Column indices of the nonzero entries of each row, size r
+        */
+        SparseMatrix(size_t r, size_t c, std::vector<std::vector<size_t>> pattern);
+
+        /**
+        * Member function for finding the size.
+        * @return A vector containing the sizes in order: {rows, columns}.
+        */
+        std::vector<size_t> getSize() const;
+
+        /**
+        * Member function for finding the number of stored entries.
+        * @return Number of stored (structurally nonzero) entries
+        */
+        size_t getNNZ() const;
+
+        /**
+        * Member function for finding the position of an entry in the value array.
+        * Used to precompute scatter positions for repeated numeric assembly.
+        * @param r Row index
+        * @param c Column index
+        * @return Index into getValues(), throws if (r,c) is not in the pattern
+        */
+        size_t findIndex(size_t r, size_t c) const;
+
+        /**
+        * Member function for operator() overloading.
+        * Allows for both read and write of entries inside the sparsity pattern.
+        * @param r Row index
+        * @param c Column index
+        */
+        T& operator()(size_t r, size_t c);
+
+        /**
+        * Member function for operator() overloading.
+        * Allows only for reading, entries outside the pattern read as zero.
+        * @param r Row index
+        * @param c Column index
+        */
+        T operator()(size_t r, size_t c) const;
+
+        /**
+        * Member function that adds a value to an entry of the pattern.
+        * @param r Row index
+        * @param c Column index
+        * @param value Value to be added
+        */
+        void addValue(size_t r, size_t c, T value);
+
+        /**
+        * Member function that sets all stored values to zero, keeping the pattern.
+        */
+        void setZero();
+
+        /**
+        * Member function for computing matrix vector multiplication.
+        * @param vec Vector that is wanted to be multiplied from right
+        * @return Resulting vector
+        */
+        std::vector<T> mVm(const std::vector<T>& vec) const;
+
+        /**
+        * Member function for computing the Frobenius norm of the stored entries.
+        * @return Square root of the sum of the squared values
+        */
+        T frobeniusNorm() const;
+
+        /**
+        * Member function for extracting the rows and columns with the given indices.
+        * Used for removing fixed degrees of freedom in a single pass.
+        * @param indices Strictly ascending row/column indices that are kept
+        * @return Submatrix of size indices.size() x indices.size()
+        */
+        SparseMatrix<T> extractSubmatrix(const std::vector<size_t>& indices) const;
+
+        /**
+        * Member function for converting to a dense Matrix.
+        * @return Dense copy of the matrix
+        * @see Matrix
+        */
+        Matrix<T> toDense() const;
+
+        /**
+        * Member function returning the CSR row pointer array.
+        * @return Row pointer array of size rows+1
+        */
+        const std::vector<size_t>& getRowPtr() const {return _rowPtr;};
+
+        /**
+        * Member function returning the CSR column index array.
+        * @return Column index array of size getNNZ()
+        */
+        const std::vector<size_t>& getColIdx() const {return _colIdx;};
+
+        /**
+        * Member function returning the CSR value array.
+        * @return Value array of size getNNZ()
+        */
+        const std::vector<T>& getValues() const {return _values;};
+
+        /**
+        * Member function returning the CSR value array for writing.
+        * @return Value array of size getNNZ()
+        */
+        std::vector<T>& getValues() {return _values;};
+};
+
+// TEMPLATE DEFINITIONS, ONLY-HEADER FILE IMPLEMENTATION!
+
+template<typename T>
+SparseMatrix<T>::SparseMatrix() : _size1(0), _size2(0), _rowPtr(1, 0){};
+
+template<typename T>
+SparseMatrix<T>::SparseMatrix(size_t r, size_t c, std::vector<std::vector<size_t>> pattern)
+    : _size1(r), _size2(c), _rowPtr(r+1, 0)
+{
+    if (pattern.size() != r){
+        throw std::invalid_argument("Pattern size does not match the number of rows! (SparseMatrix)");
+    };
+
+    for (size_t i = 0; i < r; ++i){
+
+        std::vector<size_t>& row = pattern[i];
+        std::sort(row.begin(), row.end());
+        row.erase(std::unique(row.begin(), row.end()), row.end());
+
+        if (!row.empty() && row.back() >= c){
+            throw std::out_of_range("Column index out of range! (SparseMatrix)");
+        };
+
+        _rowPtr[i+1] = _rowPtr[i] + row.size();
+    };
+
+    _colIdx.reserve(_rowPtr[r]);
+    for (size_t i = 0; i < r; ++i){
+        _colIdx.insert(_colIdx.end(), pattern[i].begin(), pattern[i].end());
+    };
+
+    _values.assign(_rowPtr[r], T{0});
+};
+
+template<typename T>
+std::vector<size_t> SparseMatrix<T>::getSize() const{
+
+    std::vector<size_t> result = {_size1, _size2};
+    return result;
+};
+
+template<typename T>
+size_t SparseMatrix<T>::getNNZ() const{
+
+    return _values.size();
+};
+
+template<typename T>
+size_t SparseMatrix<T>::findIndex(size_t r, size_t c) const{
+
+    if (r >= _size1 || c >= _size2){
+        throw std::out_of_range("Index is out of range! (SparseMatrix::findIndex)");
+    };
+
+    auto first = _colIdx.begin() + _rowPtr[r];
+    auto last = _colIdx.begin() + _rowPtr[r+1];
+    auto it = std::lower_bound(first, last, c);
+
+    if (it == last || *it != c){
+        throw std::invalid_argument("Entry is not in the sparsity pattern! (SparseMatrix::findIndex)");
+    };
+
+    return static_cast<size_t>(it - _colIdx.begin());
+};
+
+template<typename T>
+T& SparseMatrix<T>::operator()(size_t r, size_t c){
+
+    return _values[findIndex(r,c)];
+};
+
+template<typename T>
+T SparseMatrix<T>::operator()(size_t r, size_t c) const{
+
+    if (r >= _size1 || c >= _size2){
+        throw std::out_of_range("Index is out of range!");
+    };
+
+    auto first = _colIdx.begin() + _rowPtr[r];
+    auto last = _colIdx.begin() + _rowPtr[r+1];
+    auto it = std::lower_bound(first, last, c);
+
+    if (it == last || *it != c) return T{0};
+
+    return _values[it - _colIdx.begin()];
+};
+
+template<typename T>
+void SparseMatrix<T>::addValue(size_t r, size_t c, T value){
+
+    _values[findIndex(r,c)] += value;
+};
+
+template<typename T>
+void SparseMatrix<T>::setZero(){
+
+    std::fill(_values.begin(), _values.end(), T{0});
+};
+
+template<typename T>
+T SparseMatrix<T>::frobeniusNorm() const{
+
+    T sum = T{0};
+    for (const T& v : _values){
+        sum += v*v;
+    };
+    return std::sqrt(sum);
+};
+
+template<typename T>
+std::vector<T> SparseMatrix<T>::mVm(const std::vector<T>& vec) const{
+
+    if (_size2 != vec.size()){
+
+      throw std::invalid_argument("Matrix-vector sizes don't match! (SparseMatrix::mVm)");
+    };
+
+    std::vector<T> result(_size1, T{0});
+
+    for (size_t i = 0; i < _size1; ++i){
+        T sum {0};
+        for (size_t k = _rowPtr[i]; k < _rowPtr[i+1]; ++k){
+
+            sum += _values[k] * vec[_colIdx[k]];
+        };
+        result[i] = sum;
+    };
+
+    return result;
+};
+
+template<typename T>
+SparseMatrix<T> SparseMatrix<T>::extractSubmatrix(const std::vector<size_t>& indices) const{
+
+    const size_t none = _size2;
+    std::vector<size_t> newIdx(_size2, none);
+
+    for (size_t k = 0; k < indices.size(); ++k){
+        if (indices[k] >= _size1 || indices[k] >= _size2){
+            throw std::out_of_range("Index is out of range! (SparseMatrix::extractSubmatrix)");
+        };
+        if (k > 0 && indices[k] <= indices[k-1]){
+            throw std::invalid_argument("Indices must be strictly ascending! (SparseMatrix::extractSubmatrix)");
+        };
+        newIdx[indices[k]] = k;
+    };
+
+    SparseMatrix<T> S;
+    S._size1 = indices.size();
+    S._size2 = indices.size();
+    S._rowPtr.assign(indices.size()+1, 0);
+
+    for (size_t k = 0; k < indices.size(); ++k){
+        size_t r = indices[k];
+        for (size_t p = _rowPtr[r]; p < _rowPtr[r+1]; ++p){
+
+            size_t c = newIdx[_colIdx[p]];
+            if (c != none){
+                S._colIdx.push_back(c);
+                S._values.push_back(_values[p]);
+            };
+        };
+        S._rowPtr[k+1] = S._colIdx.size();
+    };
+
+    return S;
+};
+
+template<typename T>
+Matrix<T> SparseMatrix<T>::toDense() const{
+
+    Matrix<T> M(_size1, _size2, T{0});
+
+    for (size_t i = 0; i < _size1; ++i){
+        for (size_t k = _rowPtr[i]; k < _rowPtr[i+1]; ++k){
+
+            M(i, _colIdx[k]) = _values[k];
+        };
+    };
+
+    return M;
+};
+
+#endif
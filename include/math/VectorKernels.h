@@ -0,0 +1,377 @@
+#ifndef VECTORKERNELS_H
+#define VECTORKERNELS_H
+
+#include <cstddef>
+
+/**
+ * Vectorized inner kernels shared by the dense, skyline and iterative solvers.
+ * Kernels for AVX-512, AVX2/FMA and SSE2 are compiled with per-function target attributes.
+ * On GCC/Clang x86-64 the widest one the CPU supports is selected once at runtime, so a
+ * portable build still uses AVX-512 where it is available. A build whose target already
+ * includes AVX-512 (e.g. -march=native on such a host) calls that kernel directly and inline.
+ * Other compilers use the kernel of their target flags, otherwise a portable unrolled loop.
+ */
+
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(__AVX512F__)
+#define BAROP_CPU_DISPATCH 1
+#define BAROP_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BAROP_CPU_DISPATCH 0
+#define BAROP_TARGET(isa)
+#endif
+
+#if BAROP_CPU_DISPATCH || defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__)) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Function for computing the dot product of two arrays.
+ * Four independent partial sums break the dependency chain of the reduction.
+ * @param x First array
+ * @param y Second array
+ * @param n Number of entries
+ * @return Sum of x[i]*y[i]
+ */
+template<typename T>
+inline T dotProduct(const T* x, const T* y, size_t n){
+
+    T s0{0}, s1{0}, s2{0}, s3{0};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4){
+        s0 += x[i]*y[i];
+        s1 += x[i+1]*y[i+1];
+        s2 += x[i+2]*y[i+2];
+        s3 += x[i+3]*y[i+3];
+    };
+    for (; i < n; ++i){
+        s0 += x[i]*y[i];
+    };
+    return (s0 + s1) + (s2 + s3);
+};
+
+/**
+ * Function for computing y += a*x.
+ * The arrays must not overlap.
+ * @param a Scalar factor
+ * @param x Array that is scaled and added
+ * @param y Array that is updated in place
+ * @param n Number of entries
+ */
+template<typename T>
+inline void axpy(T a, const T* x, T* y, size_t n){
+
+    for (size_t i = 0; i < n; ++i){
+        y[i] += a*x[i];
+    };
+};
+
+/**
+ * Function returning the instruction set of the double precision kernels.
+ * @return "AVX-512", "AVX2", "SSE2" or "generic"
+ */
+inline const char* vectorKernelISA();
+
+#if BAROP_CPU_DISPATCH || defined(__AVX512F__)
+
+/**
+ * Function for computing the dot product of two double arrays with AVX-512.
+ * @see dotProduct()
+ */
+BAROP_TARGET("avx512f")
+inline double dotProductAVX512(const double* x, const double* y, size_t n){
+
+    __m512d s0 = _mm512_setzero_pd();
+    __m512d s1 = _mm512_setzero_pd();
+    __m512d s2 = _mm512_setzero_pd();
+    __m512d s3 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32){
+        s0 = _mm512_fmadd_pd(_mm512_loadu_pd(x+i),    _mm512_loadu_pd(y+i),    s0);
+        s1 = _mm512_fmadd_pd(_mm512_loadu_pd(x+i+8),  _mm512_loadu_pd(y+i+8),  s1);
+        s2 = _mm512_fmadd_pd(_mm512_loadu_pd(x+i+16), _mm512_loadu_pd(y+i+16), s2);
+        s3 = _mm512_fmadd_pd(_mm512_loadu_pd(x+i+24), _mm512_loadu_pd(y+i+24), s3);
+    };
+    for (; i + 8 <= n; i += 8){
+        s0 = _mm512_fmadd_pd(_mm512_loadu_pd(x+i), _mm512_loadu_pd(y+i), s0);
+    };
+    if (i < n){
+        const __mmask8 mask = static_cast<__mmask8>((1u << (n - i)) - 1u);
+        s1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x+i), _mm512_maskz_loadu_pd(mask, y+i), s1);
+    };
+    __m512d s = _mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3));
+    // horizontal sum through memory, the 512-bit extract intrinsics trip -Wuninitialized in GCC 12 headers
+    alignas(64) double t[8];
+    _mm512_store_pd(t, s);
+    return ((t[0] + t[4]) + (t[2] + t[6])) + ((t[1] + t[5]) + (t[3] + t[7]));
+};
+
+/**
+ * Function for computing y += a*x on double arrays with AVX-512.
+ * @see axpy()
+ */
+BAROP_TARGET("avx512f")
+inline void axpyAVX512(double a, const double* x, double* y, size_t n){
+
+    const __m512d va = _mm512_set1_pd(a);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        _mm512_storeu_pd(y+i,   _mm512_fmadd_pd(va, _mm512_loadu_pd(x+i),   _mm512_loadu_pd(y+i)));
+        _mm512_storeu_pd(y+i+8, _mm512_fmadd_pd(va, _mm512_loadu_pd(x+i+8), _mm512_loadu_pd(y+i+8)));
+    };
+    for (; i + 8 <= n; i += 8){
+        _mm512_storeu_pd(y+i, _mm512_fmadd_pd(va, _mm512_loadu_pd(x+i), _mm512_loadu_pd(y+i)));
+    };
+    if (i < n){
+        const __mmask8 mask = static_cast<__mmask8>((1u << (n - i)) - 1u);
+        _mm512_mask_storeu_pd(y+i, mask, _mm512_fmadd_pd(va, _mm512_maskz_loadu_pd(mask, x+i),
+                                                         _mm512_maskz_loadu_pd(mask, y+i)));
+    };
+};
+
+#endif
+
+#if BAROP_CPU_DISPATCH || (defined(__AVX2__) && defined(__FMA__))
+
+/**
+ * Function for computing the dot product of two double arrays with AVX2 and FMA.
+ * @see dotProduct()
+ */
+BAROP_TARGET("avx2,fma")
+inline double dotProductAVX2(const double* x, const double* y, size_t n){
+
+    __m256d s0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd();
+    __m256d s2 = _mm256_setzero_pd();
+    __m256d s3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(x+i),    _mm256_loadu_pd(y+i),    s0);
+        s1 = _mm256_fmadd_pd(_mm256_loadu_pd(x+i+4),  _mm256_loadu_pd(y+i+4),  s1);
+        s2 = _mm256_fmadd_pd(_mm256_loadu_pd(x+i+8),  _mm256_loadu_pd(y+i+8),  s2);
+        s3 = _mm256_fmadd_pd(_mm256_loadu_pd(x+i+12), _mm256_loadu_pd(y+i+12), s3);
+    };
+    for (; i + 4 <= n; i += 4){
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(x+i), _mm256_loadu_pd(y+i), s0);
+    };
+    __m256d s = _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3));
+    __m128d h = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s, 1));
+    double sum = _mm_cvtsd_f64(_mm_add_sd(h, _mm_unpackhi_pd(h, h)));
+    for (; i < n; ++i){
+        sum += x[i]*y[i];
+    };
+    return sum;
+};
+
+/**
+ * Function for computing y += a*x on double arrays with AVX2 and FMA.
+ * @see axpy()
+ */
+BAROP_TARGET("avx2,fma")
+inline void axpyAVX2(double a, const double* x, double* y, size_t n){
+
+    const __m256d va = _mm256_set1_pd(a);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8){
+        _mm256_storeu_pd(y+i,   _mm256_fmadd_pd(va, _mm256_loadu_pd(x+i),   _mm256_loadu_pd(y+i)));
+        _mm256_storeu_pd(y+i+4, _mm256_fmadd_pd(va, _mm256_loadu_pd(x+i+4), _mm256_loadu_pd(y+i+4)));
+    };
+    for (; i + 4 <= n; i += 4){
+        _mm256_storeu_pd(y+i, _mm256_fmadd_pd(va, _mm256_loadu_pd(x+i), _mm256_loadu_pd(y+i)));
+    };
+    for (; i < n; ++i){
+        y[i] += a*x[i];
+    };
+};
+
+#endif
+
+#if BAROP_CPU_DISPATCH || defined(__SSE2__)
+
+/**
+ * Function for computing the dot product of two double arrays with SSE2.
+ * @see dotProduct()
+ */
+inline double dotProductSSE2(const double* x, const double* y, size_t n){
+
+    __m128d s0 = _mm_setzero_pd();
+    __m128d s1 = _mm_setzero_pd();
+    __m128d s2 = _mm_setzero_pd();
+    __m128d s3 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8){
+        s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(x+i),   _mm_loadu_pd(y+i)));
+        s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(x+i+2), _mm_loadu_pd(y+i+2)));
+        s2 = _mm_add_pd(s2, _mm_mul_pd(_mm_loadu_pd(x+i+4), _mm_loadu_pd(y+i+4)));
+        s3 = _mm_add_pd(s3, _mm_mul_pd(_mm_loadu_pd(x+i+6), _mm_loadu_pd(y+i+6)));
+    };
+    for (; i + 2 <= n; i += 2){
+        s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(x+i), _mm_loadu_pd(y+i)));
+    };
+    __m128d s = _mm_add_pd(_mm_add_pd(s0, s1), _mm_add_pd(s2, s3));
+    double sum = _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    if (i < n){
+        sum += x[i]*y[i];
+    };
+    return sum;
+};
+
+/**
+ * Function for computing y += a*x on double arrays with SSE2.
+ * @see axpy()
+ */
+inline void axpySSE2(double a, const double* x, double* y, size_t n){
+
+    const __m128d va = _mm_set1_pd(a);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4){
+        _mm_storeu_pd(y+i,   _mm_add_pd(_mm_loadu_pd(y+i),   _mm_mul_pd(va, _mm_loadu_pd(x+i))));
+        _mm_storeu_pd(y+i+2, _mm_add_pd(_mm_loadu_pd(y+i+2), _mm_mul_pd(va, _mm_loadu_pd(x+i+2))));
+    };
+    for (; i < n; ++i){
+        y[i] += a*x[i];
+    };
+};
+
+#endif
+
+#if BAROP_CPU_DISPATCH
+
+/**
+ * Double precision kernels of one instruction set.
+ */
+struct VectorKernelTable{
+
+    /**
+     * Dot product kernel
+     */
+    double (*dot)(const double*, const double*, size_t);
+
+    /**
+     * y += a*x kernel
+     */
+    void (*axpy)(double, const double*, double*, size_t);
+
+    /**
+     * Name of the instruction set
+     */
+    const char* isa;
+};
+
+/**
+ * Function returning the kernels of the widest instruction set supported by the CPU.
+ * The CPU is queried on the first call only, the check includes OS support of the wide registers.
+ * @return Kernel table used by dotProduct<double>() and axpy<double>()
+ */
+inline const VectorKernelTable& vectorKernels(){
+
+    static const VectorKernelTable table = [](){
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")){
+            return VectorKernelTable{dotProductAVX512, axpyAVX512, "AVX-512"};
+        };
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")){
+            return VectorKernelTable{dotProductAVX2, axpyAVX2, "AVX2"};
+        };
+        return VectorKernelTable{dotProductSSE2, axpySSE2, "SSE2"};
+    }();
+    return table;
+};
+
+/**
+ * Length below which the inlined SSE2 kernel beats the call through the kernel table.
+ */
+constexpr size_t vectorDispatchLength = 16;
+
+template<>
+inline double dotProduct<double>(const double* x, const double* y, size_t n){
+
+    if (n < vectorDispatchLength) return dotProductSSE2(x, y, n);
+    return vectorKernels().dot(x, y, n);
+};
+
+template<>
+inline void axpy<double>(double a, const double* x, double* y, size_t n){
+
+    if (n < vectorDispatchLength){
+        axpySSE2(a, x, y, n);
+        return;
+    };
+    vectorKernels().axpy(a, x, y, n);
+};
+
+inline const char* vectorKernelISA(){
+
+    return vectorKernels().isa;
+};
+
+#else
+
+#if defined(__AVX512F__)
+
+template<>
+inline double dotProduct<double>(const double* x, const double* y, size_t n){
+
+    return dotProductAVX512(x, y, n);
+};
+
+template<>
+inline void axpy<double>(double a, const double* x, double* y, size_t n){
+
+    axpyAVX512(a, x, y, n);
+};
+
+inline const char* vectorKernelISA(){
+
+    return "AVX-512";
+};
+
+#elif defined(__AVX2__) && defined(__FMA__)
+
+template<>
+inline double dotProduct<double>(const double* x, const double* y, size_t n){
+
+    return dotProductAVX2(x, y, n);
+};
+
+template<>
+inline void axpy<double>(double a, const double* x, double* y, size_t n){
+
+    axpyAVX2(a, x, y, n);
+};
+
+inline const char* vectorKernelISA(){
+
+    return "AVX2";
+};
+
+#elif defined(__SSE2__)
+
+template<>
+inline double dotProduct<double>(const double* x, const double* y, size_t n){
+
+    return dotProductSSE2(x, y, n);
+};
+
+template<>
+inline void axpy<double>(double a, const double* x, double* y, size_t n){
+
+    axpySSE2(a, x, y, n);
+};
+
+inline const char* vectorKernelISA(){
+
+    return "SSE2";
+};
+
+#else
+
+inline const char* vectorKernelISA(){
+
+    return "generic";
+};
+
+#endif
+
+#endif
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef VECTORVIEW_H
+#define VECTORVIEW_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+/**
+ * Bounds checks of the unchecked accessors, i.e. Matrix::unchecked(), Matrix::row(), Matrix::column()
+ * and VectorView::operator[].
+ * Enabled in debug builds, compiled out when NDEBUG is defined so that the kernels have no
+ * compare-and-branch per entry. Define as 0 or 1 before including the headers to override.
+ * The regular Matrix::operator() is always checked.
+ */
+#ifndef BAROP_BOUNDS_CHECK
+#ifdef NDEBUG
+#define BAROP_BOUNDS_CHECK 0
+#else
+#define BAROP_BOUNDS_CHECK 1
+#endif
+#endif
+
+/**
+ * Macro that throws std::out_of_range if the check is enabled and fails.
+ * A macro like assert, the check is expanded at the call site and no helper function has a
+ * definition that depends on BAROP_BOUNDS_CHECK, so debug clients can link a release build of the library.
+ * @param inRange Result of the range check, not evaluated when the checks are off
+ * @param where Name of the calling function, used in the message
+ */
+#if BAROP_BOUNDS_CHECK
+#define BAROP_CHECK_INDEX(inRange, where) \
+    ((inRange) ? void(0) : throw std::out_of_range(std::string("Index is out of range! (") + (where) + ")"))
+#else
+#define BAROP_CHECK_INDEX(inRange, where) ((void)0)
+#endif
+
+/**
+ * Templated class VectorView.
+ * Non-owning view of n entries with a constant stride, e.g. a row (stride 1) or a column
+ * (stride = number of columns) of a row-major Matrix.
+ * Use VectorView<const T> for read-only access. The viewed storage must outlive the view.
+ * @see Matrix
+ */
+template<typename T>
+class VectorView {
+
+    private:
+
+        /**
+         * Private member variable.
+         * First entry
+         */
+        T* _data;
+
+        /**
+         * Private member variable.
+         * Number of entries
+         */
+        size_t _size;
+
+        /**
+         * Private member variable.
+         * Distance between consecutive entries
+         */
+        size_t _stride;
+
+    public:
+
+        /**
+        * VectorView class constructor.
+        * @param data Pointer to the first entry
+        * @param size Number of entries
+        * @param stride Distance between consecutive entries
+        */
+        VectorView(T* data, size_t size, size_t stride = 1) : _data(data), _size(size), _stride(stride) {};
+
+        /**
+        * VectorView class converting constructor.
+        * Allows passing a writable view where a read-only view is expected.
+        * @param view Writable view of the same entries
+        */
+        template<typename U, typename = std::enable_if_t<std::is_same_v<const U, T> && !std::is_same_v<U, T>>>
+        VectorView(const VectorView<U>& view) : _data(view.data()), _size(view.size()), _stride(view.stride()) {};
+
+        /**
+        * Member function for finding the number of entries.
+        * @return Number of entries
+        */
+        size_t size() const {return _size;};
+
+        /**
+        * Member function for finding the stride.
+        * @return Distance between consecutive entries, 1 for contiguous views
+        */
+        size_t stride() const {return _stride;};
+
+        /**
+        * Member function returning the first entry.
+        * Contiguous views can be passed to the kernels of VectorKernels.h directly.
+        * @return Pointer to the first entry
+        */
+        T* data() const {return _data;};
+
+        /**
+        * Member function for operator[] overloading.
+        * Checked only if BAROP_BOUNDS_CHECK is enabled.
+        * @param i Index of the entry
+        */
+        T& operator[](size_t i) const {
+
+            BAROP_CHECK_INDEX(i < _size, "VectorView::operator[]");
+            return _data[i*_stride];
+        };
+};
+
+#endif
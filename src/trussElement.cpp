@@ -1,9 +1,14 @@
 #include "../include/barOP/trussElement.h"
+#include <stdexcept>
 
 TrussElement::TrussElement(int id, Node& node1, Node& node2, Material& Mat, double A) :
     Element(id, Mat), _node1(node1),
     _node2(node2), _A(A){};
 
+TrussElement::TrussElement(int id, Node& node1, Node& node2, Material& Mat, ElementArrays& arrays) :
+    Element(id, Mat), _node1(node1),
+    _node2(node2), _A(0.0), _arrays(&arrays){};
+
 std::vector<int> TrussElement::getDOF() const{
 
       int dof1 = 3*(_node1.getID())-2; // x
@@ -30,10 +35,23 @@ Node& TrussElement::getNode2() const {
     return _node2;
 };
 
+double TrussElement::getArea() const {
+
+    return _arrays ? _arrays->area[_id-1] : _A;
+};
+
+void TrussElement::setArea(double A) {
+
+    if (A <= 0.0){
+        throw std::invalid_argument("Cross section area must be positive! (TrussElement::setArea)");
+    };
+    (_arrays ? _arrays->area[_id-1] : _A) = A;
+};
+
 double TrussElement::computeLength() const{
 
-    std::vector<double> pos1 = _node1.getPosition();
-    std::vector<double> pos2 = _node2.getPosition();
+    const std::array<double,3> pos1 = _node1.getCoordinates();
+    const std::array<double,3> pos2 = _node2.getCoordinates();
 
     double x1 = pos1[0];
     double y1 = pos1[1];
@@ -53,8 +71,8 @@ Matrix<double> TrussElement::computeTransformation() const{
 
     double L = this->computeLength();
 
-    std::vector<double> pos1 = _node1.getPosition();
-    std::vector<double> pos2 = _node2.getPosition();
+    const std::array<double,3> pos1 = _node1.getCoordinates();
+    const std::array<double,3> pos2 = _node2.getCoordinates();
 
     double x1 = pos1[0];
     double y1 = pos1[1];
@@ -75,44 +93,65 @@ Matrix<double> TrussElement::computeTransformation() const{
 
 };
 
-Matrix<double> TrussElement::computeGlobalStiffnessMtx() const{
-
+std::array<double,3> TrussElement::computeDirectionCosines() const{
 
     double L = this->computeLength();
-    Matrix<double> transformationMtx = this->computeTransformation();
-    Matrix<double> elLocalStffMtx = {{1, -1},
-                                       {-1, 1}};
 
-    double scalar = _Material.getE()*_A/L;
+    const std::array<double,3> pos1 = _node1.getCoordinates();
+    const std::array<double,3> pos2 = _node2.getCoordinates();
 
-    elLocalStffMtx = elLocalStffMtx*scalar;
-
-    Matrix<double> elGlobalStffMtx = transformationMtx.transpose()*elLocalStffMtx*transformationMtx;
+    std::array<double,3> c;
+    for (size_t d = 0; d < 3; ++d){
+        c[d] = (pos2[d]-pos1[d])/L;
+    };
 
-    return elGlobalStffMtx;
+    return c;
 };
 
+Matrix<double> TrussElement::computeGlobalStiffnessMtx() const{
 
-double TrussElement::computeElStrain(std::vector<double>& u) const{
-
-    Matrix<double> transformationMtx = this->computeTransformation();
+    return this->computeGlobalStiffnessFixedMtx().toMatrix();
+};
 
-    std::vector<int> DOFs = this->getDOF();
-    std::vector<double> elementDispV(6);
+FixedMatrix<double,6,6> TrussElement::computeGlobalStiffnessFixedMtx() const{
 
-    for (int i = 0; i < 6;  ++i){
+    double L = this->computeLength();
 
-        elementDispV[i] = u[DOFs[i]-1];
+    return computeGlobalStiffnessFixedMtx(this->computeDirectionCosines(), _Material.getE()*this->getArea()/L);
+};
 
+FixedMatrix<double,6,6> TrussElement::computeGlobalStiffnessFixedMtx(const std::array<double,3>& c, double axialStiffness){
+
+    // T^T*k*T with T = [c^T 0; 0 c^T] and k = EA/L*[1 -1; -1 1]
+    FixedMatrix<double,6,6> elGlobalStffMtx;
+    double* k = elGlobalStffMtx.data();
+    for (size_t i = 0; i < 3; ++i){
+        for (size_t j = 0; j < 3; ++j){
+            double kij = axialStiffness*c[i]*c[j];
+            k[6*i + j] = kij;
+            k[6*i + j+3] = -kij;
+            k[6*(i+3) + j] = -kij;
+            k[6*(i+3) + j+3] = kij;
+        };
     };
 
-    std::vector<double> elementDisp = transformationMtx.mVm(elementDispV);
+    return elGlobalStffMtx;
+};
 
-    double L = this->computeLength();
 
-    double elStrain = (elementDisp[1] - elementDisp[0])/L;
+double TrussElement::computeElStrain(std::vector<double>& u) const{
+
+    // elongation c^T (u2 - u1) over the length, no transformation matrix is formed
+    const std::array<double,3> c = this->computeDirectionCosines();
+    const double* u1 = &u[3*(_node1.getID()-1)];
+    const double* u2 = &u[3*(_node2.getID()-1)];
+
+    double elongation = 0.0;
+    for (size_t d = 0; d < 3; ++d){
+        elongation += c[d]*(u2[d] - u1[d]);
+    };
 
-    return elStrain;
+    return elongation/this->computeLength();
 
 };
 
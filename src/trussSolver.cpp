@@ -0,0 +1,216 @@
+#include "../include/barOP/trussSolver.h"
+#include "math/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+TrussSolver::TrussSolver(const TrussStructure& ts) : _structure(ts){
+
+    _freeMap = ts.createFreeDOFMap();
+    _numFree = std::count_if(_freeMap.begin(), _freeMap.end(), [](long i){ return i >= 0; });
+
+    std::vector<size_t> freeDOF;
+    freeDOF.reserve(_numFree);
+    for (size_t i = 0; i < _freeMap.size(); ++i){
+        if (_freeMap[i] >= 0) freeDOF.push_back(i);
+    };
+
+    // symbolic phase: reduced pattern, scatter positions and ordering
+    _K = ts.createSparsityPattern().extractSubmatrix(freeDOF);
+
+    size_t numEl = ts.getElements().size();
+
+    _elementDOFs.resize(6*numEl);
+    _scatter.resize(36*numEl);
+
+    for (size_t e = 0; e < numEl; ++e){
+
+        std::array<int,6> DOFs = ts.getElementDOFs(e);
+        std::copy(DOFs.begin(), DOFs.end(), _elementDOFs.begin() + 6*e);
+
+        for (size_t j = 0; j < 6; ++j){
+            long r = _freeMap[DOFs[j]-1];
+            for (size_t k = 0; k < 6; ++k){
+                long c = _freeMap[DOFs[k]-1];
+                _scatter[36*e + 6*j + k] = (r >= 0 && c >= 0) ? static_cast<long>(_K.findIndex(r,c)) : -1;
+            };
+        };
+    };
+
+    _colors = ts.createElementColoring();
+    _chol.analyze(_K, ts.computeFillReducingOrdering());
+
+    this->computeElementData(_cosines, _stiffness);
+    this->refactorize();
+};
+
+void TrussSolver::computeElementData(std::vector<double>& cosines, std::vector<double>& stiffness) const{
+
+    size_t numEl = _structure.getElements().size();
+
+    cosines.resize(3*numEl);
+    stiffness.resize(numEl);
+
+    // every element writes only its own entries
+    const size_t chunk = 1024;
+    parallelFor((numEl + chunk - 1)/chunk, [&](size_t t){
+        size_t last = std::min(numEl, (t + 1)*chunk);
+        for (size_t e = t*chunk; e < last; ++e){
+
+            std::array<double,3> c;
+            double L = _structure.computeElementDirection(e, c);
+            std::copy(c.begin(), c.end(), cosines.begin() + 3*e);
+            stiffness[e] = _structure.computeAxialStiffness(e, L);
+        };
+    });
+};
+
+void TrussSolver::refactorize(){
+
+    _K.setZero();
+    std::vector<double>& values = _K.getValues();
+
+    // elements of one color share no node, hence no slot of _K
+    parallelForEachGroup(_colors, 256, [&](size_t e){
+
+        const double* c = &_cosines[3*e];
+        const long* pos = &_scatter[36*e];
+
+        FixedMatrix<double,6,6> elStffMtx = TrussElement::computeGlobalStiffnessFixedMtx({c[0], c[1], c[2]}, _stiffness[e]);
+        const double* k = elStffMtx.data();
+        for (size_t j = 0; j < 36; ++j){
+            if (pos[j] >= 0) values[pos[j]] += k[j];
+        };
+    });
+
+    _chol.factorize(_K);
+    _numFactorizations++;
+    _numUpdatesSinceFactorization = 0;
+};
+
+bool TrussSolver::update(){
+
+    size_t numEl = _structure.getElements().size();
+
+    if (_structure.getNodes().size()*3 != _freeMap.size() || numEl*6 != _elementDOFs.size()){
+        throw std::runtime_error("Number of nodes or elements changed, create a new solver! (TrussSolver::update)");};
+
+    if (_structure.createFreeDOFMap() != _freeMap){
+        throw std::runtime_error("Boundary conditions changed, create a new solver! (TrussSolver::update)");};
+
+    for (size_t e = 0; e < numEl; ++e){
+        std::array<int,6> DOFs = _structure.getElementDOFs(e);
+        if (!std::equal(DOFs.begin(), DOFs.end(), _elementDOFs.begin() + 6*e)){
+            throw std::runtime_error("Element connectivity changed, create a new solver! (TrussSolver::update)");};
+    };
+
+    std::vector<double> cosines;
+    std::vector<double> stiffness;
+    this->computeElementData(cosines, stiffness);
+
+    if (cosines == _cosines && stiffness == _stiffness) return false;
+
+    // elements whose axial stiffness changed along an unchanged direction are rank-1 modifications
+    std::vector<size_t> changed;
+    bool directionChanged = (cosines != _cosines);
+    for (size_t e = 0; e < stiffness.size() && !directionChanged; ++e){
+        if (stiffness[e] != _stiffness[e]) changed.push_back(e);
+    };
+
+    // rounding errors of the modifications add up, a long chain of them is replaced by a refactorization
+    if (!directionChanged && _numUpdatesSinceFactorization + changed.size() <= _maxLowRankUpdates){
+        try {
+            for (size_t e : changed){
+                double delta = stiffness[e] - _stiffness[e];
+                _stiffness[e] = stiffness[e];
+
+                std::vector<double> b = this->elementVector(e, std::sqrt(std::abs(delta)));
+                if (delta > 0.0){
+                    _chol.update(b);
+                }
+                else {
+                    _chol.downdate(b);
+                };
+                _numLowRankUpdates++;
+                _numUpdatesSinceFactorization++;
+            };
+            return true;
+        }
+        catch (const std::runtime_error&){
+            // lost positive definiteness numerically, start over from the matrix
+        };
+    };
+
+    _cosines.swap(cosines);
+    _stiffness.swap(stiffness);
+    this->refactorize();
+    return true;
+};
+
+std::vector<double> TrussSolver::elementVector(size_t e, double scale) const{
+
+    std::vector<double> b(_numFree, 0.0);
+    const double* c = &_cosines[3*e];
+
+    // elongation is c^T (u2 - u1)
+    for (size_t d = 0; d < 3; ++d){
+        long dof1 = _freeMap[_elementDOFs[6*e+d]-1];
+        long dof2 = _freeMap[_elementDOFs[6*e+d+3]-1];
+        if (dof1 >= 0) b[dof1] = -scale*c[d];
+        if (dof2 >= 0) b[dof2] = scale*c[d];
+    };
+    return b;
+};
+
+std::vector<double> TrussSolver::solveWithoutElement(size_t e){
+
+    return this->solveWithoutElement(e, _structure.createForceVector());
+};
+
+std::vector<double> TrussSolver::solveWithoutElement(size_t e, const std::vector<double>& forceVec){
+
+    if (forceVec.size() != _freeMap.size()){
+        throw std::invalid_argument("Force vector size does not match the number of DOF! (TrussSolver::solveWithoutElement)");};
+
+    this->update();
+
+    if (e >= _stiffness.size()){
+        throw std::out_of_range("Element index out of range! (TrussSolver::solveWithoutElement)");};
+
+    SparseCholesky<double> chol(_chol);
+    try {
+        chol.downdate(this->elementVector(e, std::sqrt(_stiffness[e])));
+    }
+    catch (const std::runtime_error&){
+        throw std::runtime_error("Structure is a mechanism without the element! (TrussSolver::solveWithoutElement)");
+    };
+
+    std::vector<double> F_red(_numFree);
+    for (size_t i = 0; i < forceVec.size(); ++i){
+        if (_freeMap[i] >= 0) F_red[_freeMap[i]] = forceVec[i];
+    };
+
+    std::vector<double> u_red = chol.solve(F_red);
+    return _structure.returnDispVector(u_red);
+};
+
+std::vector<double> TrussSolver::solve(){
+
+    return this->solve(_structure.createForceVector());
+};
+
+std::vector<double> TrussSolver::solve(const std::vector<double>& forceVec){
+
+    if (forceVec.size() != _freeMap.size()){
+        throw std::invalid_argument("Force vector size does not match the number of DOF! (TrussSolver::solve)");};
+
+    this->update();
+
+    std::vector<double> F_red(_numFree);
+    for (size_t i = 0; i < forceVec.size(); ++i){
+        if (_freeMap[i] >= 0) F_red[_freeMap[i]] = forceVec[i];
+    };
+
+    std::vector<double> u_red = _chol.solve(F_red);
+    return _structure.returnDispVector(u_red);
+};
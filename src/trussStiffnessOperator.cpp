@@ -0,0 +1,88 @@
+#include "../include/barOP/trussStiffnessOperator.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+TrussStiffnessOperator::TrussStiffnessOperator(const TrussStructure& ts){
+
+    // reduced index of each dof, -1 if fixed
+    std::vector<long> reducedIdx = ts.createFreeDOFMap();
+    _size = std::count_if(reducedIdx.begin(), reducedIdx.end(), [](long i){ return i >= 0; });
+
+    const ElementArrays& el = ts.getElementArrays();
+    size_t numEl = el.node1.size();
+
+    _dofs.resize(6*numEl);
+    _cosines.resize(3*numEl);
+    _stiffness.resize(numEl);
+
+    for (size_t e = 0; e < numEl; ++e){
+
+        std::array<double,3> c;
+        double L = ts.computeElementDirection(e, c);
+        std::copy(c.begin(), c.end(), _cosines.begin() + 3*e);
+        _stiffness[e] = ts.computeAxialStiffness(e, L);
+
+        for (size_t d = 0; d < 3; ++d){
+            _dofs[6*e+d] = reducedIdx[3*el.node1[e]+d];
+            _dofs[6*e+d+3] = reducedIdx[3*el.node2[e]+d];
+        };
+    };
+};
+
+std::vector<size_t> TrussStiffnessOperator::getSize() const{
+
+    std::vector<size_t> result = {_size, _size};
+    return result;
+};
+
+std::vector<double> TrussStiffnessOperator::mVm(const std::vector<double>& x) const{
+
+    if (x.size() != _size){
+        throw std::invalid_argument("Matrix-vector sizes don't match! (TrussStiffnessOperator::mVm)");
+    };
+
+    std::vector<double> y(_size, 0.0);
+    size_t numEl = _stiffness.size();
+
+    for (size_t e = 0; e < numEl; ++e){
+
+        const long* dof = &_dofs[6*e];
+        const double* c = &_cosines[3*e];
+
+        // elongation c^T (u2 - u1), fixed dof have zero displacement
+        double delta = 0.0;
+        for (size_t d = 0; d < 3; ++d){
+            double u1 = dof[d] >= 0 ? x[dof[d]] : 0.0;
+            double u2 = dof[d+3] >= 0 ? x[dof[d+3]] : 0.0;
+            delta += c[d]*(u2 - u1);
+        };
+
+        double f = _stiffness[e]*delta;
+
+        for (size_t d = 0; d < 3; ++d){
+            if (dof[d] >= 0) y[dof[d]] -= f*c[d];
+            if (dof[d+3] >= 0) y[dof[d+3]] += f*c[d];
+        };
+    };
+
+    return y;
+};
+
+std::vector<double> TrussStiffnessOperator::getDiagonal() const{
+
+    std::vector<double> diag(_size, 0.0);
+    size_t numEl = _stiffness.size();
+
+    for (size_t e = 0; e < numEl; ++e){
+        for (size_t j = 0; j < 6; ++j){
+            long dof = _dofs[6*e+j];
+            if (dof >= 0){
+                double c = _cosines[3*e + j%3];
+                diag[dof] += _stiffness[e]*c*c;
+            };
+        };
+    };
+
+    return diag;
+};
@@ -1,5 +1,11 @@
 #include "../include/barOP/trussStructure.h"
+#include "../include/barOP/trussStiffnessOperator.h"
+#include "../include/barOP/trussSolver.h"
 #include "math/Matrix.h"
+#include "math/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <functional>
 #include <stdexcept>
 #include <vector>
@@ -7,57 +13,257 @@
 // Getters
 const std::vector<std::unique_ptr<Node>>& TrussStructure::getNodes() const { return _nodes; };
 const std::vector<std::unique_ptr<TrussElement>>& TrussStructure::getElements() const { return _elements; };
-const std::vector<Material>& TrussStructure::getMaterials() const {return _materials;};
+const std::deque<Material>& TrussStructure::getMaterials() const {return _materials;};
 const std::map<int, bool>& TrussStructure::getConditions() const {return _boundaryConditions;};
 const std::map<int, double>& TrussStructure::getForces() const {return _forces;};
+const std::vector<LoadCase>& TrussStructure::getLoadCases() const {return _loadCases;};
+SolverType TrussStructure::getSolverType() const {return _solverType;};
+
+// Setters
+void TrussStructure::setSolverType(SolverType type) {_solverType = type;};
+
+void TrussStructure::setPCGSettings(PreconditionerType preconditioner, double tolerance, size_t maxIterations, double ssorOmega){
+
+    if (tolerance <= 0.0){
+        throw std::invalid_argument("Tolerance must be positive! (TrussStructure::setPCGSettings)");};
+    if (!(ssorOmega > 0.0 && ssorOmega < 2.0)){
+        throw std::invalid_argument("SSOR relaxation factor must be in (0,2)! (TrussStructure::setPCGSettings)");};
+
+    _pcgPreconditioner = preconditioner;
+    _pcgTolerance = tolerance;
+    _pcgMaxIterations = maxIterations;
+    _ssorOmega = ssorOmega;
+};
+
+void TrussStructure::setRefinementSettings(double tolerance, size_t maxIterations){
+
+    if (tolerance <= 0.0){
+        throw std::invalid_argument("Tolerance must be positive! (TrussStructure::setRefinementSettings)");};
+
+    _refinementTolerance = tolerance;
+    _refinementMaxIterations = maxIterations;
+};
 
 // ------- Nodes -------
-Node& TrussStructure::addNode(double x, double y, double z) {
+namespace {
 
-    double eps = 1E-1;
-    for (size_t i = 0; i < _nodes.size(); ++i){
-        for (size_t j = 0; j < 3; ++j){
-            if (std::abs(_nodes[i]->getPosition()[0] - x) < eps &&
-                std::abs(_nodes[i]->getPosition()[1] - y) < eps &&
-                std::abs(_nodes[i]->getPosition()[2] - z) < eps){
+    /**
+     * Visits the node indices stored in the 27 grid cells around a cell
+     * Stops early when f returns true
+     */
+    template<typename Cell, typename Grid, typename F>
+    void forEachNeighbour(const Grid& head, const std::vector<size_t>& next, const Cell& c, F&& f){
 
-                 throw std::invalid_argument("There exists a node in given location! (TrussStructure::addNode e<1E-1)");
+        for (long long di = -1; di <= 1; ++di){
+            for (long long dj = -1; dj <= 1; ++dj){
+                for (long long dk = -1; dk <= 1; ++dk){
+                    auto it = head.find(Cell{c.i + di, c.j + dj, c.k + dk});
+                    if (it == head.end()) continue;
+                    for (size_t n = it->second; n != SIZE_MAX; n = next[n]){
+                        if (f(n)) return;
+                    };
                 };
+            };
         };
     };
+};
 
-    int id;
-    if (_nodes.empty()){
-        id = 1;
-    }
-    else {
-        id = _nodes.size() + 1;
-    }
+void TrussStructure::setNodeTolerance(double tolerance){
+
+    if (!(tolerance > 0.0)){
+        throw std::invalid_argument("Tolerance must be positive! (TrussStructure::setNodeTolerance)");};
+
+    _nodeTolerance = tolerance;
+    _nodeGridHead.clear();
+    _nodeGridNext.clear();
+    updateNodeGrid();
+};
+
+TrussStructure::NodeCell TrussStructure::nodeCellOf(double x, double y, double z) const {
+
+    return {static_cast<long long>(std::floor(x/_nodeTolerance)),
+            static_cast<long long>(std::floor(y/_nodeTolerance)),
+            static_cast<long long>(std::floor(z/_nodeTolerance))};
+};
+
+void TrussStructure::updateNodeGrid(){
 
-    //std::cout << '\n' <<"id: " << id << std::endl;
+    const NodeArrays& xyz = *_nodeArrays;
+    if (_nodeGridNext.size() == _nodes.size() && _nodeGridRevision == xyz.revision) return;
+
+    _nodeGridHead.clear();
+    _nodeGridNext.assign(_nodes.size(), SIZE_MAX);
+    for (size_t i = 0; i < _nodes.size(); ++i){
+        size_t& head = _nodeGridHead.try_emplace(nodeCellOf(xyz.x[i], xyz.y[i], xyz.z[i]), SIZE_MAX).first->second;
+        _nodeGridNext[i] = head;
+        head = i;
+    };
+    _nodeGridRevision = xyz.revision;
+};
+
+size_t TrussStructure::findNodeIndex(double x, double y, double z) const {
+
+    const NodeArrays& xyz = *_nodeArrays;
+    size_t found = _nodes.size();
+    forEachNeighbour(_nodeGridHead, _nodeGridNext, nodeCellOf(x, y, z), [&](size_t n){
+        if (n < found &&
+            std::abs(xyz.x[n] - x) < _nodeTolerance &&
+            std::abs(xyz.y[n] - y) < _nodeTolerance &&
+            std::abs(xyz.z[n] - z) < _nodeTolerance){
+            found = n;
+        };
+        return false;
+    });
+    return found;
+};
+
+Node& TrussStructure::appendNode(double x, double y, double z){
+
+    int id = _nodes.size() + 1;
+
+    // coordinates go to the arrays, the node is a view into them
+    _nodeArrays->x.push_back(x);
+    _nodeArrays->y.push_back(y);
+    _nodeArrays->z.push_back(z);
+    _nodes.push_back(std::make_unique<Node>(id, *_nodeArrays));
+
+    // prepend to the list of its cell
+    size_t& head = _nodeGridHead.try_emplace(nodeCellOf(x, y, z), SIZE_MAX).first->second;
+    _nodeGridNext.push_back(head);
+    head = id - 1;
 
-     // create in place and add directly
-    _nodes.push_back(std::make_unique<Node>(id,x,y,z));
     return static_cast<Node&>(*_nodes.back());
 };
 
+Node& TrussStructure::addNode(double x, double y, double z) {
+
+    updateNodeGrid();
+    if (findNodeIndex(x, y, z) < _nodes.size()){
+        throw std::invalid_argument("There exists a node in given location! (TrussStructure::addNode)");
+    };
+
+    return appendNode(x, y, z);
+};
+
+std::vector<int> TrussStructure::addNodes(const std::vector<std::array<double,3>>& coordinates){
+
+    updateNodeGrid();
+    const size_t numExisting = _nodes.size();
+    const size_t numPoints = coordinates.size();
+    const size_t chunk = 1024;
+    const size_t numChunks = (numPoints + chunk - 1)/chunk;
+
+    // existing duplicates and grid cells of the points, the grid is only read here
+    std::vector<size_t> existing(numPoints);
+    std::vector<NodeCell> cells(numPoints);
+    parallelFor(numChunks, [&](size_t t){
+        for (size_t p = t*chunk; p < std::min(numPoints, (t+1)*chunk); ++p){
+            const std::array<double,3>& c = coordinates[p];
+            existing[p] = findNodeIndex(c[0], c[1], c[2]);
+            cells[p] = nodeCellOf(c[0], c[1], c[2]);
+        };
+    });
+
+    // grid of the points themselves
+    std::unordered_map<NodeCell, size_t, NodeCellHash> head;
+    std::vector<size_t> next(numPoints, SIZE_MAX);
+    for (size_t p = 0; p < numPoints; ++p){
+        size_t& h = head.try_emplace(cells[p], SIZE_MAX).first->second;
+        next[p] = h;
+        h = p;
+    };
+
+    // earlier points within the tolerance, in increasing order
+    std::vector<std::vector<size_t>> earlier(numPoints);
+    parallelFor(numChunks, [&](size_t t){
+        for (size_t p = t*chunk; p < std::min(numPoints, (t+1)*chunk); ++p){
+            if (existing[p] < numExisting) continue;
+            const std::array<double,3>& c = coordinates[p];
+            forEachNeighbour(head, next, cells[p], [&](size_t q){
+                if (q < p &&
+                    std::abs(coordinates[q][0] - c[0]) < _nodeTolerance &&
+                    std::abs(coordinates[q][1] - c[1]) < _nodeTolerance &&
+                    std::abs(coordinates[q][2] - c[2]) < _nodeTolerance){
+                    earlier[p].push_back(q);
+                };
+                return false;
+            });
+            std::sort(earlier[p].begin(), earlier[p].end());
+        };
+    });
+
+    // in input order, a point becomes a node unless an existing node or an earlier new node covers it
+    std::vector<int> ids(numPoints);
+    std::vector<bool> created(numPoints, false);
+    for (size_t p = 0; p < numPoints; ++p){
+        if (existing[p] < numExisting){
+            ids[p] = existing[p] + 1;
+            continue;
+        };
+        auto first = std::find_if(earlier[p].begin(), earlier[p].end(), [&](size_t q){ return created[q]; });
+        if (first != earlier[p].end()){
+            ids[p] = ids[*first];
+            continue;
+        };
+        const std::array<double,3>& c = coordinates[p];
+        ids[p] = appendNode(c[0], c[1], c[2]).getID();
+        created[p] = true;
+    };
+    return ids;
+};
+
 // ------- Materials -------
-Material& TrussStructure::addMaterial(std::string matName, double E)
+Material& TrussStructure::addMaterial(std::string matName, double E, double allowableStress)
 {
     for (size_t i = 0; i < _materials.size(); ++i){
         if (_materials[i].getName() == matName){
             throw std::invalid_argument("Given Material Already Exists! (TrussStructure::addMaterial)");
         };
     };
-    _materials.emplace_back(matName, E);
+    if (allowableStress < 0.0){
+        throw std::invalid_argument("Allowable stress must not be negative! (TrussStructure::addMaterial)");
+    };
+    _materials.emplace_back(matName, E, allowableStress);
     return _materials.back();
 };
 
 // ------- Elements -------
 TrussElement& TrussStructure::addTrussElement(Node& n1, Node& n2, Material& mat, double A) {
 
+    auto nodeIndex = [this](const Node& n){
+        size_t i = n.getID() - 1;
+        if (n.getID() < 1 || i >= _nodes.size() || _nodes[i].get() != &n){
+            throw std::invalid_argument("Node does not belong to the truss structure! (TrussStructure::addTrussElement)");};
+        return i;
+    };
+    size_t i1 = nodeIndex(n1);
+    size_t i2 = nodeIndex(n2);
+
+    auto matIt = std::find_if(_materials.begin(), _materials.end(), [&mat](const Material& m){ return &m == &mat; });
+    if (matIt == _materials.end()){
+        throw std::invalid_argument("Material does not belong to the truss structure! (TrussStructure::addTrussElement)");};
+
+    ElementArrays& el = *_elementArrays;
+    el.node1.push_back(i1);
+    el.node2.push_back(i2);
+    el.area.push_back(A);
+    el.material.push_back(static_cast<size_t>(matIt - _materials.begin()));
+
+    // greedy first fit: smallest color not yet used at either node
+    _nodeColors.resize(_nodes.size());
+    std::vector<bool> used(_elementColors.size() + 1, false);
+    for (size_t c : _nodeColors[i1]) used[c] = true;
+    for (size_t c : _nodeColors[i2]) used[c] = true;
+    size_t color = 0;
+    while (used[color]) ++color;
+
+    if (color == _elementColors.size()) _elementColors.emplace_back();
+    _elementColors[color].push_back(_elements.size());
+    _nodeColors[i1].push_back(color);
+    _nodeColors[i2].push_back(color);
+
     int id = _elements.size() + 1;
-    _elements.push_back(std::make_unique<TrussElement>(id, n1, n2, mat, A));
+    _elements.push_back(std::make_unique<TrussElement>(id, n1, n2, mat, el));
     return static_cast<TrussElement&>(*_elements.back());
 };
 
@@ -82,29 +288,235 @@ void TrussStructure::addForces(std::vector<int> dof, std::vector<double> forces)
     };
 };
 
+// Add load case
+size_t TrussStructure::addLoadCase(std::string name, std::vector<int> dof, std::vector<double> forces){
+
+    if (dof.size() != forces.size()){
+        throw std::invalid_argument("Given DOF and forces have different sizes! (TrussStructure::addLoadCase)");};
+
+    LoadCase loadCase;
+    loadCase.name = name;
+    for(size_t i = 0; i < dof.size(); ++i){
+
+        loadCase.forces.insert({dof[i],forces[i]});
+    };
+
+    _loadCases.push_back(loadCase);
+    return _loadCases.size() - 1;
+};
+
+void TrussStructure::clearLoadCases() {_loadCases.clear();};
+
 // Assemble stiffness matrices
 Matrix<double> TrussStructure::assembleStffMtx() const{
 
       size_t numNodes = _nodes.size();
-      size_t numEl = _elements.size();
       size_t numDOF = numNodes*3;
 
       // std::cout << '\n' << "numDOF: " << numDOF << std::endl;
 
       Matrix<double> globalStffMtx(numDOF,numDOF,0.0);
 
-      for (size_t i = 0; i < numEl; ++i){
-          Matrix<double> elStffMtx = _elements[i]->computeGlobalStiffnessMtx();
-          std::vector<int> DOFs = _elements[i]->getDOF();
+      this->forEachElementColored([&](size_t i){
+          FixedMatrix<double,6,6> elStffMtx = this->computeElementStiffness(i);
+          std::array<int,6> DOFs = this->getElementDOFs(i);
 
           for (size_t j = 0 ; j < 6 ; ++j){
               for (size_t k = 0; k < 6; ++k){
 
-                  globalStffMtx(DOFs[j]-1,DOFs[k]-1) = globalStffMtx(DOFs[j]-1,DOFs[k]-1) + elStffMtx(j,k);
+                  globalStffMtx.unchecked(DOFs[j]-1,DOFs[k]-1) += elStffMtx.unchecked(j,k);
 
               };
           };
+      });
+      return globalStffMtx;
+};
+
+// Bandwidth-reducing node renumbering
+std::vector<int> TrussStructure::renumberNodes(){
+
+    size_t numNodes = _nodes.size();
+    std::vector<size_t> order = reverseCuthillMcKee(this->createNodeGraph());
+
+    std::vector<int> newID(numNodes);
+    for (size_t k = 0; k < numNodes; ++k){
+        newID[order[k]] = k + 1;
+    };
+
+    // dof numbering follows the node ids
+    auto mapDOF = [&](int dof){
+        size_t node = (dof-1)/3;
+        if (dof < 1 || node >= numNodes) return dof;
+        return 3*newID[node] - 2 + (dof-1)%3;
+    };
+
+    std::map<int, bool> conditions;
+    for (const auto& bc : _boundaryConditions){
+        conditions.insert({mapDOF(bc.first), bc.second});
+    };
+    _boundaryConditions.swap(conditions);
+
+    std::map<int, double> forces;
+    for (const auto& f : _forces){
+        forces.insert({mapDOF(f.first), f.second});
+    };
+    _forces.swap(forces);
+
+    for (LoadCase& loadCase : _loadCases){
+        std::map<int, double> caseForces;
+        for (const auto& f : loadCase.forces){
+            caseForces.insert({mapDOF(f.first), f.second});
+        };
+        loadCase.forces.swap(caseForces);
+    };
+
+    // permute the coordinate arrays, then the node views follow their new IDs
+    NodeArrays xyz;
+    xyz.x.resize(numNodes);
+    xyz.y.resize(numNodes);
+    xyz.z.resize(numNodes);
+    for (size_t i = 0; i < numNodes; ++i){
+        xyz.x[newID[i]-1] = _nodeArrays->x[i];
+        xyz.y[newID[i]-1] = _nodeArrays->y[i];
+        xyz.z[newID[i]-1] = _nodeArrays->z[i];
+    };
+    xyz.revision = _nodeArrays->revision + 1;
+    *_nodeArrays = std::move(xyz);
+
+    ElementArrays& el = *_elementArrays;
+    for (size_t e = 0; e < el.node1.size(); ++e){
+        el.node1[e] = newID[el.node1[e]] - 1;
+        el.node2[e] = newID[el.node2[e]] - 1;
+    };
+
+    // the element coloring does not depend on the node numbering, only the node lookup moves
+    std::vector<std::vector<size_t>> nodeColors(numNodes);
+    for (size_t i = 0; i < _nodeColors.size(); ++i){
+        nodeColors[newID[i]-1] = std::move(_nodeColors[i]);
+    };
+    _nodeColors.swap(nodeColors);
+
+    std::vector<std::unique_ptr<Node>> nodes(numNodes);
+    for (size_t i = 0; i < numNodes; ++i){
+        _nodes[i]->setID(newID[i]);
+        nodes[newID[i]-1] = std::move(_nodes[i]);
+    };
+    _nodes.swap(nodes);
+
+    return newID;
+};
+
+// Node connectivity graph
+std::vector<std::vector<size_t>> TrussStructure::createNodeGraph() const{
+
+    std::vector<std::vector<size_t>> graph(_nodes.size());
+
+    const ElementArrays& el = *_elementArrays;
+    for (size_t i = 0; i < _elements.size(); ++i){
+        size_t a = el.node1[i];
+        size_t b = el.node2[i];
+
+        graph[a].push_back(b);
+        graph[b].push_back(a);
+    };
+
+    for (auto& neighbours : graph){
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    };
+
+    return graph;
+};
+
+// Element geometry from the structure-of-arrays storage
+double TrussStructure::computeElementDirection(size_t e, std::array<double,3>& c) const{
+
+    const NodeArrays& xyz = *_nodeArrays;
+    size_t a = _elementArrays->node1[e];
+    size_t b = _elementArrays->node2[e];
+
+    c = {xyz.x[b] - xyz.x[a], xyz.y[b] - xyz.y[a], xyz.z[b] - xyz.z[a]};
+    double L = std::sqrt(c[0]*c[0] + c[1]*c[1] + c[2]*c[2]);
+    for (double& ci : c) ci /= L;
+
+    return L;
+};
+
+double TrussStructure::computeAxialStiffness(size_t e, double L) const{
+
+    return _materials[_elementArrays->material[e]].getE()*_elementArrays->area[e]/L;
+};
+
+std::array<int,6> TrussStructure::getElementDOFs(size_t e) const{
+
+    int a = 3*static_cast<int>(_elementArrays->node1[e]);
+    int b = 3*static_cast<int>(_elementArrays->node2[e]);
+    return {a+1, a+2, a+3, b+1, b+2, b+3};
+};
+
+FixedMatrix<double,6,6> TrussStructure::computeElementStiffness(size_t e) const{
+
+    std::array<double,3> c;
+    double L = this->computeElementDirection(e, c);
+    return TrussElement::computeGlobalStiffnessFixedMtx(c, this->computeAxialStiffness(e, L));
+};
+
+// Element coloring, elements of one color share no node
+std::vector<std::vector<size_t>> TrussStructure::createElementColoring() const{
+
+    return _elementColors;
+};
+
+void TrussStructure::forEachElementColored(const std::function<void(size_t)>& f) const{
+
+    // elements per task, amortizes the scheduling
+    parallelForEachGroup(_elementColors, 256, f);
+};
+
+// Sparsity pattern of the stiffness matrix
+SparseMatrix<double> TrussStructure::createSparsityPattern() const{
+
+      size_t numDOF = _nodes.size()*3;
+
+      std::vector<std::vector<size_t>> pattern(numDOF);
+
+      for (size_t i = 0; i < _elements.size(); ++i){
+          std::array<int,6> DOFs = this->getElementDOFs(i);
+
+          for (size_t j = 0; j < DOFs.size(); ++j){
+              for (size_t k = 0; k < DOFs.size(); ++k){
+
+                  pattern[DOFs[j]-1].push_back(DOFs[k]-1);
+              };
+          };
       };
+
+      return SparseMatrix<double>(numDOF, numDOF, std::move(pattern));
+};
+
+// Fill sparse stiffness matrix
+void TrussStructure::fillSparseStffMtx(SparseMatrix<double>& globStffMtx) const{
+
+      globStffMtx.setZero();
+
+      this->forEachElementColored([&](size_t i){
+          FixedMatrix<double,6,6> elStffMtx = this->computeElementStiffness(i);
+          std::array<int,6> DOFs = this->getElementDOFs(i);
+
+          for (size_t j = 0 ; j < 6 ; ++j){
+              for (size_t k = 0; k < 6; ++k){
+
+                  globStffMtx.addValue(DOFs[j]-1, DOFs[k]-1, elStffMtx.unchecked(j,k));
+              };
+          };
+      });
+};
+
+// Assemble sparse stiffness matrix
+SparseMatrix<double> TrussStructure::assembleSparseStffMtx() const{
+
+      SparseMatrix<double> globalStffMtx = this->createSparsityPattern();
+      this->fillSparseStffMtx(globalStffMtx);
       return globalStffMtx;
 };
 
@@ -122,39 +534,487 @@ std::vector<double> TrussStructure::createForceVector() const{
     return forceVec;
 };
 
+// Free dof numbering
+std::vector<long> TrussStructure::createFreeDOFMap() const{
+
+    size_t numDOF = _nodes.size()*3;
+    std::vector<long> freeMap(numDOF, 0);
+
+    for (const auto& bc : _boundaryConditions){
+        if (bc.second && bc.first >= 1 && static_cast<size_t>(bc.first) <= numDOF){
+            freeMap[bc.first-1] = -1;
+        };
+    };
+
+    long counter = 0;
+    for (size_t i = 0; i < numDOF; ++i){
+        if (freeMap[i] == 0){
+            freeMap[i] = counter++;
+        };
+    };
+    return freeMap;
+};
+
+// Assemble reduced stiffness matrix
+Matrix<double> TrussStructure::assembleReducedStffMtx() const{
+
+      std::vector<long> freeMap = this->createFreeDOFMap();
+      size_t numFree = std::count_if(freeMap.begin(), freeMap.end(), [](long i){ return i >= 0; });
+
+      Matrix<double> globalStffMtx(numFree,numFree,0.0);
+
+      this->forEachElementColored([&](size_t i){
+          FixedMatrix<double,6,6> elStffMtx = this->computeElementStiffness(i);
+          std::array<int,6> DOFs = this->getElementDOFs(i);
+
+          for (size_t j = 0 ; j < 6 ; ++j){
+              long r = freeMap[DOFs[j]-1];
+              if (r < 0) continue;
+
+              for (size_t k = 0; k < 6; ++k){
+                  long c = freeMap[DOFs[k]-1];
+                  if (c < 0) continue;
+
+                  globalStffMtx.unchecked(r,c) += elStffMtx.unchecked(j,k);
+              };
+          };
+      });
+      return globalStffMtx;
+};
+
+// Fill reduced stiffness matrix in packed storage
+template<typename T>
+void TrussStructure::fillReducedPackedStffMtx(PackedMatrix<T>& globStffMtx, const std::vector<long>& freeMap) const{
+
+      this->forEachElementColored([&](size_t i){
+          FixedMatrix<double,6,6> elStffMtx = this->computeElementStiffness(i);
+          std::array<int,6> DOFs = this->getElementDOFs(i);
+
+          for (size_t j = 0 ; j < 6 ; ++j){
+              long r = freeMap[DOFs[j]-1];
+              if (r < 0) continue;
+
+              for (size_t k = 0; k < 6; ++k){
+                  long c = freeMap[DOFs[k]-1];
+                  if (c < 0 || c > r) continue;
+
+                  globStffMtx.unchecked(r,c) += static_cast<T>(elStffMtx.unchecked(j,k));
+              };
+          };
+      });
+};
+
+// Assemble reduced stiffness matrix into packed storage
+PackedMatrix<double> TrussStructure::assembleReducedPackedStffMtx() const{
+
+      std::vector<long> freeMap = this->createFreeDOFMap();
+      size_t numFree = std::count_if(freeMap.begin(), freeMap.end(), [](long i){ return i >= 0; });
+
+      PackedMatrix<double> globalStffMtx(numFree);
+      this->fillReducedPackedStffMtx(globalStffMtx, freeMap);
+      return globalStffMtx;
+};
+
+// Create reduced force vector
+std::vector<double> TrussStructure::createReducedForceVector() const{
+
+    std::vector<double> forceVec = this->createForceVector();
+    std::vector<long> freeMap = this->createFreeDOFMap();
+
+    size_t counter = 0;
+    for (size_t i = 0; i < forceVec.size(); ++i){
+        if (freeMap[i] >= 0){
+            forceVec[counter++] = forceVec[i];
+        };
+    };
+    forceVec.resize(counter);
+    return forceVec;
+};
+
 // Apply boundary conditions
 void TrussStructure::applyHomBCs(Matrix<double>& globStffMtx, std::vector<double>& forceVec) const{
 
     std::vector<size_t> homDOF;
     for (const auto& bc : _boundaryConditions){
         if (bc.second){
-            homDOF.push_back(bc.first);
+            homDOF.push_back(bc.first-1);
+        };
+    };
+
+    if (homDOF.empty()) return;
+
+    globStffMtx.deleteRowsColumns(homDOF);
+
+    // homDOF is now sorted and unique, compact the force vector in one pass
+    size_t counter = 0;
+    for (size_t i = 0, d = 0; i < forceVec.size(); ++i){
+        if (d < homDOF.size() && homDOF[d] == i){
+            ++d;
+        }
+        else {
+            forceVec[counter++] = forceVec[i];
         };
     };
+    forceVec.resize(counter);
+};
+
+// Apply boundary conditions to sparse system
+void TrussStructure::applyHomBCs(SparseMatrix<double>& globStffMtx, std::vector<double>& forceVec) const{
 
-    std::sort(homDOF.begin(),homDOF.end(),std::greater<int>());
+    size_t numDOF = 3*_nodes.size();
+    std::vector<size_t> size = globStffMtx.getSize();
+    if (size[0] != numDOF || size[1] != numDOF){
+        throw std::invalid_argument("Stiffness matrix size does not match the number of DOF! (TrussStructure::applyHomBCs)");};
+    if (forceVec.size() != numDOF){
+        throw std::invalid_argument("Force vector size does not match the number of DOF! (TrussStructure::applyHomBCs)");};
 
-        for (size_t i = 0; i < homDOF.size(); i++){
-            globStffMtx.deleteRow(homDOF[i]-1);
-            globStffMtx.deleteColumn(homDOF[i]-1);
+    std::vector<long> freeMap = this->createFreeDOFMap();
 
-            forceVec.erase(forceVec.begin() + homDOF[i]-1);
+    std::vector<size_t> freeDOF;
+    std::vector<double> freeForces;
+    for (size_t i = 0; i < forceVec.size(); ++i){
+        if (freeMap[i] >= 0){
+            freeDOF.push_back(i);
+            freeForces.push_back(forceVec[i]);
         };
+    };
+
+    globStffMtx = globStffMtx.extractSubmatrix(freeDOF);
+    forceVec.swap(freeForces);
+};
+
+// Assemble reduced sparse stiffness matrix
+SparseMatrix<double> TrussStructure::assembleReducedSparseStffMtx() const{
+
+    std::vector<long> freeMap = this->createFreeDOFMap();
+
+    std::vector<size_t> freeDOF;
+    for (size_t i = 0; i < freeMap.size(); ++i){
+        if (freeMap[i] >= 0) freeDOF.push_back(i);
+    };
+
+    return this->assembleSparseStffMtx().extractSubmatrix(freeDOF);
+};
+
+// Preconditioner of the sparse PCG solver, built once
+template<typename F>
+void TrussStructure::withPCGPreconditioner(const SparseMatrix<double>& K, F&& f) const{
+
+    switch (_pcgPreconditioner){
+        case PreconditionerType::Jacobi:
+            f(JacobiPreconditioner<double>(K));
+            break;
+        case PreconditionerType::SSOR:
+            f(SSORPreconditioner<double>(K, _ssorOmega));
+            break;
+        case PreconditionerType::IncompleteCholesky:
+            f(IncompleteCholeskyPreconditioner<double>(K));
+            break;
+        default:
+            f(IdentityPreconditioner<double>());
+            break;
+    };
+};
+
+// Preconditioner of the matrix-free solver, built once
+template<typename F>
+void TrussStructure::withPCGPreconditioner(const TrussStiffnessOperator& K, F&& f) const{
+
+    if (_pcgPreconditioner == PreconditionerType::None){
+        f(IdentityPreconditioner<double>());
+    }
+    else {
+        f(JacobiPreconditioner<double>(K.getDiagonal()));
+    };
+};
+
+// Fill-reducing ordering of the reduced system
+std::vector<size_t> TrussStructure::computeFillReducingOrdering() const{
+
+    std::vector<std::vector<size_t>> graph = this->createNodeGraph();
+
+    std::vector<std::array<double,3>> coordinates;
+    coordinates.reserve(_nodes.size());
+    for (const std::unique_ptr<Node>& node : _nodes) coordinates.push_back(node->getCoordinates());
+
+    // nested dissection wins on bulky 2D and 3D structures, minimum degree and the banded
+    // reverse Cuthill-McKee order on slender ones, the predicted factor size decides
+    std::vector<size_t> nodeOrder = nestedDissectionOrdering(graph, coordinates);
+    size_t nnz = choleskyFactorNonzeros(graph, nodeOrder);
+    for (std::vector<size_t> candidate : {approximateMinimumDegreeOrdering(graph), reverseCuthillMcKee(graph)}){
+        size_t candidateNNZ = choleskyFactorNonzeros(graph, candidate);
+        if (candidateNNZ < nnz){
+            nnz = candidateNNZ;
+            nodeOrder = std::move(candidate);
+        };
+    };
+
+    std::vector<long> freeMap = this->createFreeDOFMap();
+
+    std::vector<size_t> perm;
+    perm.reserve(freeMap.size());
+    for (size_t node : nodeOrder){
+        for (size_t d = 0; d < 3; ++d){
+            if (freeMap[3*node+d] >= 0){
+                perm.push_back(freeMap[3*node+d]);
+            };
+        };
+    };
+    return perm;
 };
 
 // Solve truss system
 std::vector<double> TrussStructure::solveTrussSystem() const{
 
-    Matrix<double> K_master = this->assembleStffMtx();
-    std::vector<double> F_master = this->createForceVector();
+    if (_solverType == SolverType::MixedPrecision){
+
+        RefinementReport<double> report;
+        std::vector<double> u_full = this->solveTrussSystemMixedPrecision(report);
+
+        if (!report.converged){
+            throw std::runtime_error("Iterative refinement did not reach the tolerance! (TrussStructure::solveTrussSystem)");};
+        return u_full;
+    };
+
+    if (_solverType == SolverType::PCG || _solverType == SolverType::MatrixFree){
 
-    this->applyHomBCs(K_master, F_master);
+        CGReport<double> report;
+        std::vector<double> u_full = (_solverType == SolverType::PCG) ? this->solveTrussSystemPCG(report)
+                                                                       : this->solveTrussSystemMatrixFree(report);
 
-    Matrix<double> L = K_master.cho();
+        if (!report.converged){
+            throw std::runtime_error("PCG did not converge within the iteration cap! (TrussStructure::solveTrussSystem)");};
+        return u_full;
+    };
 
-    Matrix<double> L_inverse = L.L_inverse();
+    std::vector<double> F_red = this->createReducedForceVector();
+    std::vector<double> u;
 
-    std::vector<double> u = L_inverse.transpose().mVm(L_inverse.mVm(F_master));
+    if (_solverType == SolverType::Sparse){
+
+        SparseMatrix<double> K_red = this->assembleReducedSparseStffMtx();
+
+        SparseCholesky<double> chol(K_red, this->computeFillReducingOrdering());
+        u = chol.solve(F_red);
+    }
+    else if (_solverType == SolverType::Skyline){
+
+        SkylineMatrix<double> L = SkylineMatrix<double>(this->assembleReducedSparseStffMtx()).cho();
+
+        std::vector<double> y = L.forwardSubstitution(F_red);
+        u = L.transposedBackwardSubstitution(y);
+    }
+    else {
+
+        PackedMatrix<double> L = this->assembleReducedPackedStffMtx();
+
+        L.choInPlace();
+
+        // K = L*L^T, solve L*y = F and L^T*u = y without forming an inverse
+        std::vector<double> y = L.forwardSubstitution(F_red);
+        u = L.transposedBackwardSubstitution(y);
+    };
+
+    std::vector<double> u_full = this->returnDispVector(u);
+    return u_full;
+};
+
+// Reduced force matrix of all load cases
+Matrix<double> TrussStructure::createReducedForceMatrix() const{
+
+    std::vector<long> freeMap = this->createFreeDOFMap();
+    size_t numFree = std::count_if(freeMap.begin(), freeMap.end(), [](long i){ return i >= 0; });
+    size_t numCases = _loadCases.size();
+
+    Matrix<double> F(numFree, numCases, 0.0);
+
+    for (size_t c = 0; c < numCases; ++c){
+        for (const auto& f : _loadCases[c].forces){
+
+            size_t dof = f.first - 1;
+            if (f.first < 1 || dof >= freeMap.size()){
+                throw std::out_of_range("Load case force on a nonexistent DOF! (TrussStructure::createReducedForceMatrix)");};
+
+            if (freeMap[dof] >= 0){
+                F(freeMap[dof], c) += f.second;
+            };
+        };
+    };
+    return F;
+};
+
+// Solve all load cases
+std::vector<LoadCaseResult> TrussStructure::solveLoadCases() const{
+
+    size_t numCases = _loadCases.size();
+    std::vector<LoadCaseResult> results(numCases);
+    if (numCases == 0) return results;
+
+    Matrix<double> F = this->createReducedForceMatrix();
+    Matrix<double> U;
+
+    if (_solverType == SolverType::Sparse){
+
+        SparseCholesky<double> chol(this->assembleReducedSparseStffMtx(), this->computeFillReducingOrdering());
+        U = chol.blockSolve(F);
+    }
+    else if (_solverType == SolverType::Skyline){
+
+        SkylineMatrix<double> L = SkylineMatrix<double>(this->assembleReducedSparseStffMtx()).cho();
+        U = L.blockTransposedBackwardSubstitution(L.blockForwardSubstitution(F));
+    }
+    else if (_solverType == SolverType::Dense){
+
+        PackedMatrix<double> L = this->assembleReducedPackedStffMtx();
+        L.choInPlace();
+        U = L.blockTransposedBackwardSubstitution(L.blockForwardSubstitution(F));
+    }
+    else if (_solverType == SolverType::MixedPrecision){
+
+        size_t numFree = F.getSize()[0];
+        auto [L, K_master] = this->factorizeMixedPrecision();
+        double normK = K_master.frobeniusNorm();
+
+        U = Matrix<double>(numFree, numCases, 0.0);
+
+        for (size_t c = 0; c < numCases; ++c){
+
+            std::vector<double> f(numFree);
+            VectorView<const double> Fc = F.column(c);
+            for (size_t i = 0; i < numFree; ++i) f[i] = Fc[i];
+
+            RefinementReport<double> report;
+            std::vector<double> u = iterativeRefinement(K_master, normK, L, f, _refinementTolerance,
+                                                        _refinementMaxIterations, report);
+
+            if (!report.converged){
+                throw std::runtime_error("Iterative refinement did not reach the tolerance! (TrussStructure::solveLoadCases)");};
+
+            VectorView<double> Uc = U.column(c);
+            for (size_t i = 0; i < numFree; ++i) Uc[i] = u[i];
+        };
+    }
+    else {
+
+        // iterative solvers have no factorization to share, solve one load case at a time
+        // with the operator and preconditioner built once
+        size_t numFree = F.getSize()[0];
+        U = Matrix<double>(numFree, numCases, 0.0);
+
+        auto solveCases = [&](const auto& K, const auto& M){
+
+            std::vector<double> f(numFree);
+            for (size_t c = 0; c < numCases; ++c){
+
+                VectorView<const double> Fc = F.column(c);
+                for (size_t i = 0; i < numFree; ++i) f[i] = Fc[i];
+
+                CGReport<double> report;
+                std::vector<double> u = conjugateGradient(K, f, M, _pcgTolerance, _pcgMaxIterations, report);
+
+                if (!report.converged){
+                    throw std::runtime_error("PCG did not converge within the iteration cap! (TrussStructure::solveLoadCases)");};
+
+                VectorView<double> Uc = U.column(c);
+                for (size_t i = 0; i < numFree; ++i) Uc[i] = u[i];
+            };
+        };
+
+        if (_solverType == SolverType::PCG){
+            SparseMatrix<double> K_red = this->assembleReducedSparseStffMtx();
+            this->withPCGPreconditioner(K_red, [&](const auto& M){ solveCases(K_red, M); });
+        }
+        else {
+            TrussStiffnessOperator K_op(*this);
+            this->withPCGPreconditioner(K_op, [&](const auto& M){ solveCases(K_op, M); });
+        };
+    };
+
+    size_t numFree = U.getSize()[0];
+    std::vector<double> u_red(numFree);
+
+    size_t numEl = _elements.size();
+    std::vector<const std::vector<double>*> displacements(numCases);
+    std::vector<ElementResults*> elementResults(numCases);
+
+    for (size_t c = 0; c < numCases; ++c){
+
+        VectorView<const double> Uc = U.column(c);
+        for (size_t i = 0; i < numFree; ++i) u_red[i] = Uc[i];
+
+        results[c].name = _loadCases[c].name;
+        results[c].displacements = this->returnDispVector(u_red);
+        results[c].strains.resize(numEl);
+        results[c].stresses.resize(numEl);
+        results[c].axialForces.resize(numEl);
+        results[c].utilizations.resize(numEl);
+        displacements[c] = &results[c].displacements;
+        elementResults[c] = &results[c];
+    };
+
+    // one sweep over the elements for all load cases
+    this->recoverElementResults(displacements, elementResults);
+
+    return results;
+};
+
+// Reusable solver
+TrussSolver TrussStructure::createSolver() const{
+
+    return TrussSolver(*this);
+};
+
+// Solve truss system iteratively
+std::vector<double> TrussStructure::solveTrussSystemPCG(CGReport<double>& report) const{
+
+    SparseMatrix<double> K_red = this->assembleReducedSparseStffMtx();
+    std::vector<double> F_red = this->createReducedForceVector();
+
+    std::vector<double> u;
+    this->withPCGPreconditioner(K_red, [&](const auto& M){
+        u = conjugateGradient(K_red, F_red, M, _pcgTolerance, _pcgMaxIterations, report);
+    });
+
+    std::vector<double> u_full = this->returnDispVector(u);
+    return u_full;
+};
+
+// Solve truss system without assembly
+std::vector<double> TrussStructure::solveTrussSystemMatrixFree(CGReport<double>& report) const{
+
+    TrussStiffnessOperator K_op(*this);
+    std::vector<double> F_red = this->createReducedForceVector();
+
+    std::vector<double> u;
+    this->withPCGPreconditioner(K_op, [&](const auto& M){
+        u = conjugateGradient(K_op, F_red, M, _pcgTolerance, _pcgMaxIterations, report);
+    });
+
+    std::vector<double> u_full = this->returnDispVector(u);
+    return u_full;
+};
+
+// Factorize the reduced system in single precision
+std::pair<PackedMatrix<float>, SparseMatrix<double>> TrussStructure::factorizeMixedPrecision() const{
+
+    std::vector<long> freeMap = this->createFreeDOFMap();
+    size_t numFree = std::count_if(freeMap.begin(), freeMap.end(), [](long i){ return i >= 0; });
+
+    PackedMatrix<float> L(numFree);
+    this->fillReducedPackedStffMtx(L, freeMap);
+    L.choInPlace();
+
+    return {std::move(L), this->assembleReducedSparseStffMtx()};
+};
+
+// Solve truss system with a single precision factorization
+std::vector<double> TrussStructure::solveTrussSystemMixedPrecision(RefinementReport<double>& report) const{
+
+    auto [L, K_master] = this->factorizeMixedPrecision();
+    std::vector<double> F_master = this->createReducedForceVector();
+
+    std::vector<double> u = iterativeRefinement(K_master, K_master.frobeniusNorm(), L, F_master, _refinementTolerance,
+                                                _refinementMaxIterations, report);
 
     std::vector<double> u_full = this->returnDispVector(u);
     return u_full;
@@ -167,13 +1027,12 @@ std::vector<double> TrussStructure::returnDispVector(std::vector<double>& u_red)
 
   std::vector<double> u(numDOF,0.0);
 
-  int counter = 0;
+  std::vector<long> freeMap = this->createFreeDOFMap();
   for (int i = 0; i < numDOF; ++i){
-      if (_boundaryConditions.find(i+1) == _boundaryConditions.end()){
+      if (freeMap[i] >= 0){
 
-        // if key does not exist
-        u[i] = u_red[counter];
-        counter++;
+        // free dof
+        u[i] = u_red[freeMap[i]];
       };
   };
   return u;
@@ -181,27 +1040,117 @@ std::vector<double> TrussStructure::returnDispVector(std::vector<double>& u_red)
 
 std::vector<double> TrussStructure::computeStrains(std::vector<double>& u) const{
 
-    int numEl = _elements.size();
-    std::vector<double> strains(numEl, 0.0);
+    ElementResults results;
+    results.strains.resize(_elements.size());
+    this->recoverElementResults({&u}, {&results});
+    return results.strains;
+};
 
-    for (int i = 0; i < numEl; ++i){
+std::vector<double> TrussStructure::computeStresses(std::vector<double>& u) const{
 
-        strains[i] = _elements[i]->computeElStrain(u);
+    ElementResults results;
+    results.stresses.resize(_elements.size());
+    this->recoverElementResults({&u}, {&results});
+    return results.stresses;
+};
 
-    };
+ElementResults TrussStructure::computeElementResults(const std::vector<double>& u) const{
 
-    return strains;
+    size_t numEl = _elements.size();
+    ElementResults results{std::vector<double>(numEl), std::vector<double>(numEl),
+                           std::vector<double>(numEl), std::vector<double>(numEl)};
+    this->recoverElementResults({&u}, {&results});
+    return results;
 };
 
-std::vector<double> TrussStructure::computeStresses(std::vector<double>& u) const{
+// Fused element recovery
+void TrussStructure::recoverElementResults(const std::vector<const std::vector<double>*>& u,
+                                           const std::vector<ElementResults*>& results) const{
 
-    int numEl = _elements.size();
-    std::vector<double> stresses(numEl, 0.0);
+    size_t numEl = _elements.size();
+    size_t numDOF = 3*_nodes.size();
+    size_t numVec = u.size();
 
-    for (int i = 0; i < numEl; ++i){
+    if (results.size() != numVec){
+        throw std::invalid_argument("Number of results does not match! (TrussStructure::recoverElementResults)");};
 
-        stresses[i] = _elements[i]->computeElStress(u);
+    auto wanted = [numEl](std::vector<double>& values){
+        if (!values.empty() && values.size() != numEl){
+            throw std::invalid_argument("Result size does not match the number of elements! (TrussStructure::recoverElementResults)");};
+        return values.empty() ? nullptr : values.data();
+    };
+
+    // output pointers per displacement vector, nullptr for skipped quantities
+    std::vector<std::array<double*,4>> out(numVec);
+    for (size_t v = 0; v < numVec; ++v){
+        if (u[v]->size() != numDOF){
+            throw std::invalid_argument("Displacement vector size does not match! (TrussStructure::recoverElementResults)");};
 
+        out[v] = {wanted(results[v]->strains), wanted(results[v]->stresses),
+                  wanted(results[v]->axialForces), wanted(results[v]->utilizations)};
     };
-    return stresses;
+
+    const ElementArrays& el = *_elementArrays;
+    const NodeArrays& xyz = *_nodeArrays;
+
+    // material data as flat tables, the deque is not touched inside the element loop
+    std::vector<double> matE(_materials.size()), matInvAllowable(_materials.size());
+    for (size_t m = 0; m < _materials.size(); ++m){
+        matE[m] = _materials[m].getE();
+        double allowable = _materials[m].getAllowableStress();
+        matInvAllowable[m] = (allowable > 0.0) ? 1.0/allowable : 0.0;
+    };
+
+    // every element writes only its own entries
+    const size_t chunk = 1024;
+    parallelFor((numEl + chunk - 1)/chunk, [&](size_t t){
+
+        size_t first = t*chunk;
+        size_t len = std::min(numEl, first + chunk) - first;
+
+        // c/L = (x2 - x1)/L^2, E, EA and 1/allowable stress of the block, shared by all displacement vectors
+        std::vector<double> cL(3*len), E(len), EA(len), invAllowable(len);
+        for (size_t k = 0; k < len; ++k){
+
+            size_t e = first + k;
+            size_t a = el.node1[e];
+            size_t b = el.node2[e];
+            double dx = xyz.x[b] - xyz.x[a];
+            double dy = xyz.y[b] - xyz.y[a];
+            double dz = xyz.z[b] - xyz.z[a];
+            double invL2 = 1.0/(dx*dx + dy*dy + dz*dz);
+
+            cL[3*k] = dx*invL2;
+            cL[3*k+1] = dy*invL2;
+            cL[3*k+2] = dz*invL2;
+            E[k] = matE[el.material[e]];
+            EA[k] = E[k]*el.area[e];
+            invAllowable[k] = matInvAllowable[el.material[e]];
+        };
+
+        const size_t* n1 = el.node1.data() + first;
+        const size_t* n2 = el.node2.data() + first;
+
+        for (size_t v = 0; v < numVec; ++v){
+
+            const double* uv = u[v]->data();
+            double* strain = out[v][0] ? out[v][0] + first : nullptr;
+            double* stress = out[v][1] ? out[v][1] + first : nullptr;
+            double* force = out[v][2] ? out[v][2] + first : nullptr;
+            double* util = out[v][3] ? out[v][3] + first : nullptr;
+
+            for (size_t k = 0; k < len; ++k){
+
+                // elongation c^T (u2 - u1) over the length
+                const double* u1 = uv + 3*n1[k];
+                const double* u2 = uv + 3*n2[k];
+                double eps = cL[3*k]*(u2[0] - u1[0]) + cL[3*k+1]*(u2[1] - u1[1]) + cL[3*k+2]*(u2[2] - u1[2]);
+
+                if (strain) strain[k] = eps;
+                if (stress) stress[k] = E[k]*eps;
+                if (force) force[k] = EA[k]*eps;
+                if (util) util[k] = std::abs(E[k]*eps)*invAllowable[k];
+            };
+        };
+    });
 };
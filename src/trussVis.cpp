@@ -7,10 +7,10 @@ TrussVisualization::TrussVisualization(TrussStructure& trussSystem)
 
     // --- Points ---
     points = vtkSmartPointer<vtkPoints>::New();
+    const NodeArrays& xyz = trussSystem.getNodeArrays();
     for (int i = 0; i < numNodes; ++i)
     {
-        std::vector<double> pos = trussSystem.getNodes()[i]->getPosition();
-        points->InsertNextPoint(pos[0], pos[1], pos[2]);
+        points->InsertNextPoint(xyz.x[i], xyz.y[i], xyz.z[i]);
     }
 
     // --- Grid ---
@@ -19,13 +19,12 @@ TrussVisualization::TrussVisualization(TrussStructure& trussSystem)
 
     if (numElems > 0)
     {
+        const ElementArrays& el = trussSystem.getElementArrays();
         for (int e = 0; e < numElems; ++e)
         {
             vtkNew<vtkLine> line;
-            Node& n1 = trussSystem.getElements()[e]->getNode1();
-            Node& n2 = trussSystem.getElements()[e]->getNode2();
-            line->GetPointIds()->SetId(0, n1.getID() - 1);
-            line->GetPointIds()->SetId(1, n2.getID() - 1);
+            line->GetPointIds()->SetId(0, el.node1[e]);
+            line->GetPointIds()->SetId(1, el.node2[e]);
             ugrid->InsertNextCell(VTK_LINE, line->GetPointIds());
         }
     }
@@ -74,13 +73,14 @@ void TrussVisualization::addFixedJoints(TrussStructure& trussSystem)
 {
 
     std::map<int, bool> mp = trussSystem.getConditions();
-    for (auto& node : trussSystem.getNodes())
+    const NodeArrays& xyz = trussSystem.getNodeArrays();
+    for (size_t i = 0; i < xyz.x.size(); ++i)
     {
-        int id = node->getID();
+        int id = i + 1;
         int dofx = 3*id-2;
         int dofy = 3*id-1;
         int dofz = 3*id;
-        std::vector<double> pos = node->getPosition();
+        double pos[3] = {xyz.x[i], xyz.y[i], xyz.z[i]};
 
         // X displacement fixed
         if (mp.find(dofx) != mp.end())
@@ -172,13 +172,16 @@ void TrussVisualization::updateScalarField(TrussStructure& trussSystem,
     scalarArray->SetNumberOfTuples(numElements);
     scalarArray->SetName(field.c_str());
 
+    // element fields are recovered in one pass over the structure-of-arrays storage
+    std::vector<double> values;
+    if (field == "stress")
+        values = trussSystem.computeStresses(displacementVec);
+    else if (field == "strain")
+        values = trussSystem.computeStrains(displacementVec);
+
     for (int e = 0; e < numElements; ++e)
     {
-        double val = 0.0;
-        if (field == "stress")
-            val = std::abs(trussSystem.getElements()[e]->computeElStress(displacementVec));
-        else if (field == "strain")
-            val = std::abs(trussSystem.getElements()[e]->computeElStrain(displacementVec));
+        double val = values.empty() ? 0.0 : std::abs(values[e]);
         scalarArray->SetValue(e, val);
     }
 
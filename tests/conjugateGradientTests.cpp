@@ -0,0 +1,95 @@
+#include "../include/math/ConjugateGradient.h"
+#include <gtest/gtest.h>
+
+// 1D Laplacian with a weak spring to ground, SPD and slowly converging
+static SparseMatrix<double> springChain(size_t n)
+{
+    std::vector<std::vector<size_t>> pattern(n);
+    for (size_t i = 0; i < n; ++i){
+        pattern[i].push_back(i);
+        if (i > 0)   pattern[i].push_back(i-1);
+        if (i+1 < n) pattern[i].push_back(i+1);
+    }
+
+    SparseMatrix<double> A(n, n, pattern);
+    for (size_t i = 0; i < n; ++i){
+        A(i,i) = 2.0 + 1e-2*(i+1);
+        if (i > 0)   A(i,i-1) = -1.0;
+        if (i+1 < n) A(i,i+1) = -1.0;
+    }
+    return A;
+}
+
+static double maxResidual(const SparseMatrix<double>& A, const std::vector<double>& x, const std::vector<double>& b)
+{
+    std::vector<double> Ax = A.mVm(x);
+    double m = 0.0;
+    for (size_t i = 0; i < b.size(); ++i){
+        m = std::max(m, std::abs(Ax[i] - b[i]));
+    }
+    return m;
+}
+
+TEST(ConjugateGradientTest, AllPreconditionersConverge)
+{
+    size_t n = 60;
+    SparseMatrix<double> A = springChain(n);
+    std::vector<double> b(n, 1.0);
+
+    CGReport<double> plain, jacobi, ssor, ic;
+
+    std::vector<double> x0 = conjugateGradient(A, b, IdentityPreconditioner<double>(), 1e-12, 500, plain);
+    std::vector<double> x1 = conjugateGradient(A, b, JacobiPreconditioner<double>(A), 1e-12, 500, jacobi);
+    std::vector<double> x2 = conjugateGradient(A, b, SSORPreconditioner<double>(A, 1.5), 1e-12, 500, ssor);
+    std::vector<double> x3 = conjugateGradient(A, b, IncompleteCholeskyPreconditioner<double>(A), 1e-12, 500, ic);
+
+    for (const CGReport<double>* r : {&plain, &jacobi, &ssor, &ic}){
+        EXPECT_TRUE(r->converged);
+        EXPECT_EQ(r->residualHistory.size(), r->iterations + 1);
+        EXPECT_DOUBLE_EQ(r->residualHistory.front(), 1.0);
+        EXPECT_LT(r->residualHistory.back(), 1e-12);
+    }
+
+    EXPECT_LT(maxResidual(A, x0, b), 1e-9);
+    EXPECT_LT(maxResidual(A, x1, b), 1e-9);
+    EXPECT_LT(maxResidual(A, x2, b), 1e-9);
+    EXPECT_LT(maxResidual(A, x3, b), 1e-9);
+
+    // tridiagonal: IC(0) is the exact Cholesky factor
+    EXPECT_LE(ic.iterations, 2);
+    EXPECT_DOUBLE_EQ(IncompleteCholeskyPreconditioner<double>(A).getShift(), 0.0);
+    EXPECT_LT(ssor.iterations, plain.iterations);
+}
+
+TEST(ConjugateGradientTest, IterationCapIsReported)
+{
+    SparseMatrix<double> A = springChain(100);
+    std::vector<double> b(100, 1.0);
+
+    CGReport<double> report;
+    conjugateGradient(A, b, IdentityPreconditioner<double>(), 1e-14, 3, report);
+
+    EXPECT_FALSE(report.converged);
+    EXPECT_EQ(report.iterations, 3);
+    EXPECT_EQ(report.residualHistory.size(), 4);
+
+    EXPECT_THROW(SSORPreconditioner<double>(A, 2.0), std::invalid_argument);
+}
+
+TEST(ConjugateGradientTest, WorksOnDenseOperator)
+{
+    Matrix<double> K = {{4.0, 1.0, 0.5},
+                        {1.0, 3.0, 0.2},
+                        {0.5, 0.2, 2.0}};
+    std::vector<double> F = {1.0, 2.0, 3.0};
+
+    CGReport<double> report;
+    std::vector<double> u = conjugateGradient(K, F, IdentityPreconditioner<double>(), 1e-14, 10, report);
+
+    EXPECT_TRUE(report.converged);
+    EXPECT_LE(report.iterations, 4);
+    std::vector<double> r = K.mVm(u);
+    for (size_t i = 0; i < 3; ++i){
+        EXPECT_NEAR(r[i], F[i], 1e-12);
+    }
+}
@@ -0,0 +1,55 @@
+#include "../include/math/FixedMatrix.h"
+#include <gtest/gtest.h>
+
+TEST(FixedMatrixTest, ListConstructionAndAccess)
+{
+    FixedMatrix<int,2,3> M = {{1,2,3}, {4,5,6}};
+
+    EXPECT_EQ(M.getSize()[0], 2);
+    EXPECT_EQ(M.getSize()[1], 3);
+    EXPECT_EQ(M(1,2), 6);
+
+    M(0,1) = 7;
+    EXPECT_EQ(M.data()[1], 7);
+
+    FixedMatrix<int,2,2> Z;
+    EXPECT_EQ(Z(0,0), 0);
+    EXPECT_EQ(Z(1,1), 0);
+
+    EXPECT_THROW(M(2,0), std::out_of_range);
+    EXPECT_THROW(M(0,3), std::out_of_range);
+    EXPECT_THROW((FixedMatrix<int,2,2>{{1,2}}), std::invalid_argument);
+    EXPECT_THROW((FixedMatrix<int,2,2>{{1,2}, {3}}), std::invalid_argument);
+}
+
+TEST(FixedMatrixTest, ArithmeticMatchesMatrix)
+{
+    FixedMatrix<double,2,3> A = {{1,2,3}, {4,5,6}};
+    FixedMatrix<double,3,2> B = {{1,-1}, {0,2}, {3,1}};
+
+    Matrix<double> P = A.toMatrix()*B.toMatrix();
+    FixedMatrix<double,2,2> F = A*B;
+    for (size_t i = 0; i < 2; ++i){
+        for (size_t j = 0; j < 2; ++j){
+            EXPECT_DOUBLE_EQ(F(i,j), P(i,j));
+        }
+    }
+
+    FixedMatrix<double,3,2> At = A.transpose();
+    EXPECT_DOUBLE_EQ(At(2,1), 6.0);
+
+    FixedMatrix<double,2,3> S = A + A*2.0 - A;
+    EXPECT_DOUBLE_EQ(S(1,1), 10.0);
+
+    std::array<double,2> y = A.mVm({1.0, 0.0, -1.0});
+    EXPECT_DOUBLE_EQ(y[0], -2.0);
+    EXPECT_DOUBLE_EQ(y[1], -2.0);
+
+    Matrix<int>::allocations = 0;
+    {
+    FixedMatrix<int,6,6> K;
+    FixedMatrix<int,6,6> K2 = K*K + K;
+    EXPECT_EQ(K2(5,5), 0);
+    EXPECT_EQ(Matrix<int>::allocations, 0);
+    }
+}
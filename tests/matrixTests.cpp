@@ -1,5 +1,8 @@
 #include "../include/math/Matrix.h"
+#include "testUtils.h"
 #include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
 
 TEST(MatrixLibTest, copyConstCopiesDimensionsCorrectly)
 {
@@ -92,7 +95,69 @@ TEST(MatrixLibTest, copyAllocationCountIncreases)
     Matrix<int> A = {{1,2}, {3,4}};
     Matrix<int> B(A);
 
-    EXPECT_EQ(Matrix<int>::allocations, 4);   // one per row
+    EXPECT_EQ(Matrix<int>::allocations, 2);   // one buffer per matrix
+    }
+    EXPECT_EQ(Matrix<int>::allocations, 0);
+};
+
+TEST(MatrixLibTest, moveConstTakesOverBuffer)
+{
+    Matrix<int>::allocations = 0;
+    {
+    Matrix<int> A = {{1,2,3}, {4,5,6}};
+    Matrix<int> B(std::move(A));
+
+    // no new buffer for B
+    EXPECT_EQ(Matrix<int>::allocations, 1);
+
+    EXPECT_EQ(B.getSize()[0], 2);
+    EXPECT_EQ(B.getSize()[1], 3);
+    EXPECT_EQ(B(0,0), 1);
+    EXPECT_EQ(B(1,2), 6);
+
+    EXPECT_EQ(A.getSize()[0], 0);
+    EXPECT_EQ(A.getSize()[1], 0);
+    }
+    EXPECT_EQ(Matrix<int>::allocations, 0);
+};
+
+TEST(MatrixLibTest, moveAssignReleasesOldBuffer)
+{
+    Matrix<int>::allocations = 0;
+    {
+    Matrix<int> A = {{1,2}, {3,4}, {5,6}};
+    Matrix<int> B = {{7,8}};
+
+    B = std::move(A);
+
+    EXPECT_EQ(Matrix<int>::allocations, 1);
+    EXPECT_EQ(B.getSize()[0], 3);
+    EXPECT_EQ(B(2,1), 6);
+    EXPECT_EQ(A.getSize()[0], 0);
+
+    // Returned temporaries are moved, not copied
+    B = B*2;
+    EXPECT_EQ(Matrix<int>::allocations, 1);
+    EXPECT_EQ(B(2,1), 12);
+    }
+    EXPECT_EQ(Matrix<int>::allocations, 0);
+};
+
+TEST(MatrixLibTest, swapExchangesContents)
+{
+    Matrix<int>::allocations = 0;
+    {
+    Matrix<int> A = {{1,2}, {3,4}};
+    Matrix<int> B = {{9,8,7}};
+
+    swap(A, B);
+
+    EXPECT_EQ(Matrix<int>::allocations, 2);
+    EXPECT_EQ(A.getSize()[0], 1);
+    EXPECT_EQ(A.getSize()[1], 3);
+    EXPECT_EQ(A(0,2), 7);
+    EXPECT_EQ(B.getSize()[0], 2);
+    EXPECT_EQ(B(1,1), 4);
     }
     EXPECT_EQ(Matrix<int>::allocations, 0);
 };
@@ -225,6 +290,37 @@ TEST(MatrixLibTest, deleteRows)
     EXPECT_EQ(Matrix<int>::allocations, 0);
 };
 
+TEST(MatrixLibTest, deleteRowAndColumnKeepSingleBuffer)
+{
+    Matrix<int>::allocations = 0;
+    {
+
+    Matrix<int> M = {{1,2,3},
+                     {4,5,6},
+                     {7,8,9}};
+
+    M.deleteRow(1);
+    M.deleteColumn(0);
+
+    // Contiguous storage is compacted in place, no reallocation
+    EXPECT_EQ(Matrix<int>::allocations, 1);
+
+    EXPECT_EQ(M.getSize()[0], 2);
+    EXPECT_EQ(M.getSize()[1], 2);
+    EXPECT_EQ(M(0,0), 2); EXPECT_EQ(M(0,1), 3);
+    EXPECT_EQ(M(1,0), 8); EXPECT_EQ(M(1,1), 9);
+
+    Matrix<int> R = {{0,1}};
+    M.addRows(R);
+
+    EXPECT_EQ(Matrix<int>::allocations, 2);
+    EXPECT_EQ(M.getSize()[0], 3);
+    EXPECT_EQ(M(1,1), 9);
+    EXPECT_EQ(M(2,0), 0); EXPECT_EQ(M(2,1), 1);
+    }
+    EXPECT_EQ(Matrix<int>::allocations, 0);
+};
+
 TEST(MatrixLibTest, operatorEqCopiesDimensions)
 {
     Matrix<int>::allocations = 0;
@@ -307,7 +403,7 @@ TEST(MatrixLibTest, operatorEqAlloc)
 
     B = A;
 
-    EXPECT_EQ(Matrix<int>::allocations, 6);
+    EXPECT_EQ(Matrix<int>::allocations, 2);
     }
     EXPECT_EQ(Matrix<int>::allocations, 0);
 };
@@ -820,3 +916,502 @@ TEST(MatrixLibTest, LowerTriangularInverse) {
         }
     }
 }
+
+TEST(MatrixLibTest, TriangularSubstitutions) {
+
+    Matrix<double> L = {{2.0, 0.0, 0.0},
+                        {3.0, 1.0, 0.0},
+                        {1.0, 4.0, 5.0}};
+
+    std::vector<double> x = {1.0, -2.0, 0.5};
+
+    const double EPS = 1e-12;
+
+    // L*x = b
+    std::vector<double> b = L.mVm(x);
+    std::vector<double> xf = L.forwardSubstitution(b);
+
+    // L^T*x = c, both with the explicit transpose and without
+    Matrix<double> U = L.transpose();
+    std::vector<double> c = U.mVm(x);
+    std::vector<double> xb = U.backwardSubstitution(c);
+    std::vector<double> xt = L.transposedBackwardSubstitution(c);
+
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_NEAR(xf[i], x[i], EPS);
+        EXPECT_NEAR(xb[i], x[i], EPS);
+        EXPECT_NEAR(xt[i], x[i], EPS);
+    }
+
+    EXPECT_THROW(L.forwardSubstitution({1.0, 2.0}), std::invalid_argument);
+    Matrix<double> R(2,3,1.0);
+    EXPECT_THROW(R.transposedBackwardSubstitution({1.0, 2.0}), std::invalid_argument);
+}
+
+TEST(MatrixLibTest, CholeskySolveSPD) {
+
+    Matrix<double> K = {{4.0, 1.0, 0.5},
+                        {1.0, 3.0, 0.2},
+                        {0.5, 0.2, 2.0}};
+
+    std::vector<double> F = {1.0, 2.0, 3.0};
+
+    Matrix<double> L = K.cho();
+    std::vector<double> u = L.transposedBackwardSubstitution(L.forwardSubstitution(F));
+
+    std::vector<double> r = K.mVm(u);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_NEAR(r[i], F[i], 1e-12);
+    }
+}
+
+TEST(MatrixLibTest, BlockSubstitutionsMatchColumnSolves) {
+
+    Matrix<double> K = {{4.0, 1.0, 0.5, 0.0},
+                        {1.0, 3.0, 0.2, 0.1},
+                        {0.5, 0.2, 2.0, 0.3},
+                        {0.0, 0.1, 0.3, 5.0}};
+
+    Matrix<double> B = {{1.0, 0.0, -2.0},
+                        {2.0, 1.0,  0.5},
+                        {3.0, 0.0,  1.0},
+                        {4.0, 1.0,  0.0}};
+
+    Matrix<double> L = K.cho();
+    Matrix<double> X = L.blockTransposedBackwardSubstitution(L.blockForwardSubstitution(B));
+
+    ASSERT_EQ(X.getSize()[0], 4);
+    ASSERT_EQ(X.getSize()[1], 3);
+
+    for (size_t c = 0; c < 3; ++c) {
+        std::vector<double> b = {B(0,c), B(1,c), B(2,c), B(3,c)};
+        std::vector<double> x = L.transposedBackwardSubstitution(L.forwardSubstitution(b));
+        for (size_t i = 0; i < 4; ++i) {
+            EXPECT_NEAR(X(i,c), x[i], 1e-12);
+        }
+    }
+
+    Matrix<double> W(3, 2, 1.0);
+    EXPECT_THROW(L.blockForwardSubstitution(W), std::invalid_argument);
+    EXPECT_THROW(L.blockTransposedBackwardSubstitution(W), std::invalid_argument);
+}
+
+TEST(MatrixLibTest, CholeskyUpdateAndDowndate) {
+
+    Matrix<double> K = {{4.0, 1.0, 0.5, 0.0},
+                        {1.0, 3.0, 0.2, 0.1},
+                        {0.5, 0.2, 2.0, 0.3},
+                        {0.0, 0.1, 0.3, 5.0}};
+
+    std::vector<double> x = {0.0, 1.0, -1.0, 0.5};
+
+    Matrix<double> Kx(K);
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            Kx(i,j) += x[i]*x[j];
+        }
+    }
+
+    Matrix<double> L = K.cho();
+    L.choUpdate(x);
+    Matrix<double> Lx = Kx.cho();
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            EXPECT_NEAR(L(i,j), Lx(i,j), 1e-12);
+        }
+    }
+
+    L.choDowndate(x);
+    Matrix<double> L0 = K.cho();
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            EXPECT_NEAR(L(i,j), L0(i,j), 1e-12);
+        }
+    }
+
+    // rank-2 update and downdate cancel
+    Matrix<double> X = {{1.0, 0.0}, {0.0, 2.0}, {1.0, 0.0}, {0.0, -1.0}};
+    L.choRankUpdate(X);
+    L.choRankDowndate(X);
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            EXPECT_NEAR(L(i,j), L0(i,j), 1e-12);
+        }
+    }
+
+    EXPECT_THROW(L.choDowndate({3.0, 0.0, 0.0, 0.0}), std::runtime_error);
+    EXPECT_THROW(L.choUpdate({1.0, 2.0}), std::invalid_argument);
+
+    // errors name the function that was called
+    try {
+        L.choDowndate({1.0, 2.0});
+        FAIL();
+    }
+    catch (const std::invalid_argument& e) {
+        EXPECT_NE(std::string(e.what()).find("(Matrix::choDowndate)"), std::string::npos);
+    }
+}
+
+TEST(MatrixLibTest, BlockedProductMatchesNaive) {
+
+    // sizes that are not multiples of the register or cache tiles
+    const size_t m = 67, k = 301, n = 290;
+    Matrix<double> A(m, k), B(k, n);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t p = 0; p < k; ++p) A(i,p) = std::sin(0.1*i + 0.37*p);
+    }
+    for (size_t p = 0; p < k; ++p) {
+        for (size_t j = 0; j < n; ++j) B(p,j) = std::cos(0.21*p - 0.05*j);
+    }
+
+    Matrix<double> C = A*B;
+    ASSERT_EQ(C.getSize()[0], m);
+    ASSERT_EQ(C.getSize()[1], n);
+
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            double sum = 0.0;
+            for (size_t p = 0; p < k; ++p) sum += A(i,p)*B(p,j);
+            EXPECT_NEAR(C(i,j), sum, 1e-11);
+        }
+    }
+}
+
+TEST(MatrixLibTest, BlockedCholeskyReconstructs) {
+
+    // several diagonal blocks and a ragged last one
+    const size_t n = 203;
+    Matrix<double> M(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) M(i,j) = std::sin(1.0 + i*j*0.01 + j);
+    }
+    Matrix<double> K = M*M.transpose();
+    for (size_t i = 0; i < n; ++i) K(i,i) += n;
+
+    Matrix<double> L = K.cho();
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i+1; j < n; ++j) EXPECT_EQ(L(i,j), 0.0);
+    }
+
+    Matrix<double> R = L*L.transpose();
+    double maxErr = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) maxErr = std::max(maxErr, std::abs(R(i,j) - K(i,j)));
+    }
+    EXPECT_LT(maxErr, 1e-10);
+}
+
+TEST(MatrixLibTest, ParallelCholeskyIsDeterministic) {
+
+    const size_t n = 203;
+    const size_t m = 150;
+    Matrix<double> M(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) M(i,j) = std::sin(1.0 + i*j*0.01 + j);
+    }
+    Matrix<double> K = M*M.transpose();
+    for (size_t i = 0; i < n; ++i) K(i,i) += n;
+    Matrix<double> B(n, m);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < m; ++j) B(i,j) = std::cos(0.1*i + 0.3*j);
+    }
+
+    ScopedNumThreads threads(1);
+    EXPECT_EQ(getNumThreads(), 1);
+    Matrix<double> L1 = K.cho();
+    Matrix<double> X1 = L1.blockTransposedBackwardSubstitution(L1.blockForwardSubstitution(B));
+
+    threads.set(4);
+    EXPECT_EQ(getNumThreads(), 4);
+    Matrix<double> L4 = K.cho();
+    Matrix<double> X4 = L4.blockTransposedBackwardSubstitution(L4.blockForwardSubstitution(B));
+
+    // bitwise identical, independent of the number of threads
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) ASSERT_EQ(L1(i,j), L4(i,j));
+        for (size_t j = 0; j < m; ++j) ASSERT_EQ(X1(i,j), X4(i,j));
+    }
+
+    Matrix<double> R = K*X4 - B;
+    double maxRes = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < m; ++j) maxRes = std::max(maxRes, std::abs(R(i,j)));
+    }
+    EXPECT_LT(maxRes, 1e-10);
+}
+
+TEST(MatrixLibTest, ThreadPoolRunsEveryTaskOnce) {
+
+    ThreadPool pool(3);
+    EXPECT_EQ(pool.getNumThreads(), 3);
+
+    std::vector<int> hits(1000, 0);
+    pool.parallelFor(hits.size(), [&](size_t t) {
+        hits[t]++;
+        // nested calls run serially on the calling thread
+        pool.parallelFor(2, [&](size_t) {});
+    });
+    for (int h : hits) EXPECT_EQ(h, 1);
+
+    EXPECT_THROW(pool.parallelFor(10, [](size_t t) {
+        if (t == 7) throw std::runtime_error("task failed");
+    }), std::runtime_error);
+
+    pool.setNumThreads(2);
+    EXPECT_EQ(pool.getNumThreads(), 2);
+    std::vector<size_t> out(64, 0);
+    pool.parallelFor(out.size(), [&](size_t t) { out[t] = t*t; });
+    for (size_t t = 0; t < out.size(); ++t) EXPECT_EQ(out[t], t*t);
+
+    // workers restarted after earlier jobs wait for the next job, every call returns only when all tasks finished
+    for (size_t round = 0; round < 50; ++round){
+        pool.setNumThreads(2 + round%2);
+        std::atomic<size_t> finished{0};
+        pool.parallelFor(8, [&](size_t) {
+            std::this_thread::yield();
+            finished++;
+        });
+        ASSERT_EQ(finished.load(), 8u);
+    }
+}
+
+TEST(MatrixLibTest, deleteRowsColumnsSinglePass)
+{
+    Matrix<int>::allocations = 0;
+    {
+    Matrix<int> M(5,5);
+    for (size_t i = 0; i < 5; ++i){
+        for (size_t j = 0; j < 5; ++j){
+            M(i,j) = static_cast<int>(10*i + j);
+        }
+    }
+
+    // unsorted with a duplicate
+    std::vector<size_t> rc = {3,0,3};
+    M.deleteRowsColumns(rc);
+
+    ASSERT_EQ(M.getSize()[0], 3);
+    ASSERT_EQ(M.getSize()[1], 3);
+    EXPECT_EQ(Matrix<int>::allocations, 1);
+
+    std::vector<size_t> keep = {1,2,4};
+    for (size_t i = 0; i < 3; ++i){
+        for (size_t j = 0; j < 3; ++j){
+            EXPECT_EQ(M(i,j), static_cast<int>(10*keep[i] + keep[j]));
+        }
+    }
+
+    std::vector<size_t> bad = {1,7};
+    EXPECT_THROW(M.deleteRowsColumns(bad), std::out_of_range);
+
+    Matrix<int> R(2,3);
+    std::vector<size_t> any = {0};
+    EXPECT_THROW(R.deleteRowsColumns(any), std::invalid_argument);
+    }
+    EXPECT_EQ(Matrix<int>::allocations, 0);
+};
+
+TEST(MatrixLibTest, vectorKernelsMatchScalarLoops)
+{
+    // lengths around the vector widths exercise every tail path
+    for (size_t n : {0, 1, 2, 3, 5, 7, 8, 15, 16, 17, 31, 33, 64, 101}){
+        std::vector<double> x(n), y(n);
+        for (size_t i = 0; i < n; ++i){
+            x[i] = std::sin(0.3*i + 1.0);
+            y[i] = std::cos(0.7*i);
+        }
+
+        double ref = 0.0;
+        for (size_t i = 0; i < n; ++i) ref += x[i]*y[i];
+        EXPECT_NEAR(dotProduct(x.data(), y.data(), n), ref, 1e-12);
+
+        std::vector<double> z(y);
+        axpy(-1.5, x.data(), z.data(), n);
+        for (size_t i = 0; i < n; ++i) EXPECT_NEAR(z[i], y[i] - 1.5*x[i], 1e-14);
+    }
+
+    std::vector<int> a = {1,2,3,4,5};
+    std::vector<int> b = {5,4,3,2,1};
+    EXPECT_NE(std::string(vectorKernelISA()), "");
+    EXPECT_EQ(dotProduct(a.data(), b.data(), a.size()), 35);
+    axpy(2, a.data(), b.data(), a.size());
+    EXPECT_EQ(b, std::vector<int>({7,8,9,10,11}));
+};
+
+#if BAROP_CPU_DISPATCH
+TEST(MatrixLibTest, everySupportedKernelMatchesScalarLoops)
+{
+    // the dispatcher picks one kernel, check the others the CPU can run as well
+    std::vector<VectorKernelTable> tables = {{dotProductSSE2, axpySSE2, "SSE2"}};
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")){
+        tables.push_back({dotProductAVX2, axpyAVX2, "AVX2"});
+    }
+    if (__builtin_cpu_supports("avx512f")){
+        tables.push_back({dotProductAVX512, axpyAVX512, "AVX-512"});
+    }
+    EXPECT_EQ(std::string(vectorKernelISA()), tables.back().isa);
+
+    for (const VectorKernelTable& k : tables){
+        for (size_t n : {0, 1, 3, 7, 8, 9, 17, 33, 101}){
+            std::vector<double> x(n), y(n);
+            for (size_t i = 0; i < n; ++i){
+                x[i] = std::sin(0.3*i + 1.0);
+                y[i] = std::cos(0.7*i);
+            }
+
+            double ref = 0.0;
+            for (size_t i = 0; i < n; ++i) ref += x[i]*y[i];
+            EXPECT_NEAR(k.dot(x.data(), y.data(), n), ref, 1e-12) << k.isa;
+
+            std::vector<double> z(y);
+            k.axpy(-1.5, x.data(), z.data(), n);
+            for (size_t i = 0; i < n; ++i) EXPECT_NEAR(z[i], y[i] - 1.5*x[i], 1e-14) << k.isa;
+        }
+    }
+};
+#endif
+
+TEST(MatrixLibTest, vectorizedSubstitutionsSolveSystem)
+{
+    const size_t n = 37;
+    Matrix<double> K(n,n);
+    for (size_t i = 0; i < n; ++i){
+        for (size_t j = 0; j < n; ++j){
+            K(i,j) = (i == j) ? 2.0*n : 1.0/(1.0 + i + j);
+        }
+    }
+    std::vector<double> b(n);
+    for (size_t i = 0; i < n; ++i) b[i] = 1.0 + 0.1*i;
+
+    Matrix<double> L = K.cho();
+    std::vector<double> x = L.transposedBackwardSubstitution(L.forwardSubstitution(b));
+    std::vector<double> r = K.mVm(x);
+    for (size_t i = 0; i < n; ++i) EXPECT_NEAR(r[i], b[i], 1e-10);
+
+    std::vector<double> xu = L.transpose().backwardSubstitution(L.forwardSubstitution(b));
+    for (size_t i = 0; i < n; ++i) EXPECT_NEAR(xu[i], x[i], 1e-12);
+};
+
+TEST(MatrixLibTest, UncheckedAccessAndViews) {
+    Matrix<double> M = {{1, 2, 3}, {4, 5, 6}};
+    const Matrix<double>& C = M;
+
+    EXPECT_DOUBLE_EQ(C.unchecked(1, 2), 6.0);
+    M.unchecked(0, 1) = -2.0;
+    EXPECT_DOUBLE_EQ(M(0, 1), -2.0);
+
+    VectorView<double> r1 = M.row(1);
+    EXPECT_EQ(r1.size(), 3);
+    EXPECT_EQ(r1.stride(), 1);
+    EXPECT_EQ(r1.data(), M.data() + 3);
+    r1[0] = 7.0;
+    EXPECT_DOUBLE_EQ(M(1, 0), 7.0);
+    EXPECT_DOUBLE_EQ(dotProduct(C.row(0).data(), C.row(1).data(), 3), 1*7 - 2*5 + 3*6);
+
+    VectorView<const double> c2 = C.column(2);
+    EXPECT_EQ(c2.size(), 2);
+    EXPECT_DOUBLE_EQ(c2[0], 3.0);
+    EXPECT_DOUBLE_EQ(c2[1], 6.0);
+    M.column(0)[1] = 8.0;
+    VectorView<const double> c0 = M.column(0);
+    EXPECT_DOUBLE_EQ(c0[1], 8.0);
+
+    // operator() is always checked, the unchecked accessors only in debug builds
+    EXPECT_THROW(M(2, 0), std::out_of_range);
+#if BAROP_BOUNDS_CHECK
+    EXPECT_THROW(M.unchecked(2, 0), std::out_of_range);
+    EXPECT_THROW(M.row(2), std::out_of_range);
+    EXPECT_THROW(C.column(3), std::out_of_range);
+    EXPECT_THROW(c2[2], std::out_of_range);
+#endif
+}
+
+TEST(MatrixLibTest, expressionTemplatesEvaluateWithoutTemporaries)
+{
+    Matrix<double>::allocations = 0;
+    {
+    const size_t m = 37, k = 29, n = 41;
+    Matrix<double> A(m, k), B(k, n), C(m, n), D(m, n), At(k, m);
+    for (size_t i = 0; i < m; ++i){
+        for (size_t j = 0; j < k; ++j){
+            A(i,j) = std::sin(1.0 + i + 3.0*j);
+            At(j,i) = A(i,j);
+        }
+    }
+    for (size_t i = 0; i < k; ++i){
+        for (size_t j = 0; j < n; ++j) B(i,j) = std::cos(2.0*i - j);
+    }
+    for (size_t i = 0; i < m; ++i){
+        for (size_t j = 0; j < n; ++j){
+            C(i,j) = 0.5*i - j;
+            D(i,j) = 1.0/(1.0 + i + j);
+        }
+    }
+
+    auto naiveProduct = [](const Matrix<double>& X, const Matrix<double>& Y){
+        Matrix<double> P(X.rows(), Y.cols(), 0.0);
+        for (size_t i = 0; i < X.rows(); ++i){
+            for (size_t j = 0; j < Y.cols(); ++j){
+                for (size_t p = 0; p < X.cols(); ++p) P(i,j) += X(i,p)*Y(p,j);
+            }
+        }
+        return P;
+    };
+    const Matrix<double> AB = naiveProduct(A, B);
+    const int live = Matrix<double>::allocations;
+
+    // element-wise expressions allocate only the result
+    Matrix<double> E = C + D - 2.0*C;
+    EXPECT_EQ(Matrix<double>::allocations, live + 1);
+    for (size_t i = 0; i < m; ++i){
+        for (size_t j = 0; j < n; ++j) EXPECT_DOUBLE_EQ(E(i,j), C(i,j) + D(i,j) - 2.0*C(i,j));
+    }
+
+    // assignment into a large enough buffer allocates nothing, also with the target as operand
+    E = (E - C)*0.5 + D;
+    EXPECT_EQ(Matrix<double>::allocations, live + 1);
+    for (size_t i = 0; i < m; ++i){
+        for (size_t j = 0; j < n; ++j) EXPECT_NEAR(E(i,j), (D(i,j) - 2.0*C(i,j))*0.5 + D(i,j), 1e-14);
+    }
+
+    // fused GEMM: scalars are folded into the kernel, transposed left operands are read in place
+    Matrix<double> F = 3.0*(At.transposeView()*B) - C;
+    EXPECT_EQ(Matrix<double>::allocations, live + 2);
+    for (size_t i = 0; i < m; ++i){
+        for (size_t j = 0; j < n; ++j) EXPECT_NEAR(F(i,j), 3.0*AB(i,j) - C(i,j), 1e-12);
+    }
+    F += A*B;
+    F -= (A*0.5)*B;
+    EXPECT_EQ(Matrix<double>::allocations, live + 2);
+    for (size_t i = 0; i < m; ++i){
+        for (size_t j = 0; j < n; ++j) EXPECT_NEAR(F(i,j), 3.5*AB(i,j) - C(i,j), 1e-12);
+    }
+
+    // lazy transposes, also of products and of the assigned matrix itself
+    Matrix<double> G = (A*B).transposeView() + C.transposeView();
+    ASSERT_EQ(G.rows(), n);
+    ASSERT_EQ(G.cols(), m);
+    for (size_t i = 0; i < m; ++i){
+        for (size_t j = 0; j < n; ++j) EXPECT_NEAR(G(j,i), AB(i,j) + C(i,j), 1e-12);
+    }
+    G = G.transposeView();
+    for (size_t i = 0; i < m; ++i){
+        for (size_t j = 0; j < n; ++j) EXPECT_NEAR(G(i,j), AB(i,j) + C(i,j), 1e-12);
+    }
+    Matrix<double> H = A;
+    H = H.transposeView()*H;
+    Matrix<double> AtA = naiveProduct(At, A);
+    for (size_t i = 0; i < k; ++i){
+        for (size_t j = 0; j < k; ++j) EXPECT_NEAR(H(i,j), AtA(i,j), 1e-12);
+    }
+
+    // entries of expressions can be read without evaluating them
+    EXPECT_NEAR((A*B)(3,5), AB(3,5), 1e-12);
+    EXPECT_DOUBLE_EQ((C - D)(2,7), C(2,7) - D(2,7));
+    EXPECT_THROW(C + B, std::invalid_argument);
+    EXPECT_THROW(F += B, std::invalid_argument);
+    EXPECT_THROW(B*C, std::runtime_error);
+    }
+    EXPECT_EQ(Matrix<double>::allocations, 0);
+}
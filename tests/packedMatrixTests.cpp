@@ -0,0 +1,161 @@
+#include "../include/math/PackedMatrix.h"
+#include "../include/math/IterativeRefinement.h"
+#include "testUtils.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+    // symmetric positive definite test matrix spanning several tiles, the last one partial
+    Matrix<double> spdMatrix(size_t n){
+        Matrix<double> M(n, n);
+        for (size_t i = 0; i < n; ++i){
+            for (size_t j = 0; j < n; ++j) M(i,j) = std::sin(0.3*i + 1.7*j + 0.1);
+        }
+        Matrix<double> K = M*M.transpose();
+        for (size_t i = 0; i < n; ++i){
+            K(i,i) += n;
+            for (size_t j = 0; j < i; ++j) K(j,i) = K(i,j);
+        }
+        return K;
+    }
+}
+
+TEST(PackedMatrixTest, StoresLowerTriangleOnly)
+{
+    Matrix<double> K = spdMatrix(150);
+    PackedMatrix<double> P(K);
+
+    EXPECT_EQ(P.getSize()[0], 150);
+    // 64x64 tiles: two full diagonal tiles, one 22x22, three off-diagonal tiles
+    EXPECT_EQ(P.getStorageSize(), 2*64*64 + 22*22 + 64*64 + 2*22*64);
+
+    const PackedMatrix<double>& C = P;
+    EXPECT_DOUBLE_EQ(C(3,140), K(140,3));
+    EXPECT_DOUBLE_EQ(C(140,3), K(140,3));
+    P(2,100) = -1.0;
+    EXPECT_DOUBLE_EQ(C(100,2), -1.0);
+    P(2,100) = K(100,2);
+    EXPECT_THROW(C(150,0), std::out_of_range);
+
+    Matrix<double> D = P.toDense();
+    for (size_t i = 0; i < 150; ++i){
+        for (size_t j = 0; j < 150; ++j) EXPECT_DOUBLE_EQ(D(i,j), K(i,j));
+    }
+
+    std::vector<double> x(150);
+    for (size_t i = 0; i < 150; ++i) x[i] = std::cos(0.5*i);
+    std::vector<double> yp = P.mVm(x);
+    std::vector<double> yd = K.mVm(x);
+    for (size_t i = 0; i < 150; ++i) EXPECT_NEAR(yp[i], yd[i], 1e-9);
+}
+
+TEST(PackedMatrixTest, CholeskySolveMatchesDense)
+{
+    const size_t n = 201;
+    Matrix<double> K = spdMatrix(n);
+    Matrix<double> Ld = K.cho();
+    PackedMatrix<double> L = PackedMatrix<double>(K).cho();
+
+    for (size_t i = 0; i < n; ++i){
+        for (size_t j = 0; j <= i; ++j) EXPECT_NEAR(L(i,j), Ld(i,j), 1e-10);
+    }
+
+    std::vector<double> b(n);
+    for (size_t i = 0; i < n; ++i) b[i] = 1.0 + 0.01*i;
+    std::vector<double> u = L.transposedBackwardSubstitution(L.forwardSubstitution(b));
+    std::vector<double> r = K.mVm(u);
+    for (size_t i = 0; i < n; ++i) EXPECT_NEAR(r[i], b[i], 1e-9);
+
+    // multiple right hand sides
+    const size_t m = 70;
+    Matrix<double> B(n, m);
+    for (size_t i = 0; i < n; ++i){
+        for (size_t j = 0; j < m; ++j) B(i,j) = std::cos(0.1*i*j);
+    }
+    Matrix<double> X = L.blockTransposedBackwardSubstitution(L.blockForwardSubstitution(B));
+    Matrix<double> R = K*X;
+    for (size_t i = 0; i < n; ++i){
+        for (size_t j = 0; j < m; ++j) EXPECT_NEAR(R(i,j), B(i,j), 1e-9);
+    }
+
+    // indefinite matrices are rejected
+    PackedMatrix<double> A(K);
+    A(120,120) = -1.0;
+    EXPECT_THROW(A.choInPlace(), std::runtime_error);
+}
+
+TEST(PackedMatrixTest, ParallelCholeskyIsDeterministic)
+{
+    const size_t n = 300;
+    PackedMatrix<double> K(spdMatrix(n));
+
+    ScopedNumThreads threads(1);
+    PackedMatrix<double> L1 = K.cho();
+    threads.set(4);
+    PackedMatrix<double> L4 = K.cho();
+
+    for (size_t i = 0; i < n; ++i){
+        for (size_t j = 0; j <= i; ++j) EXPECT_EQ(L1(i,j), L4(i,j));
+    }
+}
+
+TEST(PackedMatrixTest, FromSparse)
+{
+    SparseMatrix<double> A(3, 3, {{0,2}, {1}, {0,2}});
+    A(0,0) = 4; A(0,2) = 1;
+    A(1,1) = 5;
+    A(2,0) = 1; A(2,2) = 6;
+
+    PackedMatrix<double> P(A);
+    const PackedMatrix<double>& C = P;
+    EXPECT_DOUBLE_EQ(C(0,2), 1.0);
+    EXPECT_DOUBLE_EQ(C(1,0), 0.0);
+    EXPECT_DOUBLE_EQ(C(2,2), 6.0);
+}
+
+TEST(PackedMatrixTest, FloatFactorWithRefinementReachesDoubleAccuracy)
+{
+    const size_t n = 201;
+    Matrix<double> K = spdMatrix(n);
+    Matrix<float> Kf(n, n);
+    for (size_t i = 0; i < n; ++i){
+        for (size_t j = 0; j < n; ++j) Kf(i,j) = static_cast<float>(K(i,j));
+    }
+    PackedMatrix<float> Lf(Kf);
+    Lf.choInPlace();
+
+    std::vector<double> b(n);
+    for (size_t i = 0; i < n; ++i) b[i] = std::cos(0.5*i) + 1.0;
+
+    double normK = 0.0;
+    for (size_t i = 0; i < n; ++i){
+        for (size_t j = 0; j < n; ++j) normK += K(i,j)*K(i,j);
+    }
+    normK = std::sqrt(normK);
+
+    RefinementReport<double> report;
+    std::vector<double> x = iterativeRefinement(K, normK, Lf, b, 1e-15, 20, report);
+
+    EXPECT_TRUE(report.converged);
+    ASSERT_EQ(report.backwardErrorHistory.size(), report.iterations + 1);
+    // the plain float solve is far from double accuracy, refinement closes the gap
+    EXPECT_GT(report.iterations, 1);
+    EXPECT_GT(report.backwardErrorHistory[1], 1e-12);
+    EXPECT_LT(report.backwardErrorHistory.back(), 1e-15);
+
+    PackedMatrix<double> L = PackedMatrix<double>(K).cho();
+    std::vector<double> xRef = L.transposedBackwardSubstitution(L.forwardSubstitution(b));
+    for (size_t i = 0; i < n; ++i) EXPECT_NEAR(x[i], xRef[i], 1e-12*std::abs(xRef[i]) + 1e-15);
+
+    iterativeRefinement(K, normK, Lf, b, 1e-15, 1, report);
+    EXPECT_FALSE(report.converged);
+    EXPECT_EQ(report.iterations, 1);
+
+    std::vector<double> zero(n, 0.0);
+    x = iterativeRefinement(K, normK, Lf, zero, 1e-15, 20, report);
+    EXPECT_TRUE(report.converged);
+    EXPECT_EQ(report.iterations, 0);
+    EXPECT_DOUBLE_EQ(x[0], 0.0);
+
+    EXPECT_THROW(iterativeRefinement(K, normK, Lf, std::vector<double>(n-1, 1.0), 1e-15, 20, report), std::invalid_argument);
+}
@@ -0,0 +1,136 @@
+#include "../include/math/SkylineMatrix.h"
+#include "../include/math/GraphOrdering.h"
+#include <gtest/gtest.h>
+
+TEST(SkylineMatrixTest, ProfileFromSparse)
+{
+    // banded pattern with one long row
+    SparseMatrix<double> A(4, 4, {{0,1,3}, {0,1,2}, {1,2}, {0,3}});
+    A(0,0) = 4; A(0,1) = 1; A(0,3) = 1;
+    A(1,0) = 1; A(1,1) = 5; A(1,2) = 2;
+    A(2,1) = 2; A(2,2) = 6;
+    A(3,0) = 1; A(3,3) = 7;
+
+    SkylineMatrix<double> S(A);
+
+    EXPECT_EQ(S.getSize()[0], 4);
+    // rows store 1 + 2 + 2 + 4 entries
+    EXPECT_EQ(S.getProfileSize(), 9);
+    EXPECT_EQ(S.getBandwidth(), 3);
+
+    const SkylineMatrix<double>& C = S;
+    EXPECT_DOUBLE_EQ(C(1,2), 2.0);
+    EXPECT_DOUBLE_EQ(C(2,1), 2.0);
+    EXPECT_DOUBLE_EQ(C(3,1), 0.0);   // inside the profile, structurally zero
+    EXPECT_DOUBLE_EQ(C(2,0), 0.0);   // outside the profile
+
+    EXPECT_THROW(S(2,0), std::invalid_argument);
+    EXPECT_THROW(C(4,0), std::out_of_range);
+
+    std::vector<double> x = {1.0, 2.0, 3.0, 4.0};
+    std::vector<double> ys = S.mVm(x);
+    std::vector<double> ya = A.mVm(x);
+    for (size_t i = 0; i < 4; ++i){
+        EXPECT_DOUBLE_EQ(ys[i], ya[i]);
+    }
+}
+
+TEST(SkylineMatrixTest, CholeskySolveMatchesDense)
+{
+    std::vector<size_t> firstCol = {0, 0, 1, 1, 3};
+    SkylineMatrix<double> S(firstCol);
+    for (size_t i = 0; i < 5; ++i){
+        S(i,i) = 10.0 + i;
+        for (size_t j = firstCol[i]; j < i; ++j){
+            S(i,j) = 1.0 + 0.5*j - 0.25*i;
+        }
+    }
+
+    Matrix<double> D(5, 5, 0.0);
+    for (size_t i = 0; i < 5; ++i){
+        for (size_t j = 0; j < 5; ++j){
+            D(i,j) = static_cast<const SkylineMatrix<double>&>(S)(i,j);
+        }
+    }
+
+    SkylineMatrix<double> L = S.cho();
+    Matrix<double> Ld = D.cho();
+    for (size_t i = 0; i < 5; ++i){
+        for (size_t j = 0; j <= i; ++j){
+            EXPECT_NEAR(static_cast<const SkylineMatrix<double>&>(L)(i,j), Ld(i,j), 1e-12);
+        }
+    }
+
+    std::vector<double> b = {1.0, -1.0, 2.0, 0.5, 3.0};
+    std::vector<double> x = L.transposedBackwardSubstitution(L.forwardSubstitution(b));
+    std::vector<double> r = D.mVm(x);
+    for (size_t i = 0; i < 5; ++i){
+        EXPECT_NEAR(r[i], b[i], 1e-12);
+    }
+
+    Matrix<double> B(5, 2, 0.0);
+    for (size_t i = 0; i < 5; ++i){
+        B(i,0) = b[i];
+        B(i,1) = 1.0 - i;
+    }
+    Matrix<double> X = L.blockTransposedBackwardSubstitution(L.blockForwardSubstitution(B));
+    for (size_t i = 0; i < 5; ++i){
+        EXPECT_NEAR(X(i,0), x[i], 1e-12);
+    }
+    std::vector<double> r1 = D.mVm({X(0,1), X(1,1), X(2,1), X(3,1), X(4,1)});
+    for (size_t i = 0; i < 5; ++i){
+        EXPECT_NEAR(r1[i], B(i,1), 1e-12);
+    }
+
+    SkylineMatrix<double> N(std::vector<size_t>{0, 0});
+    N(0,0) = 1.0; N(1,0) = 2.0; N(1,1) = 1.0;
+    EXPECT_THROW(N.cho(), std::runtime_error);
+}
+
+TEST(SkylineMatrixTest, ReverseCuthillMcKeeRestoresPathBandwidth)
+{
+    // path 0-4-2-5-1-3 numbered badly
+    std::vector<std::vector<size_t>> adj = {{4}, {5,3}, {4,5}, {1}, {0,2}, {2,1}};
+
+    std::vector<size_t> order = reverseCuthillMcKee(adj);
+
+    ASSERT_EQ(order.size(), 6);
+    std::vector<size_t> position(6);
+    for (size_t k = 0; k < 6; ++k){
+        position[order[k]] = k;
+    }
+
+    // consecutive path vertices end up next to each other
+    for (size_t v = 0; v < 6; ++v){
+        for (size_t w : adj[v]){
+            size_t d = position[v] > position[w] ? position[v] - position[w] : position[w] - position[v];
+            EXPECT_EQ(d, 1);
+        }
+    }
+}
+
+TEST(SkylineMatrixTest, ReverseCuthillMcKeeIgnoresPrecedingComponents)
+{
+    // tree with a cycle whose smallest degree vertex 1 is not pseudo-peripheral
+    std::vector<std::vector<size_t>> graph = {{1,2,9}, {0}, {0,3}, {2,4,5}, {3,5}, {3,6,7,4},
+                                              {5}, {5,8}, {7,10}, {0}, {8}};
+    std::vector<size_t> reference = reverseCuthillMcKee(graph);
+
+    // isolated vertices in front shift the search counter, with 5 of them the first search
+    // of the graph is the n-th one
+    for (size_t k = 1; k < 12; ++k){
+        std::vector<std::vector<size_t>> adj(k);
+        for (const std::vector<size_t>& nb : graph){
+            adj.push_back(nb);
+            for (size_t& w : adj.back()) w += k;
+        }
+        std::vector<size_t> order = reverseCuthillMcKee(adj);
+        ASSERT_EQ(order.size(), k + 11);
+
+        std::vector<size_t> shifted;
+        for (size_t v : order){
+            if (v >= k) shifted.push_back(v - k);
+        }
+        EXPECT_EQ(shifted, reference) << k << " isolated vertices";
+    }
+}
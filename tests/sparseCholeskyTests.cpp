@@ -0,0 +1,339 @@
+#include "../include/math/SparseCholesky.h"
+#include "testUtils.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+// 2D 5-point Laplacian on an m x m grid, SPD
+static SparseMatrix<double> laplacian2D(size_t m)
+{
+    size_t n = m*m;
+    std::vector<std::vector<size_t>> pattern(n);
+    for (size_t i = 0; i < m; ++i){
+        for (size_t j = 0; j < m; ++j){
+            size_t k = i*m + j;
+            pattern[k].push_back(k);
+            if (i > 0)   pattern[k].push_back(k-m);
+            if (i+1 < m) pattern[k].push_back(k+m);
+            if (j > 0)   pattern[k].push_back(k-1);
+            if (j+1 < m) pattern[k].push_back(k+1);
+        }
+    }
+
+    SparseMatrix<double> A(n, n, pattern);
+    for (size_t k = 0; k < n; ++k){
+        for (size_t c : pattern[k]){
+            A(k,c) = (c == k) ? 4.0 : -1.0;
+        }
+    }
+    return A;
+}
+
+TEST(SparseCholeskyTest, MinimumDegreeEliminatesLeavesFirst)
+{
+    // star graph: vertex 0 connected to all others, self loop on 4 is ignored
+    std::vector<std::vector<size_t>> adj = {{1,2,3,4}, {0}, {0}, {0}, {0,4}};
+
+    std::vector<size_t> order = approximateMinimumDegreeOrdering(adj);
+
+    // the center is only eliminated once its degree has dropped to one
+    ASSERT_EQ(order.size(), 5);
+    EXPECT_EQ(order[0], 1);
+    EXPECT_EQ(order[1], 2);
+    EXPECT_EQ(order[2], 3);
+
+    std::vector<size_t> sorted = order;
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t i = 0; i < 5; ++i){
+        EXPECT_EQ(sorted[i], i);
+    }
+}
+
+TEST(SparseCholeskyTest, NestedDissectionReducesFillOfGrid)
+{
+    // 30 x 30 grid of the 5-point Laplacian, vertex k at (k%m, k/m)
+    size_t m = 30;
+    size_t n = m*m;
+    SparseMatrix<double> A = laplacian2D(m);
+    std::vector<std::vector<size_t>> adj(n);
+    std::vector<std::array<double,3>> xyz(n);
+    for (size_t k = 0; k < n; ++k){
+        if (k%m > 0)   adj[k].push_back(k-1);
+        if (k%m+1 < m) adj[k].push_back(k+1);
+        if (k >= m)    adj[k].push_back(k-m);
+        if (k+m < n)   adj[k].push_back(k+m);
+        xyz[k] = {double(k%m), double(k/m), 0.0};
+    }
+
+    std::vector<size_t> natural(n);
+    for (size_t k = 0; k < n; ++k){
+        natural[k] = k;
+    }
+    std::vector<size_t> nd = nestedDissectionOrdering(adj, xyz);
+
+    std::vector<size_t> sorted = nd;
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_EQ(sorted, natural);
+
+    // the predicted count matches the symbolic factorization
+    SparseCholesky<double> chol;
+    chol.analyze(A, nd);
+    EXPECT_EQ(choleskyFactorNonzeros(adj, nd), chol.getNNZ());
+    chol.analyze(A, natural);
+    EXPECT_EQ(choleskyFactorNonzeros(adj, natural), chol.getNNZ());
+
+    // the banded natural order fills m nonzeros per row, dissection about half of that
+    EXPECT_LT(3*choleskyFactorNonzeros(adj, nd), 2*choleskyFactorNonzeros(adj, natural));
+
+    std::vector<size_t> bad = {0, 0};
+    EXPECT_THROW(choleskyFactorNonzeros({{1},{0}}, bad), std::invalid_argument);
+    EXPECT_THROW(nestedDissectionOrdering(adj, {}), std::invalid_argument);
+}
+
+TEST(SparseCholeskyTest, SolveMatchesDenseCholesky)
+{
+    SparseMatrix<double> A = laplacian2D(6);
+    size_t n = 36;
+
+    std::vector<double> b(n);
+    for (size_t i = 0; i < n; ++i){
+        b[i] = 1.0 + 0.1*i;
+    }
+
+    SparseCholesky<double> chol(A);
+    std::vector<double> x = chol.solve(b);
+
+    Matrix<double> L = A.toDense().cho();
+    std::vector<double> xd = L.transposedBackwardSubstitution(L.forwardSubstitution(b));
+
+    for (size_t i = 0; i < n; ++i){
+        EXPECT_NEAR(x[i], xd[i], 1e-10);
+    }
+
+    // fill-reducing ordering keeps L well below the dense triangle
+    EXPECT_LT(chol.getNNZ(), n*(n+1)/2);
+}
+
+TEST(SparseCholeskyTest, BlockSolveMatchesColumnSolves)
+{
+    SparseMatrix<double> A = laplacian2D(5);
+    size_t n = 25;
+    size_t m = 4;
+
+    Matrix<double> B(n, m, 0.0);
+    for (size_t i = 0; i < n; ++i){
+        for (size_t c = 0; c < m; ++c){
+            B(i,c) = std::sin(1.0 + i + 7.0*c);
+        }
+    }
+
+    SparseCholesky<double> chol(A);
+    Matrix<double> X = chol.blockSolve(B);
+
+    for (size_t c = 0; c < m; ++c){
+        std::vector<double> b(n);
+        for (size_t i = 0; i < n; ++i) b[i] = B(i,c);
+        std::vector<double> x = chol.solve(b);
+        for (size_t i = 0; i < n; ++i){
+            EXPECT_NEAR(X(i,c), x[i], 1e-12);
+        }
+    }
+
+    EXPECT_THROW(chol.blockSolve(Matrix<double>(n+1, m, 0.0)), std::invalid_argument);
+}
+
+TEST(SparseCholeskyTest, ParallelBlockSolveIsDeterministic)
+{
+    SparseMatrix<double> A = laplacian2D(9);
+    size_t n = 81;
+    size_t m = 130;
+
+    Matrix<double> B(n, m, 0.0);
+    for (size_t i = 0; i < n; ++i){
+        for (size_t c = 0; c < m; ++c){
+            B(i,c) = std::sin(1.0 + i + 0.7*c);
+        }
+    }
+
+    SparseCholesky<double> chol(A);
+    ScopedNumThreads threads(1);
+    Matrix<double> X1 = chol.blockSolve(B);
+    threads.set(3);
+    Matrix<double> X3 = chol.blockSolve(B);
+
+    for (size_t i = 0; i < n; ++i){
+        for (size_t c = 0; c < m; ++c){
+            ASSERT_EQ(X1(i,c), X3(i,c));
+        }
+    }
+
+    std::vector<double> b(n);
+    for (size_t i = 0; i < n; ++i) b[i] = B(i,m-1);
+    std::vector<double> x = chol.solve(b);
+    for (size_t i = 0; i < n; ++i){
+        EXPECT_NEAR(X3(i,m-1), x[i], 1e-12);
+    }
+}
+
+TEST(SparseCholeskyTest, UpdateDowndateMatchesRefactorization)
+{
+    SparseMatrix<double> A = laplacian2D(5);
+    size_t n = 25;
+
+    // grid neighbours 6 and 7 are coupled in A
+    std::vector<double> x(n, 0.0);
+    x[6] = 1.5;
+    x[7] = -0.5;
+
+    SparseCholesky<double> chol(A);
+    chol.update(x);
+
+    SparseMatrix<double> Ax(A);
+    Ax(6,6) += 2.25; Ax(7,7) += 0.25;
+    Ax(6,7) -= 0.75; Ax(7,6) -= 0.75;
+    SparseCholesky<double> ref(Ax, chol.getPermutation());
+
+    std::vector<double> b(n);
+    for (size_t i = 0; i < n; ++i) b[i] = std::cos(0.3*i);
+
+    std::vector<double> u = chol.solve(b);
+    std::vector<double> uRef = ref.solve(b);
+    for (size_t i = 0; i < n; ++i){
+        EXPECT_NEAR(u[i], uRef[i], 1e-12);
+    }
+
+    chol.downdate(x);
+    u = chol.solve(b);
+    uRef = SparseCholesky<double>(A, chol.getPermutation()).solve(b);
+    for (size_t i = 0; i < n; ++i){
+        EXPECT_NEAR(u[i], uRef[i], 1e-12);
+    }
+
+    // rank-2 through the matrix interface
+    Matrix<double> X(n, 2, 0.0);
+    X(6,0) = 1.5; X(7,0) = -0.5;
+    X(12,1) = 1.0;
+    chol.rankUpdate(X);
+    chol.rankDowndate(X);
+    u = chol.solve(b);
+    for (size_t i = 0; i < n; ++i){
+        EXPECT_NEAR(u[i], uRef[i], 1e-12);
+    }
+
+    // entries 0 and 24 are not coupled, the pattern of L would change
+    std::vector<double> far(n, 0.0);
+    far[0] = 1.0;
+    far[24] = 1.0;
+    EXPECT_THROW(chol.update(far), std::invalid_argument);
+
+    std::vector<double> big(n, 0.0);
+    big[12] = 10.0;
+    EXPECT_THROW(chol.downdate(big), std::runtime_error);
+}
+
+TEST(SparseCholeskyTest, IdentityOrderingAndRefactorization)
+{
+    SparseMatrix<double> A = laplacian2D(4);
+    size_t n = 16;
+
+    std::vector<size_t> perm(n);
+    for (size_t i = 0; i < n; ++i) perm[i] = i;
+
+    SparseCholesky<double> chol(A, perm);
+
+    std::vector<double> b(n, 1.0);
+    std::vector<double> r = A.mVm(chol.solve(b));
+    for (size_t i = 0; i < n; ++i){
+        EXPECT_NEAR(r[i], 1.0, 1e-12);
+    }
+
+    // numeric refactorization of a scaled matrix reuses the symbolic analysis
+    for (double& v : A.getValues()) v *= 2.0;
+    chol.factorize(A);
+    std::vector<double> x = chol.solve(b);
+    r = A.mVm(x);
+    for (size_t i = 0; i < n; ++i){
+        EXPECT_NEAR(r[i], 1.0, 1e-12);
+    }
+}
+
+TEST(SparseCholeskyTest, ThrowsOnInvalidInput)
+{
+    SparseMatrix<double> A(2, 2, {{0,1}, {0,1}});
+    A(0,0) = 1.0; A(0,1) = 2.0;
+    A(1,0) = 2.0; A(1,1) = 1.0;  // indefinite
+
+    EXPECT_THROW(SparseCholesky<double> chol(A), std::runtime_error);
+    EXPECT_THROW(SparseCholesky<double> chol(A, {0,0}), std::invalid_argument);
+    EXPECT_THROW(SparseCholesky<double> chol(A, {0}), std::invalid_argument);
+}
+
+TEST(SparseCholeskyTest, SupernodalFactorOfCubeMatchesDenseCholesky)
+{
+    // 7-point Laplacian on an 8 x 8 x 8 grid, nested dissection gives wide supernodes for the separators
+    size_t m = 8;
+    size_t n = m*m*m;
+    std::vector<std::vector<size_t>> pattern(n);
+    std::vector<std::array<double,3>> xyz(n);
+    for (size_t k = 0; k < n; ++k){
+        size_t x = k%m, y = (k/m)%m, z = k/(m*m);
+        xyz[k] = {double(x), double(y), double(z)};
+        pattern[k].push_back(k);
+        if (x > 0)   pattern[k].push_back(k-1);
+        if (x+1 < m) pattern[k].push_back(k+1);
+        if (y > 0)   pattern[k].push_back(k-m);
+        if (y+1 < m) pattern[k].push_back(k+m);
+        if (z > 0)   pattern[k].push_back(k-m*m);
+        if (z+1 < m) pattern[k].push_back(k+m*m);
+    }
+
+    SparseMatrix<double> A(n, n, pattern);
+    for (size_t k = 0; k < n; ++k){
+        for (size_t c : pattern[k]){
+            A(k,c) = (c == k) ? 6.5 : -1.0;
+        }
+    }
+
+    SparseCholesky<double> chol(A, nestedDissectionOrdering(pattern, xyz, 8));
+
+    std::vector<double> b(n);
+    for (size_t i = 0; i < n; ++i) b[i] = std::sin(0.1*i);
+
+    Matrix<double> L = A.toDense().cho();
+    std::vector<double> xd = L.transposedBackwardSubstitution(L.forwardSubstitution(b));
+    std::vector<double> x = chol.solve(b);
+    for (size_t i = 0; i < n; ++i){
+        EXPECT_NEAR(x[i], xd[i], 1e-12);
+    }
+
+    Matrix<double> B(n, 3, 0.0);
+    for (size_t i = 0; i < n; ++i){
+        B(i,0) = b[i];
+        B(i,1) = std::cos(0.3*i);
+        B(i,2) = 1.0;
+    }
+    Matrix<double> X = chol.blockSolve(B);
+    for (size_t i = 0; i < n; ++i){
+        EXPECT_NEAR(X(i,0), xd[i], 1e-12);
+    }
+
+    // update with a coupled pair in the middle of the grid, refactorization as reference
+    size_t c0 = (4*m + 4)*m + 4;
+    std::vector<double> u(n, 0.0);
+    u[c0] = 0.8;
+    u[c0+m*m] = -0.6;
+    chol.update(u);
+
+    SparseMatrix<double> Au(A);
+    Au(c0,c0) += 0.64; Au(c0+m*m,c0+m*m) += 0.36;
+    Au(c0,c0+m*m) -= 0.48; Au(c0+m*m,c0) -= 0.48;
+    std::vector<double> xu = chol.solve(b);
+    std::vector<double> xr = SparseCholesky<double>(Au, chol.getPermutation()).solve(b);
+    for (size_t i = 0; i < n; ++i){
+        EXPECT_NEAR(xu[i], xr[i], 1e-12);
+    }
+
+    // a negative diagonal in the last separator is found by the supernodal pivots
+    SparseMatrix<double> Aneg(A);
+    Aneg(chol.getPermutation()[n-1], chol.getPermutation()[n-1]) = -1.0;
+    EXPECT_THROW(chol.factorize(Aneg), std::runtime_error);
+}
@@ -0,0 +1,60 @@
+#include "../include/math/SparseMatrix.h"
+#include <gtest/gtest.h>
+
+TEST(SparseMatrixTest, PatternIsSortedAndUnique)
+{
+    SparseMatrix<double> S(3, 3, {{2,0,0}, {1}, {2,1,0,1}});
+
+    EXPECT_EQ(S.getSize()[0], 3);
+    EXPECT_EQ(S.getSize()[1], 3);
+    EXPECT_EQ(S.getNNZ(), 6);
+
+    std::vector<size_t> rowPtr = {0,2,3,6};
+    std::vector<size_t> colIdx = {0,2,1,0,1,2};
+    EXPECT_EQ(S.getRowPtr(), rowPtr);
+    EXPECT_EQ(S.getColIdx(), colIdx);
+}
+
+TEST(SparseMatrixTest, AccessInsideAndOutsidePattern)
+{
+    SparseMatrix<double> S(2, 3, {{0,2}, {1}});
+
+    S(0,2) = 4.0;
+    S.addValue(0,2, 1.0);
+    S.addValue(1,1, -2.0);
+
+    const SparseMatrix<double>& C = S;
+    EXPECT_DOUBLE_EQ(C(0,2), 5.0);
+    EXPECT_DOUBLE_EQ(C(1,1), -2.0);
+    EXPECT_DOUBLE_EQ(C(1,0), 0.0);
+
+    EXPECT_THROW(S(1,0), std::invalid_argument);
+    EXPECT_THROW(S.addValue(0,1, 1.0), std::invalid_argument);
+    EXPECT_THROW(C(2,0), std::out_of_range);
+    EXPECT_THROW(SparseMatrix<double>(2, 2, {{0,2}, {1}}), std::out_of_range);
+
+    S.setZero();
+    EXPECT_DOUBLE_EQ(S(0,2), 0.0);
+    EXPECT_EQ(S.getNNZ(), 3);
+}
+
+TEST(SparseMatrixTest, mVmAndDenseMatch)
+{
+    SparseMatrix<double> S(3, 3, {{0,1}, {0,1,2}, {1,2}});
+    S(0,0) = 2;  S(0,1) = -1;
+    S(1,0) = -1; S(1,1) = 2;  S(1,2) = -1;
+    S(2,1) = -1; S(2,2) = 2;
+
+    Matrix<double> D = S.toDense();
+    std::vector<double> x = {1.0, 2.0, 3.0};
+
+    std::vector<double> ys = S.mVm(x);
+    std::vector<double> yd = D.mVm(x);
+
+    ASSERT_EQ(ys.size(), 3);
+    for (size_t i = 0; i < 3; ++i){
+        EXPECT_DOUBLE_EQ(ys[i], yd[i]);
+    }
+    EXPECT_DOUBLE_EQ(D(0,2), 0.0);
+    EXPECT_THROW(S.mVm({1.0}), std::invalid_argument);
+}
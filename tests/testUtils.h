@@ -0,0 +1,66 @@
+#ifndef TESTUTILS_H
+#define TESTUTILS_H
+
+#include "../include/barOP/trussStructure.h"
+#include "../include/math/Parallel.h"
+#include <cstddef>
+
+/**
+ * Test helper that changes the thread count of the global pool and restores the previous count
+ * when it goes out of scope, also if the code under test throws or an assertion returns early.
+ */
+class ScopedNumThreads{
+
+    private:
+
+        size_t _previous;
+
+    public:
+
+        /**
+        * Constructor that saves the current thread count and sets a new one.
+        * @param numThreads Thread count for the lifetime of the object
+        */
+        explicit ScopedNumThreads(size_t numThreads) : _previous(getNumThreads()) {setNumThreads(numThreads);};
+
+        ScopedNumThreads(const ScopedNumThreads&) = delete;
+        ScopedNumThreads& operator=(const ScopedNumThreads&) = delete;
+
+        /**
+        * Destructor that restores the thread count saved by the constructor.
+        */
+        ~ScopedNumThreads() {setNumThreads(_previous);};
+
+        /**
+        * Member function that changes the thread count, the saved count is kept.
+        * @param numThreads New thread count
+        */
+        void set(size_t numThreads) {setNumThreads(numThreads);};
+};
+
+/**
+ * Test fixture: tetrahedron with node 1 fully fixed and nodes 2 and 3 partly fixed,
+ * loaded at the free node 4. Six free DOF remain.
+ * @param ts Empty truss structure that receives the model
+ */
+inline void buildTetrahedron(TrussStructure& ts){
+
+    Material& steel = ts.addMaterial("steel", 2e5);
+
+    Node& n1 = ts.addNode(0,0,0);
+    Node& n2 = ts.addNode(2,0,0);
+    Node& n3 = ts.addNode(0,3,0);
+    Node& n4 = ts.addNode(1,1,2);
+
+    ts.addTrussElement(n1, n2, steel, 1.0);
+    ts.addTrussElement(n2, n3, steel, 2.0);
+    ts.addTrussElement(n3, n1, steel, 1.5);
+    ts.addTrussElement(n1, n4, steel, 0.5);
+    ts.addTrussElement(n2, n4, steel, 0.7);
+    ts.addTrussElement(n3, n4, steel, 0.9);
+
+    ts.addBCs({1,2,3, 5,6, 9});
+    ts.addForces({10, 11, 12}, {5.0, -3.0, -20.0});
+};
+
+#endif
@@ -153,3 +153,50 @@ TEST(TrussElementTest, GlobalElStiffnessMatrixComputation)
         }
     }
 }
+
+TEST(TrussElementTest, FixedStiffnessKernelMatchesTransformation)
+{
+    Material mat("mat1",1E7);
+    Node n1(1, 0.32, 1.5, 0.1848);
+    Node n2(2, -0.4, 0.25, 1.0);
+
+    TrussElement elem(1, n1, n2, mat, 0.0012566);
+
+    std::array<double,3> c = elem.computeDirectionCosines();
+    EXPECT_NEAR(c[0]*c[0] + c[1]*c[1] + c[2]*c[2], 1.0, 1e-15);
+
+    // T^T*k*T with general matrix products as reference
+    Matrix<double> T = elem.computeTransformation();
+    Matrix<double> k = {{1, -1}, {-1, 1}};
+    Matrix<double> ref = T.transpose()*(k*(mat.getE()*elem.getArea()/elem.computeLength()))*T;
+
+    FixedMatrix<double,6,6> K = elem.computeGlobalStiffnessFixedMtx();
+    Matrix<double> Kd = elem.computeGlobalStiffnessMtx();
+    for (size_t i = 0; i < 6; ++i){
+        for (size_t j = 0; j < 6; ++j){
+            EXPECT_NEAR(K(i,j), ref(i,j), 1e-10);
+            EXPECT_DOUBLE_EQ(K(i,j), Kd(i,j));
+            EXPECT_DOUBLE_EQ(K(i,j), K(j,i));
+        }
+    }
+}
+
+TEST(TrussElementTest, NodeCoordinatesMatchPosition)
+{
+    Node n1(1, 1.5, -2.0, 3.25);
+    std::array<double,3> c = n1.getCoordinates();
+    std::vector<double> pos = n1.getPosition();
+    for (size_t d = 0; d < 3; ++d){
+        EXPECT_DOUBLE_EQ(c[d], pos[d]);
+    }
+
+    // views into structure-of-arrays storage follow moves
+    NodeArrays xyz;
+    xyz.x = {0.0, 1.0};
+    xyz.y = {0.0, 2.0};
+    xyz.z = {0.0, 3.0};
+    Node n2(2, xyz);
+    n2.moveNode(1.0, 0.0, -1.0);
+    EXPECT_EQ(n2.getCoordinates(), (std::array<double,3>{2.0, 2.0, 2.0}));
+    EXPECT_DOUBLE_EQ(xyz.x[1], 2.0);
+}
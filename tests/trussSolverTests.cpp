@@ -0,0 +1,162 @@
+#include "../include/barOP/trussSolver.h"
+#include "testUtils.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+TEST(TrussSolverTest, SolveMatchesSolveTrussSystem)
+{
+    TrussStructure ts;
+    buildTetrahedron(ts);
+
+    TrussSolver solver = ts.createSolver();
+    EXPECT_EQ(solver.getNumFreeDOF(), 6);
+    EXPECT_EQ(solver.getNumFactorizations(), 1);
+
+    std::vector<double> uRef = ts.solveTrussSystem();
+    std::vector<double> u = solver.solve();
+
+    ASSERT_EQ(u.size(), 12);
+    for (size_t i = 0; i < 12; ++i){
+        EXPECT_NEAR(u[i], uRef[i], 1e-12);
+    }
+
+    // new right hand side, no refactorization
+    std::vector<double> F(12, 0.0);
+    F[3] = 1.0;
+    F[0] = 100.0;  // fixed dof, ignored
+    std::vector<double> u2 = solver.solve(F);
+    EXPECT_EQ(solver.getNumFactorizations(), 1);
+    EXPECT_FALSE(solver.update());
+    EXPECT_DOUBLE_EQ(u2[0], 0.0);
+    EXPECT_GT(u2[3], 0.0);
+
+    EXPECT_THROW(solver.solve(std::vector<double>(5, 0.0)), std::invalid_argument);
+}
+
+TEST(TrussSolverTest, AreaAndShapeChangesRefactorize)
+{
+    TrussStructure ts;
+    buildTetrahedron(ts);
+
+    TrussSolver solver = ts.createSolver();
+
+    // one area change is a rank-1 update, no refactorization
+    ts.getElements()[4]->setArea(1.4);
+    std::vector<double> u = solver.solve();
+    EXPECT_EQ(solver.getNumFactorizations(), 1);
+    EXPECT_EQ(solver.getNumLowRankUpdates(), 1);
+
+    std::vector<double> uRef = ts.solveTrussSystem();
+    for (size_t i = 0; i < 12; ++i){
+        EXPECT_NEAR(u[i], uRef[i], 1e-12);
+    }
+
+    // two decreases are downdates
+    ts.getElements()[0]->setArea(0.3);
+    ts.getElements()[5]->setArea(0.2);
+    u = solver.solve();
+    EXPECT_EQ(solver.getNumFactorizations(), 1);
+    EXPECT_EQ(solver.getNumLowRankUpdates(), 3);
+
+    uRef = ts.solveTrussSystem();
+    for (size_t i = 0; i < 12; ++i){
+        EXPECT_NEAR(u[i], uRef[i], 1e-10*std::abs(uRef[i]) + 1e-14);
+    }
+
+    // a moved node changes directions, full refactorization
+    ts.getNodes()[3]->moveNode(0.1, -0.2, 0.3);
+    u = solver.solve();
+    EXPECT_EQ(solver.getNumFactorizations(), 2);
+
+    uRef = ts.solveTrussSystem();
+    for (size_t i = 0; i < 12; ++i){
+        EXPECT_NEAR(u[i], uRef[i], 1e-12);
+    }
+
+    solver.solve();
+    EXPECT_EQ(solver.getNumFactorizations(), 2);
+
+    solver.setMaxLowRankUpdates(0);
+    ts.getElements()[2]->setArea(2.0);
+    solver.solve();
+    EXPECT_EQ(solver.getNumFactorizations(), 3);
+    EXPECT_EQ(solver.getNumLowRankUpdates(), 3);
+
+    // the cap counts modifications since the last factorization, not per solve
+    solver.setMaxLowRankUpdates(3);
+    for (size_t k = 0; k < 3; ++k){
+        ts.getElements()[k]->setArea(1.0 + 0.1*k);
+        solver.solve();
+        EXPECT_EQ(solver.getNumFactorizations(), 3);
+    }
+    EXPECT_EQ(solver.getNumLowRankUpdates(), 6);
+    ts.getElements()[3]->setArea(0.6);
+    u = solver.solve();
+    EXPECT_EQ(solver.getNumFactorizations(), 4);
+    EXPECT_EQ(solver.getNumLowRankUpdates(), 6);
+    ts.getElements()[4]->setArea(1.5);
+    solver.solve();
+    EXPECT_EQ(solver.getNumFactorizations(), 4);
+    EXPECT_EQ(solver.getNumLowRankUpdates(), 7);
+
+    EXPECT_THROW(ts.getElements()[0]->setArea(0.0), std::invalid_argument);
+}
+
+TEST(TrussSolverTest, ThrowsOnTopologyOrConditionChange)
+{
+    TrussStructure ts;
+    buildTetrahedron(ts);
+
+    TrussSolver solver = ts.createSolver();
+
+    ts.addBCs({4});
+    EXPECT_THROW(solver.solve(), std::runtime_error);
+
+    TrussStructure ts2;
+    buildTetrahedron(ts2);
+    TrussSolver solver2 = ts2.createSolver();
+
+    ts2.addNode(5,5,5);
+    EXPECT_THROW(solver2.update(), std::runtime_error);
+}
+
+TEST(TrussSolverTest, SolveWithoutElementMatchesDamagedStructure)
+{
+    // tetrahedron with one redundant member to an extra support
+    TrussStructure ts;
+    buildTetrahedron(ts);
+    Node& n5 = ts.addNode(3,3,3);
+    ts.addTrussElement(*ts.getNodes()[3], n5, ts.getElements()[0]->getMaterial(), 0.4);
+    ts.addBCs({13,14,15});
+
+    TrussStructure damaged;
+    buildTetrahedron(damaged);
+    damaged.addNode(3,3,3);
+    damaged.addBCs({13,14,15});
+
+    TrussSolver solver = ts.createSolver();
+    std::vector<double> uIntact = solver.solve();
+    std::vector<double> u = solver.solveWithoutElement(6);
+    std::vector<double> uRef = damaged.solveTrussSystem();
+
+    ASSERT_EQ(u.size(), 15);
+    for (size_t i = 0; i < 15; ++i){
+        EXPECT_NEAR(u[i], uRef[i], 1e-10*std::abs(uRef[i]) + 1e-14);
+    }
+
+    // the solver itself is not modified
+    std::vector<double> u2 = solver.solve();
+    for (size_t i = 0; i < 15; ++i){
+        EXPECT_DOUBLE_EQ(u2[i], uIntact[i]);
+    }
+    EXPECT_NE(u[9], uIntact[9]);
+
+    EXPECT_THROW(solver.solveWithoutElement(7), std::out_of_range);
+
+    // the tetrahedron alone is statically determinate, every member is needed
+    TrussSolver tetSolver = damaged.createSolver();
+    for (size_t e = 0; e < 6; ++e){
+        EXPECT_THROW(tetSolver.solveWithoutElement(e), std::runtime_error);
+    }
+}
@@ -0,0 +1,53 @@
+#include "../include/barOP/trussStiffnessOperator.h"
+#include "testUtils.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(TrussStiffnessOperatorTest, ApplyMatchesAssembledMatrix)
+{
+    TrussStructure ts;
+    buildTetrahedron(ts);
+
+    TrussStiffnessOperator K_op(ts);
+
+    Matrix<double> K = ts.assembleStffMtx();
+    std::vector<double> F = ts.createForceVector();
+    ts.applyHomBCs(K, F);
+
+    ASSERT_EQ(K_op.getSize()[0], 6);
+    ASSERT_EQ(K.getSize()[0], 6);
+
+    std::vector<double> x = {0.3, -1.0, 2.0, 0.5, -0.25, 1.5};
+    std::vector<double> y = K_op.mVm(x);
+    std::vector<double> yRef = K.mVm(x);
+
+    std::vector<double> diag = K_op.getDiagonal();
+
+    for (size_t i = 0; i < 6; ++i){
+        EXPECT_NEAR(y[i], yRef[i], 1e-9);
+        EXPECT_NEAR(diag[i], K(i,i), 1e-9);
+    }
+
+    EXPECT_THROW(K_op.mVm({1.0}), std::invalid_argument);
+}
+
+TEST(TrussStiffnessOperatorTest, MatrixFreeSolveMatchesDirect)
+{
+    TrussStructure ts;
+    buildTetrahedron(ts);
+
+    std::vector<double> uRef = ts.solveTrussSystem();
+
+    ts.setSolverType(SolverType::MatrixFree);
+    ts.setPCGSettings(PreconditionerType::Jacobi, 1e-12, 100);
+    std::vector<double> u = ts.solveTrussSystem();
+
+    CGReport<double> report;
+    ts.solveTrussSystemMatrixFree(report);
+    EXPECT_TRUE(report.converged);
+
+    ASSERT_EQ(u.size(), 12);
+    for (size_t i = 0; i < 12; ++i){
+        EXPECT_NEAR(u[i], uRef[i], 1e-9);
+    }
+}
@@ -1,4 +1,5 @@
 #include "../include/barOP/trussStructure.h"
+#include "testUtils.h"
 #include <gtest/gtest.h>
 #include <vector>
 
@@ -130,6 +131,116 @@ TEST(TrussStructureTest, ApplyHomBCsRemovesRowsAndCols)
     EXPECT_EQ(F.size(), 3);
 }
 
+TEST(TrussStructureTest, ReducedAssemblyMatchesApplyHomBCs)
+{
+    TrussStructure ts;
+    Material& steel = ts.addMaterial("steel", 1e7);
+
+    Node& n1 = ts.addNode(0,0,0);
+    Node& n2 = ts.addNode(1,0,0);
+    Node& n3 = ts.addNode(0,1,0);
+    Node& n4 = ts.addNode(0,0,1);
+    ts.addTrussElement(n1, n2, steel, 0.01);
+    ts.addTrussElement(n1, n3, steel, 0.01);
+    ts.addTrussElement(n1, n4, steel, 0.02);
+    ts.addTrussElement(n2, n3, steel, 0.01);
+    ts.addTrussElement(n3, n4, steel, 0.01);
+
+    ts.addBCs({4,5,6,8,12,11});
+    ts.addForces({1,3,10}, {100.0,-50.0,25.0});
+
+    std::vector<long> freeMap = ts.createFreeDOFMap();
+    ASSERT_EQ(freeMap.size(), 12);
+    EXPECT_EQ(freeMap[0], 0);
+    EXPECT_EQ(freeMap[3], -1);
+    EXPECT_EQ(freeMap[6], 3);
+    EXPECT_EQ(freeMap[8], 4);
+    EXPECT_EQ(freeMap[9], 5);
+
+    Matrix<double> K = ts.assembleStffMtx();
+    std::vector<double> F = ts.createForceVector();
+    ts.applyHomBCs(K, F);
+
+    Matrix<double> K_red = ts.assembleReducedStffMtx();
+    std::vector<double> F_red = ts.createReducedForceVector();
+
+    ASSERT_EQ(K_red.getSize()[0], 6);
+    ASSERT_EQ(K.getSize()[0], 6);
+    ASSERT_EQ(F_red.size(), 6);
+    for (size_t i = 0; i < 6; ++i){
+        EXPECT_DOUBLE_EQ(F_red[i], F[i]);
+        for (size_t j = 0; j < 6; ++j){
+            EXPECT_NEAR(K_red(i,j), K(i,j), 1e-9);
+        }
+    }
+
+    PackedMatrix<double> K_packed = ts.assembleReducedPackedStffMtx();
+    const PackedMatrix<double>& Kp = K_packed;
+    ASSERT_EQ(Kp.getSize()[0], 6);
+    for (size_t i = 0; i < 6; ++i){
+        for (size_t j = 0; j < 6; ++j){
+            EXPECT_DOUBLE_EQ(Kp(i,j), K_red(i,j));
+        }
+    }
+
+    SparseMatrix<double> K_sparse = ts.assembleReducedSparseStffMtx();
+    const SparseMatrix<double>& Ks = K_sparse;
+    ASSERT_EQ(Ks.getSize()[0], 6);
+    for (size_t i = 0; i < 6; ++i){
+        for (size_t j = 0; j < 6; ++j){
+            EXPECT_NEAR(Ks(i,j), K_red(i,j), 1e-9);
+        }
+    }
+
+    SparseMatrix<double> K_full = ts.assembleSparseStffMtx();
+    std::vector<double> F_short(11, 1.0);
+    EXPECT_THROW(ts.applyHomBCs(K_full, F_short), std::invalid_argument);
+    SparseMatrix<double> K_wrong = K_sparse;
+    std::vector<double> F_full = ts.createForceVector();
+    EXPECT_THROW(ts.applyHomBCs(K_wrong, F_full), std::invalid_argument);
+    ts.applyHomBCs(K_full, F_full);
+    ASSERT_EQ(K_full.getSize()[0], 6);
+    EXPECT_EQ(F_full, F_red);
+}
+
+TEST(TrussStructureTest, SparseAssemblyMatchesDense)
+{
+    TrussStructure ts;
+    Material& steel = ts.addMaterial("steel", 1e7);
+
+    Node& n1 = ts.addNode(0,0,0);
+    Node& n2 = ts.addNode(1,0,0);
+    Node& n3 = ts.addNode(0,1,0);
+    Node& n4 = ts.addNode(0,0,1);
+    Node& n5 = ts.addNode(5,5,5);   // unconnected node
+
+    ts.addTrussElement(n1, n2, steel, 0.01);
+    ts.addTrussElement(n2, n3, steel, 0.02);
+    ts.addTrussElement(n3, n4, steel, 0.03);
+    ts.addTrussElement(n4, n1, steel, 0.04);
+    ts.addTrussElement(n2, n4, steel, 0.05);
+    (void)n5;
+
+    Matrix<double> K = ts.assembleStffMtx();
+    SparseMatrix<double> Ks = ts.assembleSparseStffMtx();
+
+    ASSERT_EQ(Ks.getSize()[0], 15);
+    // (4 diagonal + 2*5 off-diagonal node blocks) * 9, node 5 has no entries
+    EXPECT_EQ(Ks.getNNZ(), 126);
+
+    const SparseMatrix<double>& Kc = Ks;
+    for (size_t i = 0; i < 15; ++i){
+        for (size_t j = 0; j < 15; ++j){
+            EXPECT_NEAR(K(i,j), Kc(i,j), 1e-9);
+        }
+    }
+
+    // Numeric refill keeps the pattern
+    ts.fillSparseStffMtx(Ks);
+    EXPECT_EQ(Ks.getNNZ(), 126);
+    EXPECT_NEAR(K(3,3), Ks(3,3), 1e-9);
+}
+
 // ----------------------
 // Solver tests (size-only)
 // ----------------------
@@ -286,3 +397,630 @@ TEST(TrussStructureTest, NumericExample3D)
     }
 
 }
+
+TEST(TrussStructureTest, SparseAndDenseSolversAgree3D)
+{
+    // Radio tower example taken from:
+    // Fox, R. L. and Schmit, L. A., Advances in the integrated approach to structural synthesis, 1964.
+
+    TrussStructure t1;
+
+    Node& n1 = t1.addNode(-37.5,0,200);
+    Node& n2 = t1.addNode(37.5,0,200);
+    Node& n3 = t1.addNode(-37.5,37.5,100);
+    Node& n4 = t1.addNode(37.5,37.5,100);
+    Node& n5 = t1.addNode(37.5,-37.5,100);
+    Node& n6 = t1.addNode(-37.5,-37.5,100);
+    Node& n7 = t1.addNode(-100,100,0);
+    Node& n8 = t1.addNode(100,100,0);
+    Node& n9 = t1.addNode(100,-100,0);
+    Node& n10 = t1.addNode(-100,-100,0);
+
+    Material& M = t1.addMaterial("psiMat", 1E7);
+
+    t1.addTrussElement(n1, n2, M, 0.033);
+    t1.addTrussElement(n1, n4, M, 2.015);
+    t1.addTrussElement(n2, n3, M, 2.015);
+    t1.addTrussElement(n1, n5, M, 2.015);
+    t1.addTrussElement(n6, n2, M, 2.015);
+    t1.addTrussElement(n2, n4, M, 2.823);
+    t1.addTrussElement(n5, n2, M, 2.823);
+    t1.addTrussElement(n1, n3, M, 2.823);
+    t1.addTrussElement(n1, n6, M, 2.823);
+    t1.addTrussElement(n3, n6, M, 0.010);
+    t1.addTrussElement(n4, n5, M, 0.010);
+    t1.addTrussElement(n3, n4, M, 0.014);
+    t1.addTrussElement(n5, n6, M, 0.014);
+    t1.addTrussElement(n10, n3, M, 0.980);
+    t1.addTrussElement(n6, n7, M, 0.980);
+    t1.addTrussElement(n4, n9, M, 0.980);
+    t1.addTrussElement(n8, n5, M, 0.980);
+    t1.addTrussElement(n4, n7, M, 1.760);
+    t1.addTrussElement(n3, n8, M, 1.760);
+    t1.addTrussElement(n10, n5, M, 1.760);
+    t1.addTrussElement(n6, n9, M, 1.760);
+    t1.addTrussElement(n6, n10, M, 2.440);
+    t1.addTrussElement(n3, n7, M, 2.440);
+    t1.addTrussElement(n5, n9, M, 2.440);
+    t1.addTrussElement(n4, n8, M, 2.440);
+
+    t1.addBCs({19,20,21,22,23,24,25,26,27,28,29,30});
+    t1.addForces({1,2,3,5,6,7,17}, {1000, 10000, -5000, 10000, -5000, 500, 500});
+
+    EXPECT_EQ(t1.getSolverType(), SolverType::Sparse);
+    std::vector<double> uSparse = t1.solveTrussSystem();
+
+    t1.setSolverType(SolverType::Dense);
+    std::vector<double> uDense = t1.solveTrussSystem();
+
+    t1.setSolverType(SolverType::PCG);
+    std::vector<double> uPCG = t1.solveTrussSystem();
+
+    ASSERT_EQ(uSparse.size(), 30);
+    ASSERT_EQ(uDense.size(), 30);
+    ASSERT_EQ(uPCG.size(), 30);
+    for (size_t i = 0; i < 30; ++i){
+        EXPECT_NEAR(uSparse[i], uDense[i], 1e-10);
+        EXPECT_NEAR(uPCG[i], uDense[i], 1e-6*std::abs(uDense[i]) + 1e-12);
+    }
+
+    for (PreconditionerType p : {PreconditionerType::None, PreconditionerType::Jacobi,
+                                 PreconditionerType::SSOR, PreconditionerType::IncompleteCholesky}){
+        t1.setPCGSettings(p, 1e-12, 1000);
+        CGReport<double> report;
+        std::vector<double> u = t1.solveTrussSystemPCG(report);
+
+        EXPECT_TRUE(report.converged);
+        EXPECT_EQ(report.residualHistory.size(), report.iterations + 1);
+        EXPECT_NEAR(u[1], uDense[1], 1e-6*std::abs(uDense[1]));
+    }
+
+    t1.setPCGSettings(PreconditionerType::SSOR, 1e-12, 1000, 1.5);
+    CGReport<double> ssorReport;
+    EXPECT_NEAR(t1.solveTrussSystemPCG(ssorReport)[1], uDense[1], 1e-6*std::abs(uDense[1]));
+    EXPECT_TRUE(ssorReport.converged);
+    EXPECT_THROW(t1.setPCGSettings(PreconditionerType::SSOR, 1e-12, 1000, 2.0), std::invalid_argument);
+
+    t1.setPCGSettings(PreconditionerType::None, 1e-12, 2);
+    EXPECT_THROW(t1.solveTrussSystem(), std::runtime_error);
+    EXPECT_DOUBLE_EQ(uSparse[20], 0.0);
+
+    // float factorization, double accuracy through iterative refinement
+    t1.setSolverType(SolverType::MixedPrecision);
+    std::vector<double> uMixed = t1.solveTrussSystem();
+    ASSERT_EQ(uMixed.size(), 30);
+    for (size_t i = 0; i < 30; ++i){
+        EXPECT_NEAR(uMixed[i], uDense[i], 1e-9*std::abs(uDense[i]) + 1e-12);
+    }
+
+    RefinementReport<double> refinement;
+    t1.solveTrussSystemMixedPrecision(refinement);
+    EXPECT_TRUE(refinement.converged);
+    EXPECT_EQ(refinement.backwardErrorHistory.size(), refinement.iterations + 1);
+    EXPECT_LT(refinement.backwardErrorHistory.back(), 1e-15);
+
+    EXPECT_THROW(t1.setRefinementSettings(0.0, 10), std::invalid_argument);
+    t1.setRefinementSettings(1e-30, 10);
+    EXPECT_THROW(t1.solveTrussSystem(), std::runtime_error);
+}
+
+TEST(TrussStructureTest, MixedPrecisionConvergesInSIUnits)
+{
+    // steel box girder in N and m, the relative residual of a double solve stalls near cond(K)*eps
+    TrussStructure t;
+    Material& steel = t.addMaterial("steel", 2.1e11);
+    const int bays = 12;
+    std::vector<Node*> n;
+    for (int i = 0; i <= bays; ++i){
+        n.push_back(&t.addNode(2.0*i, 0.0, 0.0));
+        n.push_back(&t.addNode(2.0*i, 1.2, 0.0));
+        n.push_back(&t.addNode(2.0*i, 0.0, 1.5));
+        n.push_back(&t.addNode(2.0*i, 1.2, 1.5));
+    }
+    for (int i = 0; i <= bays; ++i){
+        Node** a = &n[4*i];
+        t.addTrussElement(*a[0], *a[1], steel, 5e-4);
+        t.addTrussElement(*a[2], *a[3], steel, 5e-4);
+        t.addTrussElement(*a[0], *a[2], steel, 5e-4);
+        t.addTrussElement(*a[1], *a[3], steel, 5e-4);
+        if (i == bays) break;
+        Node** b = &n[4*(i+1)];
+        for (int k = 0; k < 4; ++k) t.addTrussElement(*a[k], *b[k], steel, 1e-3);
+        t.addTrussElement(*a[0], *b[2], steel, 5e-4);
+        t.addTrussElement(*a[1], *b[3], steel, 5e-4);
+        t.addTrussElement(*a[2], *b[3], steel, 5e-4);
+        t.addTrussElement(*a[0], *b[1], steel, 5e-4);
+    }
+
+    std::vector<int> bcs;
+    for (int k = 0; k < 4; ++k){
+        int id = n[k]->getID();
+        bcs.insert(bcs.end(), {3*id-2, 3*id-1, 3*id});
+    }
+    bcs.push_back(3*n[4*bays]->getID());
+    bcs.push_back(3*n[4*bays+1]->getID()-1);
+    bcs.push_back(3*n[4*bays+1]->getID());
+    t.addBCs(bcs);
+
+    std::vector<int> dofs;
+    std::vector<double> forces;
+    for (int i = 1; i < bays; ++i){
+        dofs.push_back(3*n[4*i+2]->getID());
+        forces.push_back(-1e4);
+        dofs.push_back(3*n[4*i+3]->getID()-1);
+        forces.push_back(2e3);
+    }
+    t.addForces(dofs, forces);
+
+    t.setSolverType(SolverType::Dense);
+    std::vector<double> uDense = t.solveTrussSystem();
+
+    // default refinement settings
+    t.setSolverType(SolverType::MixedPrecision);
+    std::vector<double> uMixed;
+    ASSERT_NO_THROW(uMixed = t.solveTrussSystem());
+    for (size_t i = 0; i < uDense.size(); ++i){
+        EXPECT_NEAR(uMixed[i], uDense[i], 1e-9*std::abs(uDense[i]) + 1e-15);
+    }
+
+    RefinementReport<double> refinement;
+    t.solveTrussSystemMixedPrecision(refinement);
+    EXPECT_TRUE(refinement.converged);
+    EXPECT_LT(refinement.backwardErrorHistory.back(), 1e-15);
+}
+
+TEST(TrussStructureTest, RenumberNodesAndSkylineSolve)
+{
+    // Felippa bridge with scrambled node numbering
+    std::vector<std::vector<double>> coords = {
+        {30,0,0}, {0,0,0}, {60,0,0}, {10,5,0}, {50,5,0}, {20,0,0},
+        {40,8,0}, {10,0,0}, {50,0,0}, {20,8,0}, {40,0,0}, {30,9,0}};
+
+    TrussStructure t1;
+    std::vector<Node*> n;
+    for (const auto& c : coords){
+        n.push_back(&t1.addNode(c[0], c[1], c[2]));
+    }
+    Material& mat = t1.addMaterial("mat1", 1000.00);
+
+    // bottom chord, top chord, verticals, diagonals (0-based positions in coords)
+    std::vector<std::vector<size_t>> conn = {
+        {1,7},{7,5},{5,0},{0,10},{10,8},{8,2},
+        {1,3},{3,9},{9,11},{11,6},{6,4},{4,2},
+        {3,7},{9,5},{11,0},{6,10},{4,8},
+        {3,5},{9,0},{0,6},{10,4}};
+    std::vector<double> area = {2,2,2,2,2,2, 10,10,10,10,10,10, 3,3,3,3,3, 1,1,1,1};
+    for (size_t e = 0; e < conn.size(); ++e){
+        t1.addTrussElement(*n[conn[e][0]], *n[conn[e][1]], mat, area[e]);
+    }
+
+    // pin at x=0, roller at x=60, planar problem
+    std::vector<int> bc = {4,5,6, 8};
+    for (int id = 1; id <= 12; ++id){
+        if (id != 2) bc.push_back(3*id);
+    }
+    t1.addBCs(bc);
+    t1.addForces({3*8-1, 3*6-1, 3*1-1, 3*11-1, 3*9-1}, {-10, -10, -16, -10, -10});
+
+    t1.setSolverType(SolverType::Dense);
+    std::vector<double> uRef = t1.solveTrussSystem();
+    size_t bandwidthRef = SkylineMatrix<double>(t1.assembleSparseStffMtx()).getBandwidth();
+
+    std::vector<int> newID = t1.renumberNodes();
+
+    ASSERT_EQ(newID.size(), 12);
+    for (size_t i = 0; i < 12; ++i){
+        EXPECT_EQ(n[i]->getID(), newID[i]);
+        EXPECT_EQ(t1.getNodes()[newID[i]-1].get(), n[i]);
+    }
+    EXPECT_EQ(t1.getConditions().size(), bc.size());
+    EXPECT_TRUE(t1.getConditions().count(3*newID[1]-2));
+    EXPECT_DOUBLE_EQ(t1.getForces().at(3*newID[0]-1), -16.0);
+
+    SkylineMatrix<double> K(t1.assembleSparseStffMtx());
+    EXPECT_LT(K.getBandwidth(), bandwidthRef);
+    EXPECT_LE(K.getBandwidth(), 11);
+
+    t1.setSolverType(SolverType::Skyline);
+    std::vector<double> u = t1.solveTrussSystem();
+
+    // top chord midspan deflection from Felippa
+    EXPECT_NEAR(u[3*(newID[11]-1)+1], -2.385940, 1e-4);
+    for (size_t i = 0; i < 12; ++i){
+        for (int d = 0; d < 3; ++d){
+            EXPECT_NEAR(u[3*(newID[i]-1)+d], uRef[3*i+d], 1e-9);
+        }
+    }
+}
+
+TEST(TrussStructureTest, LoadCasesShareOneFactorization)
+{
+    // Felippa bridge with scrambled node numbering
+    std::vector<std::vector<double>> coords = {
+        {30,0,0}, {0,0,0}, {60,0,0}, {10,5,0}, {50,5,0}, {20,0,0},
+        {40,8,0}, {10,0,0}, {50,0,0}, {20,8,0}, {40,0,0}, {30,9,0}};
+
+    TrussStructure t1;
+    std::vector<Node*> n;
+    for (const auto& c : coords){
+        n.push_back(&t1.addNode(c[0], c[1], c[2]));
+    }
+    Material& mat = t1.addMaterial("mat1", 1000.00);
+
+    std::vector<std::vector<size_t>> conn = {
+        {1,7},{7,5},{5,0},{0,10},{10,8},{8,2},
+        {1,3},{3,9},{9,11},{11,6},{6,4},{4,2},
+        {3,7},{9,5},{11,0},{6,10},{4,8},
+        {3,5},{9,0},{0,6},{10,4}};
+    std::vector<double> area = {2,2,2,2,2,2, 10,10,10,10,10,10, 3,3,3,3,3, 1,1,1,1};
+    for (size_t e = 0; e < conn.size(); ++e){
+        t1.addTrussElement(*n[conn[e][0]], *n[conn[e][1]], mat, area[e]);
+    }
+
+    std::vector<int> bc = {4,5,6, 8};
+    for (int id = 1; id <= 12; ++id){
+        if (id != 2) bc.push_back(3*id);
+    }
+    t1.addBCs(bc);
+
+    std::vector<int> dofA = {3*8-1, 3*6-1, 3*1-1, 3*11-1, 3*9-1};
+    std::vector<double> forceA = {-10, -10, -16, -10, -10};
+    t1.addForces(dofA, forceA);
+
+    EXPECT_EQ(t1.addLoadCase("gravity", dofA, forceA), 0);
+    EXPECT_EQ(t1.addLoadCase("wind", {3*12-2, 3*4-2}, {5, 3}), 1);
+    EXPECT_EQ(t1.addLoadCase("combined", {3*8-1, 3*6-1, 3*1-1, 3*11-1, 3*9-1, 3*12-2, 3*4-2},
+                                         {-20, -20, -32, -20, -20, -5, -3}), 2);
+    EXPECT_THROW(t1.addLoadCase("bad", {1,2}, {1.0}), std::invalid_argument);
+    ASSERT_EQ(t1.getLoadCases().size(), 3);
+
+    t1.setSolverType(SolverType::Dense);
+    std::vector<double> uRef = t1.solveTrussSystem();
+
+    for (SolverType s : {SolverType::Dense, SolverType::Sparse, SolverType::Skyline,
+                         SolverType::PCG, SolverType::MatrixFree, SolverType::MixedPrecision}){
+        t1.setSolverType(s);
+        std::vector<LoadCaseResult> res = t1.solveLoadCases();
+
+        ASSERT_EQ(res.size(), 3);
+        EXPECT_EQ(res[1].name, "wind");
+        ASSERT_EQ(res[0].displacements.size(), 36);
+        ASSERT_EQ(res[0].strains.size(), 21);
+        ASSERT_EQ(res[0].stresses.size(), 21);
+        ASSERT_EQ(res[0].axialForces.size(), 21);
+        ASSERT_EQ(res[0].utilizations.size(), 21);
+
+        for (size_t i = 0; i < 36; ++i){
+            EXPECT_NEAR(res[0].displacements[i], uRef[i], 1e-7);
+            // combined = 2*gravity - wind
+            EXPECT_NEAR(res[2].displacements[i], 2*res[0].displacements[i] - res[1].displacements[i], 1e-7);
+        }
+
+        std::vector<double> stresses = t1.computeStresses(res[1].displacements);
+        for (size_t e = 0; e < 21; ++e){
+            EXPECT_DOUBLE_EQ(res[1].stresses[e], stresses[e]);
+        }
+    }
+
+    // load cases follow the renumbering
+    std::vector<int> newID = t1.renumberNodes();
+    EXPECT_DOUBLE_EQ(t1.getLoadCases()[1].forces.at(3*newID[11]-2), 5.0);
+
+    t1.setSolverType(SolverType::Sparse);
+    std::vector<LoadCaseResult> res = t1.solveLoadCases();
+    for (size_t i = 0; i < 12; ++i){
+        EXPECT_NEAR(res[0].displacements[3*(newID[i]-1)+1], uRef[3*i+1], 1e-9);
+    }
+
+    t1.clearLoadCases();
+    EXPECT_TRUE(t1.solveLoadCases().empty());
+}
+
+TEST(TrussStructureTest, ParallelColoredAssemblyIsDeterministic)
+{
+    // braced lattice, enough elements for several tasks per color
+    const int nx = 20, ny = 12, nz = 3;
+    TrussStructure ts;
+    std::vector<Node*> n;
+    for (int k = 0; k < nz; ++k){
+        for (int j = 0; j < ny; ++j){
+            for (int i = 0; i < nx; ++i){
+                n.push_back(&ts.addNode(i, j + 0.1*i, 1.5*k));
+            }
+        }
+    }
+    Material& mat = ts.addMaterial("steel", 210000.0);
+    auto id = [&](int i, int j, int k){ return static_cast<size_t>(i + nx*(j + ny*k)); };
+    for (int k = 0; k < nz; ++k){
+        for (int j = 0; j < ny; ++j){
+            for (int i = 0; i < nx; ++i){
+                if (i+1 < nx) ts.addTrussElement(*n[id(i,j,k)], *n[id(i+1,j,k)], mat, 1.0);
+                if (j+1 < ny) ts.addTrussElement(*n[id(i,j,k)], *n[id(i,j+1,k)], mat, 1.5);
+                if (k+1 < nz) ts.addTrussElement(*n[id(i,j,k)], *n[id(i,j,k+1)], mat, 2.0);
+                if (i+1 < nx && j+1 < ny) ts.addTrussElement(*n[id(i,j,k)], *n[id(i+1,j+1,k)], mat, 0.5);
+                if (i+1 < nx && k+1 < nz) ts.addTrussElement(*n[id(i,j,k)], *n[id(i+1,j,k+1)], mat, 0.7);
+            }
+        }
+    }
+    ts.addBCs({1,2,3, 3*nx-2, 3*nx-1, 3*nx});
+
+    // every element exactly once, no shared node inside a color
+    std::vector<std::vector<size_t>> colors = ts.createElementColoring();
+    std::vector<int> seen(ts.getElements().size(), 0);
+    for (const auto& color : colors){
+        std::vector<int> nodeUsed(ts.getNodes().size(), 0);
+        for (size_t e : color){
+            seen[e]++;
+            EXPECT_EQ(nodeUsed[ts.getElements()[e]->getNode1().getID()-1]++, 0);
+            EXPECT_EQ(nodeUsed[ts.getElements()[e]->getNode2().getID()-1]++, 0);
+        }
+    }
+    for (int s : seen) EXPECT_EQ(s, 1);
+    EXPECT_LE(colors.size(), 2*10);
+
+    ScopedNumThreads threads(1);
+    SparseMatrix<double> K1 = ts.assembleSparseStffMtx();
+    Matrix<double> R1 = ts.assembleReducedStffMtx();
+    threads.set(4);
+    SparseMatrix<double> K4 = ts.assembleSparseStffMtx();
+    Matrix<double> R4 = ts.assembleReducedStffMtx();
+    Matrix<double> D4 = ts.assembleStffMtx();
+
+    EXPECT_EQ(K1.getValues(), K4.getValues());
+    size_t numFree = R1.getSize()[0];
+    for (size_t i = 0; i < numFree; ++i){
+        for (size_t j = 0; j < numFree; ++j){
+            ASSERT_EQ(R1(i,j), R4(i,j));
+        }
+    }
+    const SparseMatrix<double>& K = K4;
+    size_t numDOF = D4.getSize()[0];
+    for (size_t i = 0; i < numDOF; ++i){
+        for (size_t j = 0; j < numDOF; ++j){
+            ASSERT_NEAR(D4(i,j), K(i,j), 1e-9);
+        }
+    }
+
+    // the cached coloring survives renumbering and grows with new elements
+    ts.renumberNodes();
+    EXPECT_EQ(ts.createElementColoring(), colors);
+    ts.addTrussElement(*ts.getNodes()[0], *ts.getNodes()[1], mat, 1.0);
+    std::vector<std::vector<size_t>> grown = ts.createElementColoring();
+    size_t newElement = ts.getElements().size() - 1;
+    size_t found = 0;
+    for (const auto& color : grown){
+        std::vector<int> nodeUsed(ts.getNodes().size(), 0);
+        for (size_t e : color){
+            found += (e == newElement);
+            EXPECT_EQ(nodeUsed[ts.getElements()[e]->getNode1().getID()-1]++, 0);
+            EXPECT_EQ(nodeUsed[ts.getElements()[e]->getNode2().getID()-1]++, 0);
+        }
+    }
+    EXPECT_EQ(found, 1u);
+}
+
+TEST(TrussStructureTest, StructureOfArraysStorageFollowsNodesAndElements)
+{
+    TrussStructure ts;
+    Material& steel = ts.addMaterial("steel", 200.0);
+
+    Node& n1 = ts.addNode(0,0,0);
+    Node& n2 = ts.addNode(3,0,0);
+    Node& n3 = ts.addNode(0,4,0);
+    TrussElement& e1 = ts.addTrussElement(n1, n2, steel, 1.0);
+    TrussElement& e2 = ts.addTrussElement(n2, n3, steel, 2.0);
+
+    // materials added later keep the references held by elements valid
+    for (int i = 0; i < 100; ++i){
+        ts.addMaterial("mat" + std::to_string(i), 1.0 + i);
+    }
+    Material& alu = ts.addMaterial("aluminum", 70.0);
+    TrussElement& e3 = ts.addTrussElement(n3, n1, alu, 0.5);
+    EXPECT_EQ(&e1.getMaterial(), &ts.getMaterials()[0]);
+    EXPECT_DOUBLE_EQ(e2.getMaterial().getE(), 200.0);
+
+    const NodeArrays& xyz = ts.getNodeArrays();
+    const ElementArrays& el = ts.getElementArrays();
+    ASSERT_EQ(xyz.x.size(), 3);
+    EXPECT_DOUBLE_EQ(xyz.x[1], 3.0);
+    EXPECT_DOUBLE_EQ(xyz.y[2], 4.0);
+    EXPECT_EQ(el.node1, std::vector<size_t>({0,1,2}));
+    EXPECT_EQ(el.node2, std::vector<size_t>({1,2,0}));
+    EXPECT_EQ(el.material, std::vector<size_t>({0,0,101}));
+
+    // nodes and elements are views, changes go to the arrays
+    n2.moveNode(1.0, 0.0, 0.5);
+    EXPECT_DOUBLE_EQ(xyz.x[1], 4.0);
+    EXPECT_DOUBLE_EQ(xyz.z[1], 0.5);
+    EXPECT_DOUBLE_EQ(n2.getPosition()[0], 4.0);
+    e3.setArea(0.25);
+    EXPECT_DOUBLE_EQ(el.area[2], 0.25);
+    EXPECT_DOUBLE_EQ(e3.getArea(), 0.25);
+
+    std::array<double,3> c;
+    double L = ts.computeElementDirection(1, c);
+    EXPECT_DOUBLE_EQ(L, e2.computeLength());
+    EXPECT_DOUBLE_EQ(ts.computeAxialStiffness(2, 4.0), 70.0*0.25/4.0);
+    Matrix<double> Ke = e2.computeGlobalStiffnessMtx();
+    FixedMatrix<double,6,6> Kf = TrussElement::computeGlobalStiffnessFixedMtx(c, ts.computeAxialStiffness(1, L));
+    for (size_t i = 0; i < 6; ++i){
+        for (size_t j = 0; j < 6; ++j){
+            EXPECT_NEAR(Kf(i,j), Ke(i,j), 1e-12);
+        }
+    }
+
+    std::vector<double> u = {0,0,0, 0.1,0.2,0.3, -0.1,0.05,0};
+    std::vector<double> strains = ts.computeStrains(u);
+    std::vector<double> stresses = ts.computeStresses(u);
+    for (size_t e = 0; e < 3; ++e){
+        EXPECT_NEAR(strains[e], ts.getElements()[e]->computeElStrain(u), 1e-14);
+        EXPECT_NEAR(stresses[e], ts.getElements()[e]->computeElStress(u), 1e-12);
+    }
+
+    // foreign nodes and materials are rejected
+    TrussStructure other;
+    Node& foreign = other.addNode(0,0,0);
+    Material& foreignMat = other.addMaterial("steel", 200.0);
+    EXPECT_THROW(ts.addTrussElement(n1, foreign, steel, 1.0), std::invalid_argument);
+    EXPECT_THROW(ts.addTrussElement(n1, n2, foreignMat, 1.0), std::invalid_argument);
+    EXPECT_EQ(el.node1.size(), 3);
+
+    // renumbering permutes the coordinate arrays and the connectivity
+    std::vector<int> newID = ts.renumberNodes();
+    for (size_t i = 0; i < 3; ++i){
+        std::vector<double> pos = ts.getNodes()[i]->getPosition();
+        EXPECT_DOUBLE_EQ(pos[0], xyz.x[i]);
+        EXPECT_DOUBLE_EQ(pos[1], xyz.y[i]);
+    }
+    EXPECT_DOUBLE_EQ(xyz.x[newID[1]-1], 4.0);
+    for (size_t e = 0; e < 3; ++e){
+        EXPECT_EQ(el.node1[e], static_cast<size_t>(ts.getElements()[e]->getNode1().getID() - 1));
+        EXPECT_EQ(el.node2[e], static_cast<size_t>(ts.getElements()[e]->getNode2().getID() - 1));
+    }
+}
+
+TEST(TrussStructureTest, SpatialHashFindsDuplicateNodes) {
+    TrussStructure ts;
+    EXPECT_DOUBLE_EQ(ts.getNodeTolerance(), 1E-1);
+    ts.addNode(0.0, 0.0, 0.0);
+    ts.addNode(1.0, 0.0, 0.0);
+
+    // duplicates across cell borders are found
+    EXPECT_THROW(ts.addNode(-0.05, 0.05, -0.05), std::invalid_argument);
+    EXPECT_THROW(ts.addNode(0.95, 0.0, 0.09), std::invalid_argument);
+    EXPECT_NO_THROW(ts.addNode(0.0, 0.0, 0.1));
+
+    EXPECT_THROW(ts.setNodeTolerance(0.0), std::invalid_argument);
+    ts.setNodeTolerance(1E-3);
+    EXPECT_NO_THROW(ts.addNode(0.5, 0.0, 0.0));
+    EXPECT_THROW(ts.addNode(0.5, 0.0005, 0.0), std::invalid_argument);
+
+    // moved and renumbered nodes are tracked
+    ts.getNodes()[0]->moveNode(2.0, 0.0, 0.0);
+    EXPECT_NO_THROW(ts.addNode(0.0, 0.0, 0.0));
+    EXPECT_THROW(ts.addNode(2.0, 0.0, 0.0), std::invalid_argument);
+    ts.renumberNodes();
+    EXPECT_THROW(ts.addNode(2.0, 0.0, 0.0), std::invalid_argument);
+    EXPECT_THROW(ts.addNode(1.0, 0.0, 0.0), std::invalid_argument);
+    EXPECT_EQ(ts.getNodes().size(), 5);
+}
+
+TEST(TrussStructureTest, BulkAddNodesMergesDuplicatesInOrder) {
+    // points on a lattice, every one given twice with a small offset, plus some existing nodes
+    TrussStructure bulk;
+    bulk.addNode(0.0, 0.0, 0.0);
+    bulk.addNode(3.0, 2.0, 1.0);
+    std::vector<std::array<double,3>> points;
+    for (int i = 0; i < 20; ++i){
+        for (int j = 0; j < 15; ++j){
+            for (int k = 0; k < 10; ++k){
+                points.push_back({1.0*i, 1.0*j, 1.0*k});
+                points.push_back({1.0*i + 0.04, 1.0*j - 0.06, 1.0*k + 0.09});
+            }
+        }
+    }
+    // a chain of points closer than the tolerance to their neighbours only
+    points.push_back({50.0, 0.0, 0.0});
+    points.push_back({50.08, 0.0, 0.0});
+    points.push_back({50.16, 0.0, 0.0});
+
+    std::vector<int> ids = bulk.addNodes(points);
+    ASSERT_EQ(ids.size(), points.size());
+    EXPECT_EQ(bulk.getNodes().size(), 2 + 20*15*10 - 2 + 2);
+    EXPECT_EQ(ids[0], 1);
+    for (size_t p = 0; p + 3 < points.size(); p += 2){
+        EXPECT_EQ(ids[p], ids[p+1]);
+    }
+    size_t last = points.size() - 1;
+    EXPECT_EQ(ids[last-1], ids[last-2]);
+    EXPECT_NE(ids[last], ids[last-2]);
+
+    // same nodes as adding the points one by one and skipping duplicates
+    TrussStructure serial;
+    serial.addNode(0.0, 0.0, 0.0);
+    serial.addNode(3.0, 2.0, 1.0);
+    for (const auto& p : points){
+        try {
+            serial.addNode(p[0], p[1], p[2]);
+        }
+        catch (const std::invalid_argument&){}
+    }
+    ASSERT_EQ(serial.getNodes().size(), bulk.getNodes().size());
+    for (size_t i = 0; i < bulk.getNodes().size(); ++i){
+        EXPECT_EQ(bulk.getNodes()[i]->getCoordinates(), serial.getNodes()[i]->getCoordinates());
+    }
+    for (size_t p = 0; p < points.size(); ++p){
+        std::array<double,3> pos = bulk.getNodes()[ids[p]-1]->getCoordinates();
+        for (size_t d = 0; d < 3; ++d){
+            EXPECT_LT(std::abs(pos[d] - points[p][d]), bulk.getNodeTolerance());
+        }
+    }
+}
+
+TEST(TrussStructureTest, FusedElementRecoveryMatchesElementKernels)
+{
+    // braced lattice, enough elements for several recovery blocks
+    const int nx = 20, ny = 12, nz = 3;
+    TrussStructure ts;
+    std::vector<Node*> n;
+    for (int k = 0; k < nz; ++k){
+        for (int j = 0; j < ny; ++j){
+            for (int i = 0; i < nx; ++i){
+                n.push_back(&ts.addNode(i, j + 0.1*i, 1.5*k));
+            }
+        }
+    }
+    Material& steel = ts.addMaterial("steel", 210000.0, 235.0);
+    Material& wood = ts.addMaterial("wood", 11000.0);
+    EXPECT_DOUBLE_EQ(steel.getAllowableStress(), 235.0);
+    EXPECT_DOUBLE_EQ(wood.getAllowableStress(), 0.0);
+    EXPECT_THROW(ts.addMaterial("bad", 1.0, -1.0), std::invalid_argument);
+
+    auto id = [&](int i, int j, int k){ return static_cast<size_t>(i + nx*(j + ny*k)); };
+    std::vector<const Material*> mats;
+    auto add = [&](size_t a, size_t b, Material& m, double A){
+        ts.addTrussElement(*n[a], *n[b], m, A);
+        mats.push_back(&m);
+    };
+    for (int k = 0; k < nz; ++k){
+        for (int j = 0; j < ny; ++j){
+            for (int i = 0; i < nx; ++i){
+                if (i+1 < nx) add(id(i,j,k), id(i+1,j,k), steel, 1.0);
+                if (j+1 < ny) add(id(i,j,k), id(i,j+1,k), wood, 1.5);
+                if (k+1 < nz) add(id(i,j,k), id(i,j,k+1), steel, 2.0);
+                if (i+1 < nx && j+1 < ny) add(id(i,j,k), id(i+1,j+1,k), steel, 0.5);
+            }
+        }
+    }
+    size_t numEl = ts.getElements().size();
+    ASSERT_GT(numEl, 2048u);
+
+    std::vector<double> u(3*ts.getNodes().size());
+    for (size_t i = 0; i < u.size(); ++i) u[i] = 1e-3*std::sin(0.37*i);
+
+    ScopedNumThreads threads(1);
+    ElementResults r1 = ts.computeElementResults(u);
+    threads.set(4);
+    ElementResults r4 = ts.computeElementResults(u);
+
+    EXPECT_EQ(r1.strains, r4.strains);
+    EXPECT_EQ(r1.utilizations, r4.utilizations);
+    ASSERT_EQ(r1.axialForces.size(), numEl);
+
+    std::vector<double> strains = ts.computeStrains(u);
+    std::vector<double> stresses = ts.computeStresses(u);
+    for (size_t e = 0; e < numEl; ++e){
+        const TrussElement& el = *ts.getElements()[e];
+        double E = mats[e]->getE();
+        EXPECT_NEAR(r1.strains[e], el.computeElStrain(u), 1e-15);
+        EXPECT_NEAR(r1.stresses[e], el.computeElStress(u), 1e-10);
+        EXPECT_NEAR(r1.axialForces[e], el.getArea()*E*r1.strains[e], 1e-10);
+        EXPECT_DOUBLE_EQ(strains[e], r1.strains[e]);
+        EXPECT_DOUBLE_EQ(stresses[e], r1.stresses[e]);
+
+        double allowable = mats[e]->getAllowableStress();
+        EXPECT_DOUBLE_EQ(r1.utilizations[e], allowable > 0.0 ? std::abs(r1.stresses[e])/allowable : 0.0);
+    }
+
+    EXPECT_THROW(ts.computeElementResults(std::vector<double>(3)), std::invalid_argument);
+}